@@ -184,7 +184,7 @@ osal_status_t BSP_ADC_Get_Values(ADC_Device* dev)
     }
     
     // 获取互斥锁
-    if (tx_mutex_get(&dev->adc_mutex, TX_WAIT_FOREVER) != TX_SUCCESS) {
+    if (osal_mutex_lock(&dev->adc_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
         return OSAL_ERROR;
     }
     
@@ -212,7 +212,7 @@ osal_status_t BSP_ADC_Get_Values(ADC_Device* dev)
                 unsigned int actual_flags;
                 osal_status_t status = osal_event_wait(&dev->adc_event, ADC_EVENT_DONE,
                                                       OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                      TX_WAIT_FOREVER, &actual_flags);
+                                                      OSAL_WAIT_FOREVER, &actual_flags);
                 if (status == OSAL_SUCCESS && (actual_flags & ADC_EVENT_DONE)) {
                     // 对于IT模式，需要手动读取数据到非活动缓冲区
                     if (dev->mode == ADC_MODE_IT) {
@@ -232,12 +232,12 @@ osal_status_t BSP_ADC_Get_Values(ADC_Device* dev)
             break;
             
         default:
-            tx_mutex_put(&dev->adc_mutex);
+            osal_mutex_unlock(&dev->adc_mutex);
             return OSAL_INVALID_PARAM;
     }
     
     // 释放互斥锁
-    tx_mutex_put(&dev->adc_mutex);
+    osal_mutex_unlock(&dev->adc_mutex);
     
     return (hal_status == HAL_OK) ? OSAL_SUCCESS : OSAL_ERROR;
 }
@@ -15,6 +15,7 @@
 /* SPI 配置 */
 #define SPI_BUS_NUM 2                  // 总线数量
 #define MAX_DEVICES_PER_BUS 4          // 每条总线最大设备数
+#define SPI_PROFILE_ENABLE 0           // 统计BSP_SPI_TransReceive每次调用的CPU周期数，shell命令spi查看(测量时打开)
 
 /* PWM 配置 */
 #define MAX_PWM_DEVICES 10             // 最大PWM设备数
@@ -32,5 +33,31 @@
 /* CAN 配置 */
 #define CAN_BUS_NUM 2                  // 总线数量
 #define MAX_DEVICES_PER_CAN_BUS  8     // 每总线最大设备数
+#define CAN_RX_RING_SIZE 16            // 下半部模式下每个接收FIFO的软件缓冲帧数(2的幂)
+#define CAN_RX_LUT_ENABLE 1            // 接收分发按11位StdId直接查表找设备(每总线2KB)，0为逐个比较设备ID
+#define CAN_FILTER_DEFAULT_RATE_HZ 1000 // 设备未给出预计接收帧率时按此值均衡FIFO0/FIFO1负载
+#define CAN_PROFILE_ENABLE 0           // 统计接收中断和分发每帧的CPU周期数，shell命令can isr查看(测量时打开)
+#define CAN_TX_QUEUE_SIZE 16           // 每条总线每个优先级的软件发送队列帧数(2的幂)
+#define CAN_IRQ_PRIORITY 5             // 同一控制器的接收FIFO0/FIFO1、发送邮箱空、状态变化/错误中断统一使用此优先级，互不抢占
+#define CAN_TX_IRQ_HANDLER_ENABLE 1    // 由bsp_can.c提供CAN1_TX/CAN2_TX中断入口，CubeMX中打开了TX中断时改为0
+#define CAN_STAT_ENABLE 0              // 统计每个设备的收发帧数、总线负载、FIFO溢出、错误状态和发送队列等待时间，shell命令can stat查看(调试总线时打开)
+#define CAN_SCE_IRQ_HANDLER_ENABLE 1   // 由bsp_can.c提供CAN1_SCE/CAN2_SCE中断入口(CAN_STAT_ENABLE为1时)，CubeMX中打开了SCE中断时改为0
+#define CAN_BENCH_ENABLE 0             // shell命令can bench：两条总线同时连续发送，测试发送吞吐(会占满总线，仅台架测试时打开)
+#define CAN_BENCH_STD_ID 0x7F0         // 吞吐测试帧ID，不能与总线上设备使用的ID冲突
+#define CAN_BENCH_THREAD_PRIORITY 20   // 吞吐测试发送线程优先级(高于shell线程)
+#define CAN_BENCH_STACK_SIZE 1024      // 吞吐测试发送线程栈大小
+
+/* 中断下半部配置 */
+#define BSP_IRQ_DEFER_ENABLE 1         // CAN接收、GPIO外部中断的后续处理放到osal_defer工作线程中执行
+
+/* CTRLTICK 配置 */
+#define CTRLTICK_TIM TIM7                 // 控制节拍定时器(APB1基本定时器，CubeMX中未使用，由bsp_ctrltick.c配置)
+#define CTRLTICK_TIM_CLK_ENABLE() __HAL_RCC_TIM7_CLK_ENABLE()
+#define CTRLTICK_IRQn TIM7_IRQn           // 定时器更新中断
+#define CTRLTICK_IRQ_HANDLER_ENABLE 1     // 由bsp_ctrltick.c提供TIM7中断入口，CubeMX中打开了TIM7中断时改为0
+#define CTRLTICK_COUNT_HZ 1000000         // 定时器计数频率
+#define CTRLTICK_IRQ_PRIORITY 4           // 中断优先级
+#define CTRLTICK_BASE_HZ 4000             // 基础节拍频率，所有周期和相位都是其整数倍
+#define CTRLTICK_CLIENT_NUM 4             // 最大注册线程数
 
 #endif // _BSP_CONFIG_H_
\ No newline at end of file
@@ -9,67 +9,367 @@
 
 #include "bsp_can.h"
 #include "osal_def.h"
+#include "osal_defer.h"
+#include "osal_ringbuf.h"
+#include "shell.h"
 #include "tx_port.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-/* CAN 事件定义 */
-#define CAN_EVENT_TX_MAILBOX0_DONE (0x01 << 0)
-#define CAN_EVENT_TX_MAILBOX1_DONE (0x01 << 1)
-#define CAN_EVENT_TX_MAILBOX2_DONE (0x01 << 2)
-
-// 全局CAN事件
-static osal_event_t global_can_event;
+// 全局CAN事件，两条总线的设备接收事件和发送邮箱事件都从中分配标志
+static osal_wevent_t can_event;
 // CAN总线管理器数组
 static CANBusManager can_bus_managers[CAN_BUS_NUM];
-// 静态声明32个事件标志
-static uint32_t can_device_event_flags[32] = {
-    0x00000001, 0x00000002, 0x00000004, 0x00000008,
-    0x00000010, 0x00000020, 0x00000040, 0x00000080,
-    0x00000100, 0x00000200, 0x00000400, 0x00000800,
-    0x00001000, 0x00002000, 0x00004000, 0x00008000,
-    0x00010000, 0x00020000, 0x00040000, 0x00080000,
-    0x00100000, 0x00200000, 0x00400000, 0x00800000,
-    0x01000000, 0x02000000, 0x04000000, 0x08000000,
-    0x10000000, 0x20000000, 0x40000000, 0x80000000
+// CAN1/CAN2外设到总线管理器的映射，中断中按外设直接取总线，不再遍历管理器数组
+static CANBusManager *can_bus_map[CAN_BUS_NUM];
+#define CAN_STD_ID_MASK 0x7FFU
+#define CAN_EXT_ID_MASK 0x1FFFFFFFU
+#if CAN_RX_LUT_ENABLE
+// 每条总线按11位StdId索引的设备表，值为devices[]下标+1，0表示没有设备接收该ID
+static uint8_t can_rx_lut[CAN_BUS_NUM][CAN_STD_ID_MASK + 1];
+#endif
+#if BSP_IRQ_DEFER_ENABLE
+/* 下半部模式：中断中只把报文从硬件FIFO搬到软件缓冲区，查找设备、拷贝数据、设置事件在工作线程中完成 */
+typedef struct {
+    uint32_t id;
+    uint8_t ide;        // CAN_ID_STD/CAN_ID_EXT
+    uint8_t dlc;
+    uint8_t data[8];
+} CanRxFrame;
+
+// 每条总线每个接收FIFO一个缓冲区。HAL_CAN_IRQHandler不论从哪个中断入口进入都会处理所有已使能的中断源，
+// RX0中断中也可能取FIFO1，因此同一控制器的所有CAN中断设为同一优先级(CAN_IRQ_PRIORITY)互不抢占，保证单生产者
+typedef struct {
+    CANBusManager *bus;
+    osal_ringbuf_t ring;
+    volatile uint8_t pending;   // 已提交下半部尚未开始处理
+    CanRxFrame buf[CAN_RX_RING_SIZE];
+} CanRxFifo;
+
+static CanRxFifo can_rx_fifos[CAN_BUS_NUM][2];
+#endif
+
+#if (CAN_TX_QUEUE_SIZE & (CAN_TX_QUEUE_SIZE - 1)) != 0 || CAN_TX_QUEUE_SIZE > 0x8000
+#error "CAN_TX_QUEUE_SIZE must be a power of 2"
+#endif
+
+// 发送令牌各字段
+#define CAN_TX_TOKEN_BUS_SHIFT 31U
+#define CAN_TX_TOKEN_MB_SHIFT 29U
+#define CAN_TX_SEQ_MASK 0x1FFFFFFFU
+
+// 28个过滤器组，0-13给CAN1用，14-27给CAN2用(在STM32的BxCAN控制器中CAN2是CAN1的从机)
+#define CAN_FILTER_BANKS_PER_BUS 14U
+
+/* 过滤器规划中的一项：一个ID，或按掩码对齐的一段ID */
+typedef struct {
+    uint32_t id;        // 基准ID
+    uint32_t mask;      // 参与比较的ID位，等于ID全宽时为单个ID
+    uint32_t rate;      // 预计帧率
+    uint8_t ext;        // 1为29位扩展ID
+    uint8_t fifo;       // 分配的接收FIFO
+} CanFilterEntry;
+
+/* 过滤器组的四种用法 */
+enum {
+    CAN_FILTER_STD_LIST,    // 16位列表，每组4个标准ID
+    CAN_FILTER_STD_MASK,    // 16位掩码，每组2段标准ID
+    CAN_FILTER_EXT_LIST,    // 32位列表，每组2个扩展ID
+    CAN_FILTER_EXT_MASK,    // 32位掩码，每组1段扩展ID
+    CAN_FILTER_KIND_NUM
 };
-// CAN过滤器索引
-static uint8_t can1_filter_idx = 0, can2_filter_idx = 14; // 0-13给can1用,14-27给can2用
+static const uint8_t can_filter_per_bank[CAN_FILTER_KIND_NUM] = {4, 2, 2, 1};
+
+static void shell_can_cmd(int argc, char **argv);
+
+/**
+ * @description: 获取CAN外设对应的映射表下标，CAN1为0，CAN2为1
+ * @param {CAN_HandleTypeDef*} hcan
+ * @return {uint32_t}
+ */
+static inline uint32_t BSP_CAN_MapIndex(CAN_HandleTypeDef *hcan)
+{
+    return (hcan->Instance == CAN1) ? 0U : 1U;
+}
+
+/**
+ * @description: 获取CAN句柄对应的总线管理器
+ * @param {CAN_HandleTypeDef*} hcan
+ * @return {CANBusManager*}，NULL表示该总线未初始化
+ */
+static inline CANBusManager* BSP_CAN_GetBus(CAN_HandleTypeDef *hcan)
+{
+    uint32_t index = BSP_CAN_MapIndex(hcan);
+    if (index >= CAN_BUS_NUM) {
+        return NULL;
+    }
+    CANBusManager *bus_manager = can_bus_map[index];
+    return (bus_manager != NULL && bus_manager->hcan == hcan) ? bus_manager : NULL;
+}
+
+
+static inline uint32_t CANFilterFullMask(const CanFilterEntry *entry)
+{
+    return entry->ext ? CAN_EXT_ID_MASK : CAN_STD_ID_MASK;
+}
+
+static inline int CANFilterKind(const CanFilterEntry *entry)
+{
+    return (entry->ext ? CAN_FILTER_EXT_LIST : CAN_FILTER_STD_LIST) +
+           (entry->mask != CANFilterFullMask(entry) ? 1 : 0);
+}
+
+/**
+ * @description: 计算规划结果需要的过滤器组数，同一组内的项必须同一种用法、同一个FIFO
+ * @param {CanFilterEntry*} entries
+ * @param {int} count
+ * @return {uint32_t}
+ */
+static uint32_t CANFilterBanksNeeded(const CanFilterEntry *entries, int count)
+{
+    uint8_t items[2][CAN_FILTER_KIND_NUM] = {{0}};
+    uint32_t banks = 0;
 
+    for (int i = 0; i < count; i++) {
+        items[entries[i].fifo][CANFilterKind(&entries[i])]++;
+    }
+    for (int fifo = 0; fifo < 2; fifo++) {
+        for (int kind = 0; kind < CAN_FILTER_KIND_NUM; kind++) {
+            banks += (items[fifo][kind] + can_filter_per_bank[kind] - 1) / can_filter_per_bank[kind];
+        }
+    }
+    return banks;
+}
 
 /**
- * @description: 添加CAN过滤器
- * @param {Can_Device*} device
+ * @description: 把两项合并为一项，合并后的掩码只保留两项都参与比较且取值相同的位
+ * @param {CanFilterEntry*} entries
+ * @param {int*} count
+ * @param {int} a
+ * @param {int} b, 合并后删除
  * @return {*}
  */
-static void CANAddFilter(Can_Device *device)
+static void CANFilterMerge(CanFilterEntry *entries, int *count, int a, int b)
 {
-    CAN_FilterTypeDef can_filter_conf;
-    
-    can_filter_conf.FilterMode = CAN_FILTERMODE_IDLIST;                                                       // 使用id list模式,即只有将rxid添加到过滤器中才会接收到,其他报文会被过滤
-    can_filter_conf.FilterScale = CAN_FILTERSCALE_16BIT;                                                      // 使用16位id模式,即只有低16位有效
-    can_filter_conf.FilterFIFOAssignment = (device->tx_id & 1) ? CAN_RX_FIFO0 : CAN_RX_FIFO1;              // 奇数id的模块会被分配到FIFO0,偶数id的模块会被分配到FIFO1
-    can_filter_conf.SlaveStartFilterBank = 14;                                                                // 从第14个过滤器开始配置从机过滤器(在STM32的BxCAN控制器中CAN2是CAN1的从机)
-    can_filter_conf.FilterIdLow = device->rx_id << 5;                                                      // 过滤器寄存器的低16位,因为使用STDID,所以只有低11位有效,高5位要填0
-    can_filter_conf.FilterBank = device->can_handle == &hcan1 ? (can1_filter_idx++) : (can2_filter_idx++); // 根据can_handle判断是CAN1还是CAN2,然后自增
-    can_filter_conf.FilterActivation = CAN_FILTER_ENABLE;                                                     // 启用过滤器
+    entries[a].mask &= entries[b].mask & ~(entries[a].id ^ entries[b].id);
+    entries[a].id &= entries[a].mask;
+    entries[a].rate += entries[b].rate;
+    entries[b] = entries[--(*count)];
+}
+
+/**
+ * @description: 写入一个过滤器组，空位重复最后一项，不会多收其他ID
+ * @param {CAN_HandleTypeDef*} hcan
+ * @param {uint32_t} bank
+ * @param {int} kind
+ * @param {uint8_t} fifo
+ * @param {CanFilterEntry**} items
+ * @param {int} count, 1到can_filter_per_bank[kind]
+ * @return {osal_status_t}
+ */
+static osal_status_t CANFilterWriteBank(CAN_HandleTypeDef *hcan, uint32_t bank, int kind, uint8_t fifo,
+                                        const CanFilterEntry **items, int count)
+{
+    CAN_FilterTypeDef conf;
+    uint32_t reg[4];
 
-    HAL_CAN_ConfigFilter(device->can_handle, &can_filter_conf);
+    memset(&conf, 0, sizeof(conf));
+    switch (kind) {
+    case CAN_FILTER_STD_LIST:
+        // 16位: STID[10:0] RTR IDE EXID[17:15]，RTR和IDE为0只接收标准数据帧
+        for (int i = 0; i < 4; i++) {
+            reg[i] = items[i < count ? i : count - 1]->id << 5;
+        }
+        conf.FilterIdLow = reg[0];
+        conf.FilterMaskIdLow = reg[1];
+        conf.FilterIdHigh = reg[2];
+        conf.FilterMaskIdHigh = reg[3];
+        break;
+    case CAN_FILTER_STD_MASK:
+        for (int i = 0; i < 2; i++) {
+            const CanFilterEntry *item = items[i < count ? i : count - 1];
+            reg[i * 2] = item->id << 5;
+            reg[i * 2 + 1] = (item->mask << 5) | 0x18U;     // RTR和IDE也参与比较
+        }
+        conf.FilterIdLow = reg[0];
+        conf.FilterMaskIdLow = reg[1];
+        conf.FilterIdHigh = reg[2];
+        conf.FilterMaskIdHigh = reg[3];
+        break;
+    case CAN_FILTER_EXT_LIST:
+        // 32位: STID[10:0] EXID[17:0] IDE RTR 0，29位扩展ID左移3位
+        reg[0] = (items[0]->id << 3) | CAN_ID_EXT;
+        reg[1] = (items[count - 1]->id << 3) | CAN_ID_EXT;
+        conf.FilterIdHigh = reg[0] >> 16;
+        conf.FilterIdLow = reg[0] & 0xFFFFU;
+        conf.FilterMaskIdHigh = reg[1] >> 16;
+        conf.FilterMaskIdLow = reg[1] & 0xFFFFU;
+        break;
+    default:
+        reg[0] = (items[0]->id << 3) | CAN_ID_EXT;
+        reg[1] = (items[0]->mask << 3) | CAN_ID_EXT | CAN_RTR_REMOTE;
+        conf.FilterIdHigh = reg[0] >> 16;
+        conf.FilterIdLow = reg[0] & 0xFFFFU;
+        conf.FilterMaskIdHigh = reg[1] >> 16;
+        conf.FilterMaskIdLow = reg[1] & 0xFFFFU;
+        break;
+    }
+    conf.FilterMode = (kind == CAN_FILTER_STD_LIST || kind == CAN_FILTER_EXT_LIST) ? CAN_FILTERMODE_IDLIST : CAN_FILTERMODE_IDMASK;
+    conf.FilterScale = (kind >= CAN_FILTER_EXT_LIST) ? CAN_FILTERSCALE_32BIT : CAN_FILTERSCALE_16BIT;
+    conf.FilterFIFOAssignment = fifo ? CAN_FILTER_FIFO1 : CAN_FILTER_FIFO0;
+    conf.FilterBank = bank;
+    conf.SlaveStartFilterBank = CAN_FILTER_BANKS_PER_BUS;
+    conf.FilterActivation = CAN_FILTER_ENABLE;
+    return (HAL_CAN_ConfigFilter(hcan, &conf) == HAL_OK) ? OSAL_SUCCESS : OSAL_ERROR;
+}
+
+/**
+ * @description: 按总线上前count个设备重新规划并写入全部过滤器组，回写各设备的接收FIFO
+ * @param {CANBusManager*} bus_manager
+ * @param {uint8_t} count
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_NO_MEMORY - 过滤器组不够, OSAL_ERROR - 写入失败
+ */
+static osal_status_t CANFilterPlan(CANBusManager *bus_manager, uint8_t count)
+{
+    CanFilterEntry entries[MAX_DEVICES_PER_CAN_BUS];
+    int n = 0;
+    uint32_t load[2] = {0, 0};
+
+    for (int i = 0; i < count; i++) {
+        Can_Device *device = &bus_manager->devices[i];
+        CanFilterEntry *entry = &entries[n++];
+        entry->ext = (device->id_type == CAN_ID_EXT);
+        entry->mask = CANFilterFullMask(entry);
+        entry->id = device->rx_id & entry->mask;
+        entry->rate = device->rx_rate_hz;
+        entry->fifo = 0;
+    }
+
+    // 1. 对齐且ID齐全的一段合并成一项掩码(伙伴合并)：两项掩码相同，且只在掩码最低的有效位上不同
+    for (int merged = 1; merged;) {
+        merged = 0;
+        for (int a = 0; a < n && !merged; a++) {
+            for (int b = a + 1; b < n; b++) {
+                uint32_t bit = entries[a].mask & (~entries[a].mask + 1U);
+                if (entries[a].ext == entries[b].ext && entries[a].mask == entries[b].mask &&
+                    (entries[a].id ^ entries[b].id) == bit) {
+                    CANFilterMerge(entries, &n, a, b);
+                    merged = 1;
+                    break;
+                }
+            }
+        }
+    }
+    // 两个ID的一段用掩码和用列表占用相同，拆回列表
+    for (int i = 0, last = n; i < last; i++) {
+        CanFilterEntry *entry = &entries[i];
+        if (entry->mask == (CANFilterFullMask(entry) & ~1U)) {
+            entry->mask |= 1U;
+            entry->rate /= 2;
+            entries[n] = *entry;
+            entries[n++].id |= 1U;
+        }
+    }
+
+    // 2. 按帧率从高到低依次放到负载较轻的FIFO
+    for (int i = 1; i < n; i++) {
+        CanFilterEntry key = entries[i];
+        int j = i - 1;
+        while (j >= 0 && entries[j].rate < key.rate) {
+            entries[j + 1] = entries[j];
+            j--;
+        }
+        entries[j + 1] = key;
+    }
+    for (int i = 0; i < n; i++) {
+        entries[i].fifo = (load[0] <= load[1]) ? 0 : 1;
+        load[entries[i].fifo] += entries[i].rate;
+    }
+
+    // 3. 过滤器组不够时，把同一FIFO中最接近的两项合并成更宽的掩码，多收的ID由软件分发丢弃
+    while (CANFilterBanksNeeded(entries, n) > CAN_FILTER_BANKS_PER_BUS) {
+        int best_a = -1, best_b = -1, best_bits = -1;
+        for (int a = 0; a < n; a++) {
+            for (int b = a + 1; b < n; b++) {
+                if (entries[a].ext != entries[b].ext || entries[a].fifo != entries[b].fifo) {
+                    continue;
+                }
+                int bits = __builtin_popcount(entries[a].mask & entries[b].mask & ~(entries[a].id ^ entries[b].id));
+                if (bits > best_bits) {
+                    best_bits = bits;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        if (best_a < 0) {
+            return OSAL_NO_MEMORY;
+        }
+        CANFilterMerge(entries, &n, best_a, best_b);
+    }
+
+    // 4. 按FIFO和用法分组写入过滤器组，停用上次规划多出来的组
+    uint32_t first = BSP_CAN_MapIndex(bus_manager->hcan) * CAN_FILTER_BANKS_PER_BUS;
+    uint32_t bank = first;
+    for (uint8_t fifo = 0; fifo < 2; fifo++) {
+        for (int kind = 0; kind < CAN_FILTER_KIND_NUM; kind++) {
+            const CanFilterEntry *items[4];
+            int filled = 0;
+            for (int i = 0; i < n; i++) {
+                if (entries[i].fifo != fifo || CANFilterKind(&entries[i]) != kind) {
+                    continue;
+                }
+                items[filled++] = &entries[i];
+                if (filled == can_filter_per_bank[kind]) {
+                    if (CANFilterWriteBank(bus_manager->hcan, bank++, kind, fifo, items, filled) != OSAL_SUCCESS) {
+                        return OSAL_ERROR;
+                    }
+                    filled = 0;
+                }
+            }
+            if (filled > 0 && CANFilterWriteBank(bus_manager->hcan, bank++, kind, fifo, items, filled) != OSAL_SUCCESS) {
+                return OSAL_ERROR;
+            }
+        }
+    }
+    for (uint32_t unused = bank; unused < first + bus_manager->filter_banks; unused++) {
+        CAN_FilterTypeDef conf;
+        memset(&conf, 0, sizeof(conf));
+        conf.FilterBank = unused;
+        conf.SlaveStartFilterBank = CAN_FILTER_BANKS_PER_BUS;
+        conf.FilterActivation = CAN_FILTER_DISABLE;
+        HAL_CAN_ConfigFilter(bus_manager->hcan, &conf);
+    }
+    bus_manager->filter_banks = (uint8_t)(bank - first);
+
+    // 5. 回写各设备所在的FIFO
+    for (int i = 0; i < count; i++) {
+        Can_Device *device = &bus_manager->devices[i];
+        uint8_t ext = (device->id_type == CAN_ID_EXT);
+        for (int j = 0; j < n; j++) {
+            if (entries[j].ext == ext && (device->rx_id & entries[j].mask) == entries[j].id) {
+                device->rx_fifo = entries[j].fifo;
+                break;
+            }
+        }
+    }
+    return OSAL_SUCCESS;
 }
 
 /**
  * @description: 检查设备ID冲突
  * @param {CANBusManager*} bus
- * @param {uint16_t} tx_id
- * @param {uint16_t} rx_id
+ * @param {uint32_t} rx_id
+ * @param {uint32_t} id_type, CAN_ID_STD/CAN_ID_EXT
  * @return {bool} true表示有冲突，false表示无冲突
  */
-static bool check_device_id_conflict(CANBusManager *bus, uint16_t tx_id, uint16_t rx_id) {
+static bool check_device_id_conflict(CANBusManager *bus, uint32_t rx_id, uint32_t id_type) {
     for(uint8_t i = 0; i < MAX_DEVICES_PER_CAN_BUS; i++) {
         if(bus->devices[i].can_handle != NULL) {  // 使用can_handle判断设备是否存在
-            if(bus->devices[i].rx_id == rx_id) {
+            if(bus->devices[i].rx_id == rx_id && bus->devices[i].id_type == id_type) {
                 return true;
             }
         }
@@ -77,6 +377,24 @@ static bool check_device_id_conflict(CANBusManager *bus, uint16_t tx_id, uint16_
     return false;
 }
 
+// shell用法字符串，只列出已编译的子命令
+#if CAN_PROFILE_ENABLE
+#define CAN_SHELL_USAGE_ISR "|isr"
+#else
+#define CAN_SHELL_USAGE_ISR ""
+#endif
+#if CAN_STAT_ENABLE
+#define CAN_SHELL_USAGE_STAT " | can stat [ms|reset]"
+#else
+#define CAN_SHELL_USAGE_STAT ""
+#endif
+#if CAN_BENCH_ENABLE
+#define CAN_SHELL_USAGE_BENCH " | can bench [ms]"
+#else
+#define CAN_SHELL_USAGE_BENCH ""
+#endif
+#define CAN_SHELL_USAGE "can <tx" CAN_SHELL_USAGE_ISR "> [reset]" CAN_SHELL_USAGE_STAT " | can filter" CAN_SHELL_USAGE_BENCH
+
 /**
  * @description: 初始化全局CAN事件和事件标志
  * @return {*}
@@ -87,7 +405,8 @@ static void BSP_CAN_Init_Global(void)
     
     if (!initialized) {
         // 创建全局CAN事件
-        osal_event_create(&global_can_event, "GlobalCANEvent");
+        osal_wevent_create(&can_event, "GlobalCANEvent");
+        shell_register_function("can", shell_can_cmd, "Show CAN statistics, usage: " CAN_SHELL_USAGE);
         
         initialized = 1;
     }
@@ -101,10 +420,12 @@ static void BSP_CAN_Init_Global(void)
 static CANBusManager* BSP_CAN_InitBusManager(CAN_HandleTypeDef *hcan)
 {
     // 查找现有的总线管理器
-    for (int i = 0; i < CAN_BUS_NUM; i++) {
-        if (can_bus_managers[i].hcan == hcan) {
-            return &can_bus_managers[i];
-        }
+    CANBusManager *bus_manager = BSP_CAN_GetBus(hcan);
+    if (bus_manager != NULL) {
+        return bus_manager;
+    }
+    if (BSP_CAN_MapIndex(hcan) >= CAN_BUS_NUM) {
+        return NULL;
     }
     
     // 查找空闲的总线管理器
@@ -113,10 +434,45 @@ static CANBusManager* BSP_CAN_InitBusManager(CAN_HandleTypeDef *hcan)
             can_bus_managers[i].hcan = hcan;
             can_bus_managers[i].device_count = 0;
             
-            // 创建总线互斥锁
-            char mutex_name[16];
-            snprintf(mutex_name, sizeof(mutex_name), "CAN_Mutex_%d", i);
-            osal_mutex_create(&can_bus_managers[i].bus_mutex, mutex_name);
+            // 每条总线单独的发送完成通知，两条总线的发送完成互不干扰
+            static char notify_name[CAN_BUS_NUM][16];   // 内核对象只保存名称指针
+            snprintf(notify_name[i], sizeof(notify_name[i]), "CAN_TxDone_%d", i);
+            osal_mailbox_create(&can_bus_managers[i].tx_notify, notify_name[i],
+                                &can_bus_managers[i].tx_notify_buf[0], &can_bus_managers[i].tx_notify_buf[1],
+                                sizeof(CanTxDoneState));
+#if BSP_IRQ_DEFER_ENABLE
+            for (int fifo = 0; fifo < 2; fifo++) {
+                CanRxFifo *rx_fifo = &can_rx_fifos[i][fifo];
+                rx_fifo->bus = &can_bus_managers[i];
+                rx_fifo->pending = 0;
+                osal_ringbuf_create(&rx_fifo->ring, "CAN_RxRing", sizeof(CanRxFrame),
+                                    CAN_RX_RING_SIZE, rx_fifo->buf, OSAL_RINGBUF_FLAG_NONE);
+            }
+#endif
+            can_bus_map[BSP_CAN_MapIndex(hcan)] = &can_bus_managers[i];
+            // 接收缓冲区和统计只允许单生产者，RX0/RX1中断统一为CAN_IRQ_PRIORITY，互不抢占
+            IRQn_Type rx0_irq = (BSP_CAN_MapIndex(hcan) == 0) ? CAN1_RX0_IRQn : CAN2_RX0_IRQn;
+            IRQn_Type rx1_irq = (BSP_CAN_MapIndex(hcan) == 0) ? CAN1_RX1_IRQn : CAN2_RX1_IRQn;
+            HAL_NVIC_SetPriority(rx0_irq, CAN_IRQ_PRIORITY, 0);
+            HAL_NVIC_SetPriority(rx1_irq, CAN_IRQ_PRIORITY, 0);
+            // 发送邮箱空中断：从发送队列补充邮箱、通知中断模式发送者
+            HAL_CAN_ActivateNotification(hcan, CAN_IT_TX_MAILBOX_EMPTY);
+#if CAN_TX_IRQ_HANDLER_ENABLE
+            IRQn_Type tx_irq = (BSP_CAN_MapIndex(hcan) == 0) ? CAN1_TX_IRQn : CAN2_TX_IRQn;
+            HAL_NVIC_SetPriority(tx_irq, CAN_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(tx_irq);
+#endif
+#if CAN_STAT_ENABLE
+            // FIFO溢出在接收中断中报告，错误警告/被动/离线在状态变化/错误中断中报告
+            HAL_CAN_ActivateNotification(hcan, CAN_IT_RX_FIFO0_OVERRUN | CAN_IT_RX_FIFO1_OVERRUN |
+                                               CAN_IT_ERROR_WARNING | CAN_IT_ERROR_PASSIVE |
+                                               CAN_IT_BUSOFF | CAN_IT_ERROR);
+#if CAN_SCE_IRQ_HANDLER_ENABLE
+            IRQn_Type sce_irq = (BSP_CAN_MapIndex(hcan) == 0) ? CAN1_SCE_IRQn : CAN2_SCE_IRQn;
+            HAL_NVIC_SetPriority(sce_irq, CAN_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(sce_irq);
+#endif
+#endif
             
             return &can_bus_managers[i];
         }
@@ -146,7 +502,8 @@ Can_Device* BSP_CAN_Device_Init(Can_Device_Init_Config_s *config)
     }
     
     // 检查ID冲突
-    if (check_device_id_conflict(bus_manager, config->tx_id, config->rx_id)) {
+    uint32_t id_type = (config->id_type == CAN_ID_EXT) ? CAN_ID_EXT : CAN_ID_STD;
+    if (check_device_id_conflict(bus_manager, config->rx_id, id_type)) {
         return NULL;
     }
     
@@ -160,25 +517,36 @@ Can_Device* BSP_CAN_Device_Init(Can_Device_Init_Config_s *config)
     device->rx_id = config->rx_id;
     device->tx_mode = config->tx_mode;
     device->rx_mode = config->rx_mode;
+    device->tx_prio = config->tx_prio;
+    device->id_type = id_type;
+    device->rx_rate_hz = config->rx_rate_hz ? config->rx_rate_hz : CAN_FILTER_DEFAULT_RATE_HZ;
     
     // 配置发送参数
-    device->txconf.StdId = config->tx_id;
-    device->txconf.ExtId = 0;
-    device->txconf.IDE = CAN_ID_STD;
+    device->txconf.StdId = (id_type == CAN_ID_STD) ? config->tx_id : 0;
+    device->txconf.ExtId = (id_type == CAN_ID_EXT) ? config->tx_id : 0;
+    device->txconf.IDE = id_type;
     device->txconf.RTR = CAN_RTR_DATA;
     device->txconf.DLC = 8;
     device->txconf.TransmitGlobalTime = DISABLE;
     
     // 分配事件标志
-    int flag_index = bus_manager->device_count + (bus_manager - can_bus_managers) * MAX_DEVICES_PER_CAN_BUS;
-    if (flag_index < 32) {
-        device->eventflag = can_device_event_flags[flag_index];
-    } else {
-        return NULL; // 超出可用事件标志范围
+    if (osal_wevent_flag_alloc(&can_event, &device->event_index) != OSAL_SUCCESS) {
+        return NULL; // 事件标志已用完，增大OSAL_WEVENT_WORDS
+    }
+    
+    // 连同新设备重新规划本总线的过滤器
+    if (CANFilterPlan(bus_manager, bus_manager->device_count + 1) != OSAL_SUCCESS) {
+        osal_wevent_flag_free(&can_event, device->event_index);
+        memset(device, 0, sizeof(Can_Device));
+        return NULL; // 过滤器组不够或控制器状态错误
     }
     
-    // 添加CAN过滤器
-    CANAddFilter(device);
+#if CAN_RX_LUT_ENABLE
+    // 登记到接收查找表，之后再置位设备计数，中断中查到的设备一定已经初始化完成；扩展ID逐个比较
+    if (id_type == CAN_ID_STD) {
+        can_rx_lut[bus_manager - can_bus_managers][config->rx_id & CAN_STD_ID_MASK] = bus_manager->device_count + 1;
+    }
+#endif
     
     // 增加设备计数
     bus_manager->device_count++;
@@ -191,82 +559,282 @@ Can_Device* BSP_CAN_Device_Init(Can_Device_Init_Config_s *config)
     return device;
 }
 
-osal_status_t BSP_CAN_SendDevice(Can_Device *device)
+/**
+ * @description: 判断邮箱的完成序号是否已经到达提交序号，序号29位回绕
+ * @param {uint32_t} done_seq
+ * @param {uint32_t} seq
+ * @return {bool}
+ */
+static inline bool BSP_CAN_TxSeqReached(uint32_t done_seq, uint32_t seq)
 {
-    if (device == NULL) {
-        return OSAL_INVALID_PARAM;
+    return ((done_seq - seq) & CAN_TX_SEQ_MASK) <= (CAN_TX_SEQ_MASK >> 1);
+}
+
+#if CAN_STAT_ENABLE
+/**
+ * @description: 累加一帧在总线上占用的位数：不含填充位时标准帧47+8n位、扩展帧67+8n位(含3位帧间隔)，
+ *               SOF到CRC之间标准帧34+8n位、扩展帧54+8n位可能被填充，每4位最多插入一个填充位，按此上界估算
+ * @param {uint64_t*} bits, 不含填充位的位数
+ * @param {uint64_t*} stuff, 填充位上界
+ * @param {uint32_t} ide, CAN_ID_STD/CAN_ID_EXT
+ * @param {uint32_t} rtr, CAN_RTR_DATA/CAN_RTR_REMOTE
+ * @param {uint32_t} dlc
+ * @return {*}
+ */
+static inline void BSP_CAN_StatFrame(uint64_t *bits, uint64_t *stuff, uint32_t ide, uint32_t rtr, uint32_t dlc)
+{
+    uint32_t data_bits = (rtr != CAN_RTR_DATA) ? 0 : ((dlc > 8U) ? 8U : dlc) * 8U;
+
+    if (ide == CAN_ID_EXT) {
+        *bits += 67U + data_bits;
+        *stuff += (54U + data_bits - 1U) / 4U;
+    } else {
+        *bits += 47U + data_bits;
+        *stuff += (34U + data_bits - 1U) / 4U;
     }
-    
-    HAL_StatusTypeDef status;
-    
-    // 获取互斥锁保护
-    CANBusManager *bus_manager = NULL;
-    for (int i = 0; i < CAN_BUS_NUM; i++) {
-        if (can_bus_managers[i].hcan == device->can_handle) {
-            bus_manager = &can_bus_managers[i];
-            break;
+}
+#endif
+
+/**
+ * @description: 结算邮箱中已完成或被中止的一帧：队列帧记录统计，发布本总线的发送完成状态；调用者需在临界区中
+ *               完成序号已等于提交序号时说明已结算过，直接返回，发送完成中断和BSP_CAN_AddTx都可能调用
+ * @param {CANBusManager*} bus_manager
+ * @param {uint8_t} mailbox, 0-2
+ * @param {uint8_t} ok, 1表示发送成功，0表示被中止
+ * @return {*}
+ */
+static void BSP_CAN_TxSettle(CANBusManager *bus_manager, uint8_t mailbox, uint8_t ok)
+{
+    uint8_t bit = (uint8_t)(1U << mailbox);
+
+    if (bus_manager->tx_done.done_seq[mailbox] == bus_manager->tx_seq[mailbox]) {
+        return;
+    }
+    if (bus_manager->tx_queued_mask & bit) {
+        CanTxLane *lane = &bus_manager->tx_lanes[bus_manager->tx_lane_of[mailbox]];
+        bus_manager->tx_queued_mask &= (uint8_t)~bit;
+        if (ok) {
+            uint32_t latency = osal_cycle_get() - bus_manager->tx_stamp[mailbox];
+            lane->sent++;
+            lane->latency_total += latency;
+            if (latency > lane->latency_max) {
+                lane->latency_max = latency;
+            }
+        } else {
+            lane->failed++;
         }
     }
-    
-    if (bus_manager != NULL) {
-        if (osal_mutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
-            return OSAL_ERROR;
+#if CAN_STAT_ENABLE
+    if (ok) {
+        // 邮箱被重新写入之前寄存器仍保留这一帧的ID类型和长度
+        CAN_TxMailBox_TypeDef *box = &bus_manager->hcan->Instance->sTxMailBox[mailbox];
+        bus_manager->stat_tx_frames++;
+        BSP_CAN_StatFrame(&bus_manager->stat_tx_bits, &bus_manager->stat_tx_stuff,
+                          box->TIR & CAN_TI0R_IDE, box->TIR & CAN_TI0R_RTR, box->TDTR & CAN_TDT0R_DLC);
+    }
+#endif
+    // 邮箱中只有一帧，完成的就是该邮箱最近提交的序号；等待令牌和等待空闲邮箱的线程被唤醒后各自检查
+    bus_manager->tx_done.done_seq[mailbox] = bus_manager->tx_seq[mailbox];
+    if (ok) {
+        bus_manager->tx_done.abort_mask &= (uint8_t)~bit;
+    } else {
+        bus_manager->tx_done.abort_mask |= bit;
+    }
+    osal_mailbox_post(&bus_manager->tx_notify, &bus_manager->tx_done);
+}
+
+/**
+ * @description: 写入一个空闲发送邮箱并分配发送令牌；调用者需在临界区中
+ * @param {CANBusManager*} bus_manager
+ * @param {CAN_TxHeaderTypeDef*} header
+ * @param {uint8_t*} data
+ * @param {uint32_t*} tx_mailbox, 输出使用的邮箱
+ * @param {CanTxToken*} token, 输出发送令牌，可为NULL
+ * @return {osal_status_t} OSAL_SUCCESS - 已写入, OSAL_NO_MEMORY - 邮箱全满, OSAL_ERROR - 控制器未启动等
+ */
+static osal_status_t BSP_CAN_AddTx(CANBusManager *bus_manager, CAN_TxHeaderTypeDef *header, uint8_t *data,
+                                   uint32_t *tx_mailbox, CanTxToken *token)
+{
+    if (HAL_CAN_GetTxMailboxesFreeLevel(bus_manager->hcan) == 0) {
+        return OSAL_NO_MEMORY;
+    }
+    // HAL写入TSR.CODE指向的空邮箱。该邮箱的完成中断可能还没处理，写入后TXRQ会清除RQCP，旧帧的完成就不会再上报，
+    // 先在这里结算旧帧并清除RQCP，统计和令牌不会记到新帧上
+    uint32_t tsr = bus_manager->hcan->Instance->TSR;
+    uint8_t next = (uint8_t)((tsr & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos);
+    if (next < 3 && (tsr & (CAN_TSR_RQCP0 << (next * 8U)))) {
+        bus_manager->hcan->Instance->TSR = CAN_TSR_RQCP0 << (next * 8U);
+        BSP_CAN_TxSettle(bus_manager, next, (tsr & (CAN_TSR_TXOK0 << (next * 8U))) != 0);
+    }
+    if (HAL_CAN_AddTxMessage(bus_manager->hcan, header, data, tx_mailbox) != HAL_OK) {
+        return OSAL_ERROR;
+    }
+    // CAN_TX_MAILBOX0/1/2分别为bit0/1/2
+    uint32_t mb = (uint32_t)__builtin_ctz(*tx_mailbox);
+    uint32_t seq = (bus_manager->tx_seq[mb] + 1U) & CAN_TX_SEQ_MASK;
+    if (seq == 0) {
+        seq = 1;    // 令牌不为0
+    }
+    bus_manager->tx_seq[mb] = seq;
+    if (token != NULL) {
+        *token = (BSP_CAN_MapIndex(bus_manager->hcan) << CAN_TX_TOKEN_BUS_SHIFT) |
+                 (mb << CAN_TX_TOKEN_MB_SHIFT) | seq;
+    }
+    return OSAL_SUCCESS;
+}
+
+/**
+ * @description: 计算剩余等待时间
+ * @param {osal_tick_t} start
+ * @param {osal_tick_t} timeout
+ * @return {osal_tick_t}
+ */
+static osal_tick_t BSP_CAN_Remaining(osal_tick_t start, osal_tick_t timeout)
+{
+    if (timeout == OSAL_WAIT_FOREVER) {
+        return OSAL_WAIT_FOREVER;
+    }
+    osal_tick_t elapsed = osal_tick_get() - start;
+    return (elapsed < timeout) ? timeout - elapsed : OSAL_NO_WAIT;
+}
+
+/**
+ * @description: 从软件发送队列向空闲邮箱补充报文，先发完高优先级队列；调用者需在临界区中
+ * @param {CANBusManager*} bus_manager
+ * @return {*}
+ */
+static void BSP_CAN_TxRefill(CANBusManager *bus_manager)
+{
+    for (int prio = 0; prio < CAN_TX_PRIO_NUM; prio++) {
+        CanTxLane *lane = &bus_manager->tx_lanes[prio];
+        while (lane->head != lane->tail && HAL_CAN_GetTxMailboxesFreeLevel(bus_manager->hcan) > 0) {
+            CanTxFrame *frame = &lane->frames[lane->tail & (CAN_TX_QUEUE_SIZE - 1)];
+            uint32_t mailbox;
+            if (BSP_CAN_AddTx(bus_manager, &frame->header, frame->data, &mailbox, NULL) != OSAL_SUCCESS) {
+                return; // 控制器未启动等，留在队列中等下次入队或发送完成时重试
+            }
+            uint8_t mb = (uint8_t)__builtin_ctz(mailbox);
+#if CAN_STAT_ENABLE
+            uint32_t wait = osal_cycle_get() - frame->stamp;
+            lane->wait_count++;
+            lane->wait_total += wait;
+            if (wait > lane->wait_max) {
+                lane->wait_max = wait;
+            }
+#endif
+            bus_manager->tx_queued_mask |= (uint8_t)mailbox;
+            bus_manager->tx_lane_of[mb] = (uint8_t)prio;
+            bus_manager->tx_stamp[mb] = frame->stamp;
+            lane->tail++;
+        }
+        if (lane->head != lane->tail) {
+            return; // 邮箱已满，低优先级不能越过还在排队的高优先级帧
         }
     }
-    
-    // 发送数据
-    status = HAL_CAN_AddTxMessage(device->can_handle, &device->txconf, 
-                                 device->tx_buff, &device->tx_mailbox);
-    
-    // 释放互斥锁
-    if (bus_manager != NULL) {
-        osal_mutex_unlock(&bus_manager->bus_mutex);
+}
+
+/**
+ * @description: 放入软件发送队列并尝试立即发出
+ * @param {CANBusManager*} bus_manager
+ * @param {CAN_TxHeaderTypeDef*} header
+ * @param {uint8_t*} data
+ * @param {CAN_TxPriority} prio
+ * @return {osal_status_t} OSAL_SUCCESS - 已入队, OSAL_NO_MEMORY - 队列满
+ */
+static osal_status_t BSP_CAN_TxEnqueue(CANBusManager *bus_manager, const CAN_TxHeaderTypeDef *header,
+                                       const uint8_t *data, CAN_TxPriority prio)
+{
+    CanTxLane *lane = &bus_manager->tx_lanes[prio < CAN_TX_PRIO_NUM ? prio : CAN_TX_PRIO_LOW];
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    uint16_t depth = (uint16_t)(lane->head - lane->tail);
+    if (depth >= CAN_TX_QUEUE_SIZE) {
+        lane->dropped++;
+        osal_exit_critical(&crit);
+        return OSAL_NO_MEMORY;
     }
-    
-    if (status != HAL_OK) {
+    CanTxFrame *frame = &lane->frames[lane->head & (CAN_TX_QUEUE_SIZE - 1)];
+    frame->header = *header;
+    memcpy(frame->data, data, sizeof(frame->data));
+    frame->stamp = osal_cycle_get();
+    lane->head++;
+    lane->enqueued++;
+    if (depth + 1 > lane->depth_max) {
+        lane->depth_max = depth + 1;
+    }
+    BSP_CAN_TxRefill(bus_manager);
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+/**
+ * @description: 直接写入发送邮箱，中断模式下按令牌等待这一帧发送完成
+ * @param {CANBusManager*} bus_manager
+ * @param {CAN_TxHeaderTypeDef*} header
+ * @param {uint8_t*} data
+ * @param {uint32_t*} tx_mailbox, 输出使用的邮箱
+ * @param {CanTxToken*} token, 输出发送令牌
+ * @param {uint8_t} mode, CAN_MODE_BLOCKING/CAN_MODE_IT
+ * @return {osal_status_t}
+ */
+static osal_status_t BSP_CAN_Transmit(CANBusManager *bus_manager, CAN_TxHeaderTypeDef *header, uint8_t *data,
+                                      uint32_t *tx_mailbox, CanTxToken *token, uint8_t mode)
+{
+    osal_critical_state_t crit;
+    osal_status_t status;
+
+    if (bus_manager == NULL) {
         return OSAL_ERROR;
     }
+
+    // 写邮箱和分配令牌在同一临界区中，两条总线、同一总线的多个发送者互不等待
+    osal_enter_critical(&crit);
+    status = BSP_CAN_AddTx(bus_manager, header, data, tx_mailbox, token);
+    osal_exit_critical(&crit);
+    if (status != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+
+    // 如果是中断模式，则等待这一帧发送完成
+    if (mode == CAN_MODE_IT) {
+        return BSP_CAN_WaitTx(*token, OSAL_WAIT_FOREVER);
+    }
+
+    return OSAL_SUCCESS;
+}
+
+osal_status_t BSP_CAN_SendDevice(Can_Device *device)
+{
+    if (device == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
     
-    // 如果是中断模式，则等待发送完成事件
-    if (device->tx_mode == CAN_MODE_IT) {
-        unsigned int actual_flags;
-        uint32_t tx_event_flag = 0;
-        
-        // 根据邮箱号选择对应的事件标志
-        switch (device->tx_mailbox) {
-            case CAN_TX_MAILBOX0:
-                tx_event_flag = CAN_EVENT_TX_MAILBOX0_DONE;
-                break;
-            case CAN_TX_MAILBOX1:
-                tx_event_flag = CAN_EVENT_TX_MAILBOX1_DONE;
-                break;
-            case CAN_TX_MAILBOX2:
-                tx_event_flag = CAN_EVENT_TX_MAILBOX2_DONE;
-                break;
-            default:
-                return OSAL_ERROR;
-        }
-        
-        // 等待发送完成事件
-        osal_status_t wait_status = osal_event_wait(&global_can_event, 
-                                                   tx_event_flag,
-                                                   OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                   OSAL_WAIT_FOREVER, 
-                                                   &actual_flags);
-        
-        if (wait_status == OSAL_SUCCESS && (actual_flags & tx_event_flag)) {
-            return OSAL_SUCCESS;
-        } else {
+    CANBusManager *bus_manager = BSP_CAN_GetBus(device->can_handle);
+    osal_status_t status;
+    
+    // 队列模式入队后立即返回
+    if (device->tx_mode == CAN_MODE_QUEUE) {
+        if (bus_manager == NULL) {
             return OSAL_ERROR;
         }
+        status = BSP_CAN_TxEnqueue(bus_manager, &device->txconf, device->tx_buff, device->tx_prio);
+    } else {
+        status = BSP_CAN_Transmit(bus_manager, &device->txconf, device->tx_buff,
+                                  &device->tx_mailbox, &device->tx_token, device->tx_mode);
     }
-    
-    return OSAL_SUCCESS;
+#if CAN_STAT_ENABLE
+    if (status == OSAL_SUCCESS) {
+        device->tx_frames++;
+    }
+#endif
+    return status;
 }
 
 /**
- * @description: 发送CAN消息
+ * @description: 发送CAN消息，CAN_MODE_QUEUE时放入tx_prio对应的发送队列
  * @param {CanTxMessage_t*} tx_message
+ * @param {uint8_t} mode, CAN_MODE_BLOCKING/CAN_MODE_IT/CAN_MODE_QUEUE
  * @return {*}
  */
 osal_status_t BSP_CAN_SendMessage(CanTxMessage_t *tx_message,uint8_t mode)
@@ -275,68 +843,98 @@ osal_status_t BSP_CAN_SendMessage(CanTxMessage_t *tx_message,uint8_t mode)
         return OSAL_INVALID_PARAM;
     }
     
-    // 获取互斥锁保护
-    CANBusManager *bus_manager = NULL;
-    for (int i = 0; i < CAN_BUS_NUM; i++) {
-        if (can_bus_managers[i].hcan == tx_message->can_handle) {
-            bus_manager = &can_bus_managers[i];
-            break;
-        }
+    if (mode == CAN_MODE_QUEUE) {
+        return BSP_CAN_QueueMessage(tx_message, tx_message->tx_prio);
     }
     
-    if (bus_manager != NULL) {
-        if (osal_mutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
-            return OSAL_ERROR;
+    // 总线上还没有注册设备时在此建立管理器，发送完成事件按总线区分
+    BSP_CAN_Init_Global();
+    CANBusManager *bus_manager = BSP_CAN_InitBusManager(tx_message->can_handle);
+    
+    return BSP_CAN_Transmit(bus_manager, &tx_message->txconf, tx_message->tx_buff,
+                            &tx_message->tx_mailbox, &tx_message->tx_token, mode);
+}
+
+osal_status_t BSP_CAN_Submit(CanTxMessage_t *tx_message, osal_tick_t timeout)
+{
+    osal_critical_state_t crit;
+    CanTxDoneState state;
+    osal_status_t status;
+
+    if (tx_message == NULL || tx_message->can_handle == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    BSP_CAN_Init_Global();
+    CANBusManager *bus_manager = BSP_CAN_InitBusManager(tx_message->can_handle);
+    if (bus_manager == NULL) {
+        return OSAL_ERROR;
+    }
+
+    // 先记下完成通知的版本再尝试写邮箱，之后的任何一次发送完成都会唤醒本线程
+    uint32_t version = osal_mailbox_peek(&bus_manager->tx_notify, &state);
+    osal_tick_t start = osal_tick_get();
+    for (;;) {
+        osal_enter_critical(&crit);
+        status = BSP_CAN_AddTx(bus_manager, &tx_message->txconf, tx_message->tx_buff,
+                               &tx_message->tx_mailbox, &tx_message->tx_token);
+        osal_exit_critical(&crit);
+        if (status != OSAL_NO_MEMORY) {
+            return status;
+        }
+        // 邮箱全满：等待本总线的下一次发送完成
+        if (osal_mailbox_read(&bus_manager->tx_notify, &state, &version,
+                              BSP_CAN_Remaining(start, timeout)) != OSAL_SUCCESS) {
+            return OSAL_TIMEOUT;
         }
     }
-    
-    HAL_StatusTypeDef status = HAL_CAN_AddTxMessage(tx_message->can_handle, &tx_message->txconf, 
-                                                   tx_message->tx_buff, &tx_message->tx_mailbox);
-    
-    // 释放互斥锁
-    if (bus_manager != NULL) {
-        osal_mutex_unlock(&bus_manager->bus_mutex);
+}
+
+osal_status_t BSP_CAN_WaitTx(CanTxToken token, osal_tick_t timeout)
+{
+    CanTxDoneState state;
+    uint32_t bus_index = token >> CAN_TX_TOKEN_BUS_SHIFT;
+    uint32_t mb = (token >> CAN_TX_TOKEN_MB_SHIFT) & 0x3U;
+    uint32_t seq = token & CAN_TX_SEQ_MASK;
+
+    if (token == CAN_TX_TOKEN_NONE || bus_index >= CAN_BUS_NUM || mb > 2 || can_bus_map[bus_index] == NULL) {
+        return OSAL_INVALID_PARAM;
     }
-                                                   
-    if (status != HAL_OK) {
+    CANBusManager *bus_manager = can_bus_map[bus_index];
+
+    // 先取快照再判断，快照之后的完成一定会改变版本号，不会丢失唤醒；别的邮箱、别的总线的完成不影响判断
+    uint32_t version = osal_mailbox_peek(&bus_manager->tx_notify, &state);
+    osal_tick_t start = osal_tick_get();
+    while (!BSP_CAN_TxSeqReached(state.done_seq[mb], seq)) {
+        if (osal_mailbox_read(&bus_manager->tx_notify, &state, &version,
+                              BSP_CAN_Remaining(start, timeout)) != OSAL_SUCCESS) {
+            return OSAL_TIMEOUT;
+        }
+    }
+    // 只知道邮箱最近一帧的结果，之后该邮箱又完成过其他帧时按已发出处理
+    if (state.done_seq[mb] == seq && (state.abort_mask & (1U << mb))) {
         return OSAL_ERROR;
     }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t BSP_CAN_QueueMessage(CanTxMessage_t *tx_message, CAN_TxPriority prio)
+{
+    if (tx_message == NULL || tx_message->can_handle == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
     
-    // 如果是中断模式，则等待发送完成事件
-    if (mode == CAN_MODE_IT) {
-        unsigned int actual_flags;
-        uint32_t tx_event_flag = 0;
-        
-        // 根据邮箱号选择对应的事件标志
-        switch (tx_message->tx_mailbox) {
-            case CAN_TX_MAILBOX0:
-                tx_event_flag = CAN_EVENT_TX_MAILBOX0_DONE;
-                break;
-            case CAN_TX_MAILBOX1:
-                tx_event_flag = CAN_EVENT_TX_MAILBOX1_DONE;
-                break;
-            case CAN_TX_MAILBOX2:
-                tx_event_flag = CAN_EVENT_TX_MAILBOX2_DONE;
-                break;
-            default:
-                return OSAL_ERROR;
-        }
-        
-        // 等待发送完成事件
-        osal_status_t wait_status = osal_event_wait(&global_can_event, 
-                                                   tx_event_flag,
-                                                   OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                   OSAL_WAIT_FOREVER, 
-                                                   &actual_flags);
-        
-        if (wait_status == OSAL_SUCCESS && (actual_flags & tx_event_flag)) {
-            return OSAL_SUCCESS;
-        } else {
+    // 中断中只能使用已经建立的总线，线程中首次使用时建立
+    CANBusManager *bus_manager = BSP_CAN_GetBus(tx_message->can_handle);
+    if (bus_manager == NULL) {
+        BSP_CAN_Init_Global();
+        bus_manager = BSP_CAN_InitBusManager(tx_message->can_handle);
+        if (bus_manager == NULL) {
             return OSAL_ERROR;
         }
     }
     
-    return OSAL_SUCCESS;
+    return BSP_CAN_TxEnqueue(bus_manager, &tx_message->txconf, tx_message->tx_buff, prio);
 }
 
 
@@ -352,75 +950,138 @@ osal_status_t BSP_CAN_ReadSingleDevice(Can_Device *device, osal_tick_t timeout)
         uint8_t rx_data[8];
         HAL_StatusTypeDef status = HAL_OK;
         
-        // 轮询等待接收数据
-        if ((device->tx_id & 1))
-        {
-            status = HAL_CAN_GetRxMessage(device->can_handle, CAN_RX_FIFO0, 
-                                        &rx_header, rx_data);
-        }
-        else
-        {
-            status = HAL_CAN_GetRxMessage(device->can_handle, CAN_RX_FIFO1, 
-                                        &rx_header, rx_data);            
-        }
-
+        // 从过滤器规划分配给该设备的FIFO中取一帧
+        status = HAL_CAN_GetRxMessage(device->can_handle, device->rx_fifo ? CAN_RX_FIFO1 : CAN_RX_FIFO0,
+                                      &rx_header, rx_data);
         
-        if (status == HAL_OK && rx_header.StdId == device->rx_id) {
-            // 更新设备缓冲区
-            memcpy(device->rx_buff, rx_data, rx_header.DLC);
-            device->rx_len = rx_header.DLC;
-            return OSAL_SUCCESS;
+        // FIFO为空等情况下rx_header未被写入，成功后再取ID
+        if (status == HAL_OK) {
+            uint32_t id = (rx_header.IDE == CAN_ID_EXT) ? rx_header.ExtId : rx_header.StdId;
+            if (rx_header.IDE == device->id_type && id == device->rx_id) {
+                // 更新设备缓冲区
+                memcpy(device->rx_buff, rx_data, rx_header.DLC);
+                device->rx_len = rx_header.DLC;
+                return OSAL_SUCCESS;
+            }
         }
         
         return OSAL_ERROR;
     }
     
     // 等待设备事件（中断模式）
-    unsigned int actual_flags;
-    osal_status_t status = osal_event_wait(&global_can_event, device->eventflag,
-                                          OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                          timeout, &actual_flags);
-    
-    if (status == OSAL_SUCCESS && (actual_flags & device->eventflag)) {
-        return OSAL_SUCCESS;
-    }
-    
-    return OSAL_ERROR;
+    return osal_wevent_wait_flag(&can_event, device->event_index, timeout);
 }
 
-uint32_t BSP_CAN_ReadMultipleDevice(Can_Device** devices, uint8_t device_count, osal_tick_t timeout)
+Can_Device* BSP_CAN_ReadMultipleDevice(Can_Device** devices, uint8_t device_count, osal_tick_t timeout)
 {
     if (devices == NULL || device_count == 0) {
-        return 0;
+        return NULL;
     }
 
-    
     // 构建设备事件标志组合（中断模式）
-    uint32_t combined_event_flags = 0;
+    osal_wevent_mask_t wait_mask, actual;
+    uint8_t valid = 0;
+    osal_wevent_mask_zero(&wait_mask);
     for (int i = 0; i < device_count; i++) {
-        if (devices[i] != NULL) {combined_event_flags |= devices[i]->eventflag;}
+        if (devices[i] != NULL) {
+            osal_wevent_mask_add(&wait_mask, devices[i]->event_index);
+            valid = 1;
+        }
     }
     
-    if (combined_event_flags == 0) {
-        return 0;
+    if (!valid) {
+        return NULL;
     }
     
-    // 等待任意一个设备的事件
-    unsigned int actual_flags;
-    osal_status_t status = osal_event_wait(&global_can_event, combined_event_flags,
-                                          OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,timeout, 
-                                          &actual_flags);
-    if (status == OSAL_SUCCESS) {
-        // 查找触发事件的设备并返回其eventflag
+    // 等待任意一个设备的事件，只清除返回的那个设备的标志，其他设备的数据留到下次读取
+    if (osal_wevent_wait(&can_event, &wait_mask, OSAL_EVENT_WAIT_FLAG_OR, timeout, &actual) == OSAL_SUCCESS) {
         for (int i = 0; i < device_count; i++) {
-            if (devices[i] != NULL && (actual_flags & devices[i]->eventflag)) {
-                return devices[i]->eventflag;
+            if (devices[i] != NULL && osal_wevent_mask_test(&actual, devices[i]->event_index)) {
+                osal_wevent_mask_zero(&wait_mask);
+                osal_wevent_mask_add(&wait_mask, devices[i]->event_index);
+                osal_wevent_clear(&can_event, &wait_mask);
+                return devices[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @description: 把一帧报文分发给对应设备
+ * @param {CANBusManager*} bus_manager
+ * @param {uint32_t} ide, CAN_ID_STD/CAN_ID_EXT
+ * @param {uint32_t} id
+ * @param {uint8_t*} data
+ * @param {uint8_t} dlc
+ * @return {*}
+ */
+static void BSP_CAN_Dispatch(CANBusManager *bus_manager, uint32_t ide, uint32_t id, const uint8_t *data, uint8_t dlc)
+{
+    Can_Device *device = NULL;
+#if CAN_PROFILE_ENABLE
+    uint32_t start = osal_cycle_get();
+#endif
+
+    // 查找对应的设备，过滤器掩码放宽时收到的无关ID在这里丢弃
+#if CAN_RX_LUT_ENABLE
+    if (ide == CAN_ID_STD) {
+        uint8_t slot = can_rx_lut[bus_manager - can_bus_managers][id & CAN_STD_ID_MASK];
+        if (slot != 0) {
+            device = &bus_manager->devices[slot - 1];
+        }
+    } else
+#endif
+    {
+        for (int i = 0; i < bus_manager->device_count; i++) {
+            if (bus_manager->devices[i].rx_id == id && bus_manager->devices[i].id_type == ide) {
+                device = &bus_manager->devices[i];
+                break;
             }
         }
     }
-    return 0;
+    if (device != NULL) {
+        // 更新设备缓冲区
+        memcpy(device->rx_buff, data, dlc);
+        device->rx_len = dlc;
+        // 设置设备事件标志
+        osal_wevent_set_flag(&can_event, device->event_index);
+#if CAN_STAT_ENABLE
+        device->rx_frames++;
+    } else {
+        bus_manager->stat_rx_unmatched++;
+#endif
+    }
+
+#if CAN_PROFILE_ENABLE
+    uint32_t cycles = osal_cycle_get() - start;
+    bus_manager->rx_dispatch_count++;
+    bus_manager->rx_dispatch_cycles_total += cycles;
+    if (cycles > bus_manager->rx_dispatch_cycles_max) {
+        bus_manager->rx_dispatch_cycles_max = cycles;
+    }
+#endif
 }
 
+#if BSP_IRQ_DEFER_ENABLE
+/**
+ * @description: 接收下半部，在工作线程中取出软件缓冲区中的全部报文并分发
+ * @param {void*} arg, CanRxFifo指针
+ * @return {*}
+ */
+static void BSP_CAN_RxProcess(void *arg)
+{
+    CanRxFifo *rx_fifo = (CanRxFifo *)arg;
+    CanRxFrame frame;
+
+    // 先清除标志再取数据，之后到达的报文会重新提交下半部
+    __atomic_store_n(&rx_fifo->pending, 0, __ATOMIC_SEQ_CST);
+    while (osal_ringbuf_pop(&rx_fifo->ring, &frame, OSAL_NO_WAIT) == OSAL_SUCCESS) {
+        BSP_CAN_Dispatch(rx_fifo->bus, frame.ide, frame.id, frame.data, frame.dlc);
+    }
+}
+#endif
+
 /**
  * @description: CAN接收中断回调函数
  * @param {CAN_HandleTypeDef*} hcan
@@ -429,14 +1090,12 @@ uint32_t BSP_CAN_ReadMultipleDevice(Can_Device** devices, uint8_t device_count,
  */
 static void BSP_CAN_RxCallback(CAN_HandleTypeDef *hcan, uint32_t RxFifo)
 {
+#if CAN_PROFILE_ENABLE
+    uint32_t isr_start = osal_cycle_get();
+    uint32_t frames = 0;
+#endif
     // 查找对应的总线管理器
-    CANBusManager *bus_manager = NULL;
-    for (int i = 0; i < CAN_BUS_NUM; i++) {
-        if (can_bus_managers[i].hcan == hcan) {
-            bus_manager = &can_bus_managers[i];
-            break;
-        }
-    }
+    CANBusManager *bus_manager = BSP_CAN_GetBus(hcan);
     
     if (bus_manager == NULL) {
         return;
@@ -444,24 +1103,69 @@ static void BSP_CAN_RxCallback(CAN_HandleTypeDef *hcan, uint32_t RxFifo)
     
     // 处理接收到的消息
     CAN_RxHeaderTypeDef rx_header;
+#if BSP_IRQ_DEFER_ENABLE
+    CanRxFifo *rx_fifo = &can_rx_fifos[bus_manager - can_bus_managers][RxFifo == CAN_RX_FIFO0 ? 0 : 1];
+    CanRxFrame frame;
+
+    while (HAL_CAN_GetRxFifoFillLevel(hcan, RxFifo) > 0) {
+        if (HAL_CAN_GetRxMessage(hcan, RxFifo, &rx_header, frame.data) == HAL_OK) {
+            frame.ide = (uint8_t)rx_header.IDE;
+            frame.id = (rx_header.IDE == CAN_ID_EXT) ? rx_header.ExtId : rx_header.StdId;
+            frame.dlc = (uint8_t)rx_header.DLC;
+            osal_ringbuf_push(&rx_fifo->ring, &frame);
+#if CAN_STAT_ENABLE
+            bus_manager->stat_rx_frames[RxFifo]++;
+            BSP_CAN_StatFrame(&bus_manager->stat_rx_bits[RxFifo], &bus_manager->stat_rx_stuff[RxFifo],
+                              rx_header.IDE, rx_header.RTR, rx_header.DLC);
+#endif
+#if CAN_PROFILE_ENABLE
+            frames++;
+#endif
+        }
+    }
+    // 同一缓冲区只提交一次下半部
+    if (__atomic_exchange_n(&rx_fifo->pending, 1, __ATOMIC_SEQ_CST) == 0) {
+        osal_status_t status = osal_defer(BSP_CAN_RxProcess, rx_fifo);
+        if (status == OSAL_ERROR) {
+            // 执行器未初始化，没有其他消费者，直接在中断中处理
+            BSP_CAN_RxProcess(rx_fifo);
+        } else if (status != OSAL_SUCCESS) {
+            // 队列满，报文留在缓冲区中，下一帧到达时重新提交
+            rx_fifo->pending = 0;
+        }
+    }
+#else
     uint8_t rx_data[8];
-    
+
     while (HAL_CAN_GetRxFifoFillLevel(hcan, RxFifo) > 0) {
         if (HAL_CAN_GetRxMessage(hcan, RxFifo, &rx_header, rx_data) == HAL_OK) {
-            // 查找对应的设备
-            for (int i = 0; i < bus_manager->device_count; i++) {
-                Can_Device *device = &bus_manager->devices[i];
-                if (device->rx_id == rx_header.StdId) {
-                    // 更新设备缓冲区
-                    memcpy(device->rx_buff, rx_data, rx_header.DLC);
-                    device->rx_len = rx_header.DLC;
-                    // 设置设备事件标志
-                    osal_event_set(&global_can_event, device->eventflag);
-                    break;
-                }
-            }
+            BSP_CAN_Dispatch(bus_manager, rx_header.IDE,
+                             (rx_header.IDE == CAN_ID_EXT) ? rx_header.ExtId : rx_header.StdId,
+                             rx_data, rx_header.DLC);
+#if CAN_STAT_ENABLE
+            bus_manager->stat_rx_frames[RxFifo]++;
+            BSP_CAN_StatFrame(&bus_manager->stat_rx_bits[RxFifo], &bus_manager->stat_rx_stuff[RxFifo],
+                              rx_header.IDE, rx_header.RTR, rx_header.DLC);
+#endif
+#if CAN_PROFILE_ENABLE
+            frames++;
+#endif
+        }
+    }
+#endif
+
+#if CAN_PROFILE_ENABLE
+    // FIFO0/FIFO1中断可能互相嵌套，统计只用于性能对比
+    if (frames > 0) {
+        uint32_t cycles = osal_cycle_get() - isr_start;
+        bus_manager->rx_irq_count++;
+        bus_manager->rx_frame_count += frames;
+        bus_manager->rx_isr_cycles_total += cycles;
+        if (cycles / frames > bus_manager->rx_isr_cycles_max) {
+            bus_manager->rx_isr_cycles_max = cycles / frames;
         }
     }
+#endif
 }
 
 void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
@@ -474,20 +1178,588 @@ void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan)
     BSP_CAN_RxCallback(hcan, CAN_RX_FIFO1);
 }
 
+/**
+ * @description: 发送邮箱完成/中止中断：结算该邮箱中的一帧，然后从发送队列补充空闲邮箱
+ * @param {CAN_HandleTypeDef*} hcan
+ * @param {uint8_t} mailbox, 0-2
+ * @param {uint8_t} ok, 1表示发送成功，0表示被中止
+ * @return {*}
+ */
+static void BSP_CAN_TxCallback(CAN_HandleTypeDef *hcan, uint8_t mailbox, uint8_t ok)
+{
+    osal_critical_state_t crit;
+    CANBusManager *bus_manager = BSP_CAN_GetBus(hcan);
+
+    if (bus_manager == NULL) {
+        return;
+    }
+
+    osal_enter_critical(&crit);
+    // HAL按进入中断时读到的TSR依次回调，前面的回调补充邮箱时可能已经结算并重新占用了这个邮箱，
+    // 邮箱非空说明其中是新的一帧，本次完成已在BSP_CAN_AddTx中结算
+    if (hcan->Instance->TSR & (CAN_TSR_TME0 << mailbox)) {
+        BSP_CAN_TxSettle(bus_manager, mailbox, ok);
+    }
+    BSP_CAN_TxRefill(bus_manager);
+    osal_exit_critical(&crit);
+}
+
 void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan)
 {
-    // 设置发送完成事件
-    osal_event_set(&global_can_event, CAN_EVENT_TX_MAILBOX0_DONE);
+    BSP_CAN_TxCallback(hcan, 0, 1);
 }
 
 void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan)
 {
-    // 设置发送完成事件
-    osal_event_set(&global_can_event, CAN_EVENT_TX_MAILBOX1_DONE);
+    BSP_CAN_TxCallback(hcan, 1, 1);
 }
 
 void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan)
 {
-    // 设置发送完成事件
-    osal_event_set(&global_can_event, CAN_EVENT_TX_MAILBOX2_DONE);
-}
\ No newline at end of file
+    BSP_CAN_TxCallback(hcan, 2, 1);
+}
+
+void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef *hcan)
+{
+    BSP_CAN_TxCallback(hcan, 0, 0);
+}
+
+void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef *hcan)
+{
+    BSP_CAN_TxCallback(hcan, 1, 0);
+}
+
+void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef *hcan)
+{
+    BSP_CAN_TxCallback(hcan, 2, 0);
+}
+
+#if CAN_TX_IRQ_HANDLER_ENABLE
+/* CubeMX没有打开CAN发送中断，由这里提供中断入口 */
+void CAN1_TX_IRQHandler(void)
+{
+    HAL_CAN_IRQHandler(&hcan1);
+}
+
+void CAN2_TX_IRQHandler(void)
+{
+    HAL_CAN_IRQHandler(&hcan2);
+}
+#endif
+
+#if CAN_STAT_ENABLE
+/**
+ * @description: CAN错误中断回调：统计FIFO溢出、发送错误和错误警告/被动/离线，清除HAL累积的错误码
+ * @param {CAN_HandleTypeDef*} hcan
+ * @return {*}
+ */
+void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan)
+{
+    CANBusManager *bus_manager = BSP_CAN_GetBus(hcan);
+    uint32_t error = HAL_CAN_GetError(hcan);
+
+    if (bus_manager != NULL) {
+        if (error & HAL_CAN_ERROR_RX_FOV0) {
+            bus_manager->stat_fifo_overrun[0]++;
+        }
+        if (error & HAL_CAN_ERROR_RX_FOV1) {
+            bus_manager->stat_fifo_overrun[1]++;
+        }
+        if (error & (HAL_CAN_ERROR_TX_TERR0 | HAL_CAN_ERROR_TX_TERR1 | HAL_CAN_ERROR_TX_TERR2)) {
+            bus_manager->stat_tx_errors++;
+        }
+        if (error & HAL_CAN_ERROR_EWG) {
+            bus_manager->stat_err_warning++;
+        }
+        if (error & HAL_CAN_ERROR_EPV) {
+            bus_manager->stat_err_passive++;
+        }
+        if (error & HAL_CAN_ERROR_BOF) {
+            bus_manager->stat_bus_off++;
+        }
+    }
+    HAL_CAN_ResetError(hcan);
+}
+
+#if CAN_SCE_IRQ_HANDLER_ENABLE
+/* CubeMX没有打开CAN状态变化/错误中断，由这里提供中断入口 */
+void CAN1_SCE_IRQHandler(void)
+{
+    HAL_CAN_IRQHandler(&hcan1);
+}
+
+void CAN2_SCE_IRQHandler(void)
+{
+    HAL_CAN_IRQHandler(&hcan2);
+}
+#endif
+#endif
+
+#if CAN_PROFILE_ENABLE
+static void shell_can_isr(int reset)
+{
+    if (reset) {
+        for (int i = 0; i < CAN_BUS_NUM; i++) {
+            CANBusManager *bus = &can_bus_managers[i];
+            bus->rx_irq_count = 0;
+            bus->rx_frame_count = 0;
+            bus->rx_isr_cycles_total = 0;
+            bus->rx_isr_cycles_max = 0;
+            bus->rx_dispatch_count = 0;
+            bus->rx_dispatch_cycles_total = 0;
+            bus->rx_dispatch_cycles_max = 0;
+        }
+        shell_printf("CAN ISR statistics cleared.\r\n\r\n");
+        return;
+    }
+
+    shell_printf("CAN RX (CPU cycles per frame, lookup %s, defer %s):\r\n",
+                 CAN_RX_LUT_ENABLE ? "table" : "scan", BSP_IRQ_DEFER_ENABLE ? "on" : "off");
+    shell_printf("%-12s %-10s %-10s %-10s %-10s %-12s %-12s\r\n",
+                 "Bus", "IRQs", "Frames", "IsrAvg", "IsrMax", "DispatchAvg", "DispatchMax");
+    shell_printf("-------------------------------------------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        shell_printf("%-12p %-10lu %-10lu %-10lu %-10lu %-12lu %-12lu\r\n",
+                     (void *)bus->hcan->Instance,
+                     (unsigned long)bus->rx_irq_count,
+                     (unsigned long)bus->rx_frame_count,
+                     bus->rx_frame_count ? (unsigned long)(bus->rx_isr_cycles_total / bus->rx_frame_count) : 0UL,
+                     (unsigned long)bus->rx_isr_cycles_max,
+                     bus->rx_dispatch_count ? (unsigned long)(bus->rx_dispatch_cycles_total / bus->rx_dispatch_count) : 0UL,
+                     (unsigned long)bus->rx_dispatch_cycles_max);
+    }
+    shell_printf("Isr = whole RX interrupt / frames drained; Dispatch = device lookup, copy and event set.\r\n");
+    shell_printf("Use 'can isr reset' to clear statistics.\r\n");
+    shell_printf("\r\n");
+}
+#endif
+
+static void shell_can_tx(int reset)
+{
+    static const char *lane_name[CAN_TX_PRIO_NUM] = {"high", "low"};
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+
+    if (reset) {
+        for (int i = 0; i < CAN_BUS_NUM; i++) {
+            for (int prio = 0; prio < CAN_TX_PRIO_NUM; prio++) {
+                CanTxLane *lane = &can_bus_managers[i].tx_lanes[prio];
+                lane->depth_max = 0;
+                lane->enqueued = 0;
+                lane->sent = 0;
+                lane->dropped = 0;
+                lane->failed = 0;
+                lane->latency_total = 0;
+                lane->latency_max = 0;
+            }
+        }
+        shell_printf("CAN TX queue statistics cleared.\r\n\r\n");
+        return;
+    }
+
+    shell_printf("CAN TX queue (size %d per lane, latency = enqueue to transmit complete, us):\r\n", CAN_TX_QUEUE_SIZE);
+    shell_printf("%-12s %-6s %-6s %-8s %-10s %-10s %-8s %-8s %-8s %-8s\r\n",
+                 "Bus", "Lane", "Depth", "MaxDepth", "Enqueued", "Sent", "Dropped", "Failed", "LatAvg", "LatMax");
+    shell_printf("-----------------------------------------------------------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        for (int prio = 0; prio < CAN_TX_PRIO_NUM; prio++) {
+            CanTxLane *lane = &bus->tx_lanes[prio];
+            shell_printf("%-12p %-6s %-6u %-8u %-10lu %-10lu %-8lu %-8lu %-8lu %-8lu\r\n",
+                         (void *)bus->hcan->Instance, lane_name[prio],
+                         (unsigned int)(uint16_t)(lane->head - lane->tail),
+                         (unsigned int)lane->depth_max,
+                         (unsigned long)lane->enqueued,
+                         (unsigned long)lane->sent,
+                         (unsigned long)lane->dropped,
+                         (unsigned long)lane->failed,
+                         lane->sent ? (unsigned long)(lane->latency_total / lane->sent / cycles_per_us) : 0UL,
+                         (unsigned long)(lane->latency_max / cycles_per_us));
+        }
+    }
+    shell_printf("Use 'can tx reset' to clear statistics.\r\n");
+    shell_printf("\r\n");
+}
+
+#if CAN_STAT_ENABLE
+/**
+ * @description: 由BTR寄存器和APB1时钟计算波特率
+ * @param {CAN_HandleTypeDef*} hcan
+ * @return {uint32_t} bit/s
+ */
+static uint32_t BSP_CAN_Bitrate(CAN_HandleTypeDef *hcan)
+{
+    uint32_t btr = hcan->Instance->BTR;
+    uint32_t brp = (btr & CAN_BTR_BRP) + 1U;
+    uint32_t tq = 1U + (((btr & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + 1U) + (((btr & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos) + 1U);
+    return HAL_RCC_GetPCLK1Freq() / (brp * tq);
+}
+
+/**
+ * @description: 总线收发帧占用的位数
+ * @param {CANBusManager*} bus
+ * @param {int} stuffed, 1表示加上填充位上界
+ * @return {uint64_t}
+ */
+static uint64_t BSP_CAN_StatBits(CANBusManager *bus, int stuffed)
+{
+    uint64_t bits = bus->stat_rx_bits[0] + bus->stat_rx_bits[1] + bus->stat_tx_bits;
+    if (stuffed) {
+        bits += bus->stat_rx_stuff[0] + bus->stat_rx_stuff[1] + bus->stat_tx_stuff;
+    }
+    return bits;
+}
+
+static void shell_can_stat_reset(void)
+{
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        for (int fifo = 0; fifo < 2; fifo++) {
+            bus->stat_rx_frames[fifo] = 0;
+            bus->stat_rx_bits[fifo] = 0;
+            bus->stat_rx_stuff[fifo] = 0;
+            bus->stat_fifo_overrun[fifo] = 0;
+        }
+        bus->stat_rx_unmatched = 0;
+        bus->stat_tx_frames = 0;
+        bus->stat_tx_bits = 0;
+        bus->stat_tx_stuff = 0;
+        bus->stat_tx_errors = 0;
+        bus->stat_err_warning = 0;
+        bus->stat_err_passive = 0;
+        bus->stat_bus_off = 0;
+        for (int d = 0; d < bus->device_count; d++) {
+            bus->devices[d].rx_frames = 0;
+            bus->devices[d].tx_frames = 0;
+        }
+        for (int prio = 0; prio < CAN_TX_PRIO_NUM; prio++) {
+            bus->tx_lanes[prio].wait_count = 0;
+            bus->tx_lanes[prio].wait_total = 0;
+            bus->tx_lanes[prio].wait_max = 0;
+        }
+    }
+    shell_printf("CAN statistics cleared.\r\n\r\n");
+}
+
+static void shell_can_stat(int argc, char **argv)
+{
+    static const char *lane_name[CAN_TX_PRIO_NUM] = {"high", "low"};
+    // 采样窗口开始时的计数，静态存放避免占用shell线程栈
+    static uint32_t dev_rx[CAN_BUS_NUM][MAX_DEVICES_PER_CAN_BUS], dev_tx[CAN_BUS_NUM][MAX_DEVICES_PER_CAN_BUS];
+    static uint32_t bus_rx[CAN_BUS_NUM], bus_tx[CAN_BUS_NUM];
+    static uint64_t bus_bits[CAN_BUS_NUM], bus_stuffed[CAN_BUS_NUM];
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    uint32_t ms = 1000;
+
+    if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+        shell_can_stat_reset();
+        return;
+    }
+    if (argc >= 3) {
+        ms = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    if (ms < 10 || ms > 10000) {
+        shell_printf("Usage: can stat [ms|reset], window 10-10000 ms, default 1000\r\n\r\n");
+        return;
+    }
+
+    // 在窗口前后各取一次计数，帧率和负载按差值计算
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        bus_rx[i] = bus->stat_rx_frames[0] + bus->stat_rx_frames[1];
+        bus_tx[i] = bus->stat_tx_frames;
+        bus_bits[i] = BSP_CAN_StatBits(bus, 0);
+        bus_stuffed[i] = BSP_CAN_StatBits(bus, 1);
+        for (int d = 0; d < bus->device_count; d++) {
+            dev_rx[i][d] = bus->devices[d].rx_frames;
+            dev_tx[i][d] = bus->devices[d].tx_frames;
+        }
+    }
+    osal_delay_ms(ms);
+
+    shell_printf("CAN bus load over %lu ms (Load = bits on the wire / bitrate, without..with worst-case stuffing):\r\n",
+                 (unsigned long)ms);
+    shell_printf("%-12s %-8s %-8s %-8s %-13s %-10s %-10s\r\n",
+                 "Bus", "kbit/s", "RxFr/s", "TxFr/s", "Load%", "RxTotal", "TxTotal");
+    shell_printf("-----------------------------------------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        uint32_t rx_total = bus->stat_rx_frames[0] + bus->stat_rx_frames[1];
+        uint64_t window = (uint64_t)BSP_CAN_Bitrate(bus->hcan) * ms;   // 窗口内总线可传输的位数x1000
+        uint32_t load = window ? (uint32_t)((BSP_CAN_StatBits(bus, 0) - bus_bits[i]) * 1000000U / window) : 0;
+        uint32_t load_stuffed = window ? (uint32_t)((BSP_CAN_StatBits(bus, 1) - bus_stuffed[i]) * 1000000U / window) : 0;
+        char load_str[16];
+        snprintf(load_str, sizeof(load_str), "%lu.%lu-%lu.%lu",
+                 (unsigned long)(load / 10U), (unsigned long)(load % 10U),
+                 (unsigned long)(load_stuffed / 10U), (unsigned long)(load_stuffed % 10U));
+        shell_printf("%-12p %-8lu %-8lu %-8lu %-13s %-10lu %-10lu\r\n",
+                     (void *)bus->hcan->Instance,
+                     (unsigned long)(BSP_CAN_Bitrate(bus->hcan) / 1000U),
+                     (unsigned long)((uint64_t)(rx_total - bus_rx[i]) * 1000U / ms),
+                     (unsigned long)((uint64_t)(bus->stat_tx_frames - bus_tx[i]) * 1000U / ms),
+                     load_str,
+                     (unsigned long)rx_total,
+                     (unsigned long)bus->stat_tx_frames);
+    }
+
+    shell_printf("\r\nCAN errors (counts since reset, TEC/REC/State read from ESR now):\r\n");
+    shell_printf("%-12s %-9s %-9s %-9s %-6s %-6s %-6s %-6s %-4s %-4s %-8s\r\n",
+                 "Bus", "Overrun0", "Overrun1", "Unmatched", "TxErr", "EWG", "EPV", "BOF", "TEC", "REC", "State");
+    shell_printf("-----------------------------------------------------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        uint32_t esr = bus->hcan->Instance->ESR;
+        const char *state = (esr & CAN_ESR_BOFF) ? "bus-off" : (esr & CAN_ESR_EPVF) ? "passive" :
+                            (esr & CAN_ESR_EWGF) ? "warning" : "active";
+        shell_printf("%-12p %-9lu %-9lu %-9lu %-6lu %-6lu %-6lu %-6lu %-4lu %-4lu %-8s\r\n",
+                     (void *)bus->hcan->Instance,
+                     (unsigned long)bus->stat_fifo_overrun[0],
+                     (unsigned long)bus->stat_fifo_overrun[1],
+                     (unsigned long)bus->stat_rx_unmatched,
+                     (unsigned long)bus->stat_tx_errors,
+                     (unsigned long)bus->stat_err_warning,
+                     (unsigned long)bus->stat_err_passive,
+                     (unsigned long)bus->stat_bus_off,
+                     (unsigned long)((esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos),
+                     (unsigned long)((esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos),
+                     state);
+    }
+
+    shell_printf("\r\nCAN devices:\r\n");
+    shell_printf("%-12s %-12s %-5s %-8s %-10s %-12s %-8s %-10s\r\n",
+                 "Bus", "RxId", "FIFO", "RxFr/s", "RxTotal", "TxId", "TxFr/s", "TxTotal");
+    shell_printf("-------------------------------------------------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        for (int d = 0; d < bus->device_count; d++) {
+            Can_Device *device = &bus->devices[d];
+            shell_printf("%-12p 0x%-10lX %-5u %-8lu %-10lu 0x%-10lX %-8lu %-10lu\r\n",
+                         (void *)bus->hcan->Instance,
+                         (unsigned long)device->rx_id,
+                         (unsigned int)device->rx_fifo,
+                         (unsigned long)((uint64_t)(device->rx_frames - dev_rx[i][d]) * 1000U / ms),
+                         (unsigned long)device->rx_frames,
+                         (unsigned long)device->tx_id,
+                         (unsigned long)((uint64_t)(device->tx_frames - dev_tx[i][d]) * 1000U / ms),
+                         (unsigned long)device->tx_frames);
+        }
+    }
+
+    shell_printf("\r\nCAN TX queue wait (enqueue to mailbox, us):\r\n");
+    shell_printf("%-12s %-6s %-10s %-8s %-8s\r\n", "Bus", "Lane", "Frames", "WaitAvg", "WaitMax");
+    shell_printf("----------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        for (int prio = 0; prio < CAN_TX_PRIO_NUM; prio++) {
+            CanTxLane *lane = &bus->tx_lanes[prio];
+            shell_printf("%-12p %-6s %-10lu %-8lu %-8lu\r\n",
+                         (void *)bus->hcan->Instance, lane_name[prio],
+                         (unsigned long)lane->wait_count,
+                         lane->wait_count ? (unsigned long)(lane->wait_total / lane->wait_count / cycles_per_us) : 0UL,
+                         (unsigned long)(lane->wait_max / cycles_per_us));
+        }
+    }
+    shell_printf("Use 'can stat reset' to clear statistics.\r\n");
+    shell_printf("\r\n");
+}
+#endif
+
+static void shell_can_filter(void)
+{
+    shell_printf("CAN RX filter plan (%u banks per bus):\r\n", (unsigned int)CAN_FILTER_BANKS_PER_BUS);
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CANBusManager *bus = &can_bus_managers[i];
+        uint32_t load[2] = {0, 0};
+        if (bus->hcan == NULL) {
+            continue;
+        }
+        for (int d = 0; d < bus->device_count; d++) {
+            load[bus->devices[d].rx_fifo] += bus->devices[d].rx_rate_hz;
+        }
+        shell_printf("Bus %p: %u banks, FIFO0 %lu Hz, FIFO1 %lu Hz\r\n", (void *)bus->hcan->Instance,
+                     (unsigned int)bus->filter_banks, (unsigned long)load[0], (unsigned long)load[1]);
+        shell_printf("  %-12s %-6s %-8s %-6s\r\n", "RxId", "Type", "Rate", "FIFO");
+        for (int d = 0; d < bus->device_count; d++) {
+            Can_Device *device = &bus->devices[d];
+            shell_printf("  0x%-10lX %-6s %-8u %-6u\r\n", (unsigned long)device->rx_id,
+                         device->id_type == CAN_ID_EXT ? "ext" : "std",
+                         (unsigned int)device->rx_rate_hz, (unsigned int)device->rx_fifo);
+        }
+    }
+    shell_printf("\r\n");
+}
+
+#if CAN_BENCH_ENABLE
+/* 吞吐测试：每条总线一个发送线程，用BSP_CAN_Submit一直保持三个邮箱都有待发的帧 */
+typedef struct {
+    CAN_HandleTypeDef *hcan;
+    osal_thread_t thread;
+    osal_sem_t done;
+    osal_tick_t duration;
+    uint32_t submitted;         // 写入邮箱的帧数
+    uint32_t failed;            // 超时或被中止的次数
+    uint32_t cycles;            // 从开始到最后一帧发送完成的周期数
+    uint8_t stack[CAN_BENCH_STACK_SIZE] __attribute__((aligned(8)));
+} CanBench;
+
+static CanBench can_bench[CAN_BUS_NUM];
+
+static void can_bench_entry(ULONG input)
+{
+    CanBench *bench = (CanBench *)input;
+    CanTxToken last[3] = {CAN_TX_TOKEN_NONE, CAN_TX_TOKEN_NONE, CAN_TX_TOKEN_NONE};
+    CanTxMessage_t msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.can_handle = bench->hcan;
+    msg.txconf.StdId = CAN_BENCH_STD_ID;
+    msg.txconf.IDE = CAN_ID_STD;
+    msg.txconf.RTR = CAN_RTR_DATA;
+    msg.txconf.DLC = 8;
+    memset(msg.tx_buff, 0x55, sizeof(msg.tx_buff));    // 0/1交替，数据段不产生填充位
+
+    uint32_t start = osal_cycle_get();
+    osal_tick_t tick_start = osal_tick_get();
+    while (osal_tick_get() - tick_start < bench->duration) {
+        osal_status_t status = BSP_CAN_Submit(&msg, 10);
+        if (status == OSAL_SUCCESS) {
+            bench->submitted++;
+            last[__builtin_ctz(msg.tx_mailbox)] = msg.tx_token;
+        } else {
+            bench->failed++;
+            if (status != OSAL_TIMEOUT) {
+                break;  // 控制器未启动
+            }
+        }
+    }
+    // 同ID的帧按邮箱号而不是提交顺序发出，三个邮箱的最后一帧都完成才算结束
+    for (int mb = 0; mb < 3; mb++) {
+        if (last[mb] != CAN_TX_TOKEN_NONE && BSP_CAN_WaitTx(last[mb], 100) != OSAL_SUCCESS) {
+            bench->failed++;
+        }
+    }
+    bench->cycles = osal_cycle_get() - start;
+    osal_sem_post(&bench->done);
+}
+
+static void shell_can_bench(int argc, char **argv)
+{
+    static uint8_t sem_created = 0;
+    uint32_t ms = (argc >= 3) ? (uint32_t)strtoul(argv[2], NULL, 10) : 1000U;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    int running = 0;
+
+    // 周期计数器32位，168MHz下约25s回绕
+    if (ms == 0 || ms > 10000) {
+        shell_printf("Usage: can bench [ms], 1-10000, default 1000\r\n\r\n");
+        return;
+    }
+    if (!sem_created) {
+        for (int i = 0; i < CAN_BUS_NUM; i++) {
+            osal_sem_create(&can_bench[i].done, "CAN_Bench", 0);
+        }
+        sem_created = 1;
+    }
+
+    // 所有已初始化的总线同时开始
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CanBench *bench = &can_bench[i];
+        bench->hcan = can_bus_managers[i].hcan;
+        if (bench->hcan == NULL) {
+            continue;
+        }
+        bench->duration = ms;
+        bench->submitted = 0;
+        bench->failed = 0;
+        bench->cycles = 0;
+        if (osal_thread_create(&bench->thread, "CAN_Bench", can_bench_entry, bench, bench->stack,
+                               sizeof(bench->stack), CAN_BENCH_THREAD_PRIORITY) != OSAL_SUCCESS) {
+            bench->hcan = NULL;
+            continue;
+        }
+        osal_thread_start(&bench->thread);
+        running++;
+    }
+    if (running == 0) {
+        shell_printf("No CAN bus initialized.\r\n\r\n");
+        return;
+    }
+
+    // 8字节标准数据帧不含填充位111位，加3位帧间隔，1Mbit/s下上限约8771帧/秒
+    shell_printf("CAN TX throughput (%lu ms, StdId 0x%03X, DLC 8, 114 bits/frame without stuffing):\r\n",
+                 (unsigned long)ms, CAN_BENCH_STD_ID);
+    shell_printf("%-12s %-10s %-8s %-10s %-10s %-10s\r\n",
+                 "Bus", "Frames", "Failed", "Time(ms)", "Frames/s", "kbit/s");
+    shell_printf("-------------------------------------------------------------\r\n");
+    for (int i = 0; i < CAN_BUS_NUM; i++) {
+        CanBench *bench = &can_bench[i];
+        if (bench->hcan == NULL) {
+            continue;
+        }
+        osal_sem_wait(&bench->done, OSAL_WAIT_FOREVER);
+        osal_thread_delete(&bench->thread);
+        uint32_t us = bench->cycles / cycles_per_us;
+        uint32_t rate = us ? (uint32_t)((uint64_t)bench->submitted * 1000000U / us) : 0;
+        shell_printf("%-12p %-10lu %-8lu %-10lu %-10lu %-10lu\r\n",
+                     (void *)bench->hcan->Instance,
+                     (unsigned long)bench->submitted,
+                     (unsigned long)bench->failed,
+                     (unsigned long)(us / 1000U),
+                     (unsigned long)rate,
+                     (unsigned long)(rate * 114U / 1000U));
+    }
+    shell_printf("Needs another node (or loopback mode) to acknowledge frames; 1 Mbit/s limit is about 8771 frames/s.\r\n");
+    shell_printf("\r\n");
+}
+#endif
+
+static void shell_can_cmd(int argc, char **argv)
+{
+    int reset = (argc >= 3 && strcmp(argv[2], "reset") == 0);
+
+    if (argc >= 2 && strcmp(argv[1], "tx") == 0) {
+        shell_can_tx(reset);
+        return;
+    }
+    if (argc >= 2 && strcmp(argv[1], "filter") == 0) {
+        shell_can_filter();
+        return;
+    }
+#if CAN_STAT_ENABLE
+    if (argc >= 2 && strcmp(argv[1], "stat") == 0) {
+        shell_can_stat(argc, argv);
+        return;
+    }
+#endif
+#if CAN_BENCH_ENABLE
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        shell_can_bench(argc, argv);
+        return;
+    }
+#endif
+#if CAN_PROFILE_ENABLE
+    if (argc >= 2 && strcmp(argv[1], "isr") == 0) {
+        shell_can_isr(reset);
+        return;
+    }
+#endif
+    shell_printf("Usage: %s\r\n\r\n", CAN_SHELL_USAGE);
+}
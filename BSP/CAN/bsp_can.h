@@ -3,15 +3,38 @@
 
 #include "BSP_CONFIG.h"
 #include "osal_def.h"
+#include "osal_mailbox.h"
+#include "osal_wevent.h"
 #include "can.h"
 #include <stdint.h>
 
 /* 接收模式枚举 */
 typedef enum {
     CAN_MODE_BLOCKING,
-    CAN_MODE_IT
+    CAN_MODE_IT,
+    CAN_MODE_QUEUE      // 仅用于发送：放入软件发送队列后立即返回，由发送邮箱空中断依次发出
 } CAN_Mode;
 
+/* 软件发送队列优先级，邮箱空出时先发完高优先级的帧 */
+typedef enum {
+    CAN_TX_PRIO_HIGH = 0,   // 控制指令
+    CAN_TX_PRIO_LOW,        // 遥测、参数配置
+    CAN_TX_PRIO_NUM
+} CAN_TxPriority;
+
+/*
+ * 发送令牌：每次写入发送邮箱得到一个令牌，bit31为总线(0-CAN1, 1-CAN2)，bit29-30为邮箱号，
+ * bit0-28为该邮箱的提交序号(从1开始，回绕时跳过0)，BSP_CAN_WaitTx按令牌等待这一帧发送完成
+ */
+typedef uint32_t CanTxToken;
+#define CAN_TX_TOKEN_NONE 0U
+
+/* 每条总线三个发送邮箱的完成状态，发送完成中断中更新后整体发布到tx_notify */
+typedef struct {
+    uint32_t done_seq[3];           // 各邮箱最近完成的提交序号
+    uint8_t abort_mask;             // 最近完成的一帧被中止的邮箱
+} CanTxDoneState;
+
 /* CAN设备实例结构体 */
 typedef struct
 {
@@ -20,15 +43,24 @@ typedef struct
     CAN_TxHeaderTypeDef txconf;     // 发送配置
     uint32_t tx_id;                 // 发送ID
     uint32_t tx_mailbox;            // 发送邮箱号
+    CanTxToken tx_token;            // 最近一次写入邮箱的发送令牌
     uint8_t tx_buff[8];             // 发送缓冲区
     CAN_Mode tx_mode;
+    CAN_TxPriority tx_prio;         // CAN_MODE_QUEUE下使用的发送队列
+    uint32_t id_type;               // CAN_ID_STD/CAN_ID_EXT，收发ID类型
     // 接收配置
     uint32_t rx_id;                 // 接收ID
+    uint16_t rx_rate_hz;            // 预计接收帧率
+    uint8_t rx_fifo;                // 过滤器规划分配的接收FIFO，0/1
     uint8_t rx_buff[8];          // 接收缓冲区
     uint8_t rx_len;                 // 接收长度
     CAN_Mode rx_mode;
     // 事件
-    uint32_t eventflag;
+    uint16_t event_index;           // 接收事件在CAN宽事件组中的标志
+#if CAN_STAT_ENABLE
+    uint32_t rx_frames;             // 分发给本设备的帧数
+    uint32_t tx_frames;             // BSP_CAN_SendDevice成功提交的帧数
+#endif
 } Can_Device;
 
 /* 初始化配置结构体 */
@@ -39,14 +71,75 @@ typedef struct
     uint32_t rx_id;
     CAN_Mode tx_mode;
     CAN_Mode rx_mode;
+    CAN_TxPriority tx_prio;         // CAN_MODE_QUEUE下使用的发送队列，默认CAN_TX_PRIO_HIGH
+    uint32_t id_type;               // CAN_ID_STD(默认)/CAN_ID_EXT，tx_id和rx_id为29位扩展ID时使用CAN_ID_EXT
+    uint16_t rx_rate_hz;            // 预计接收帧率(Hz)，用于均衡FIFO0/FIFO1负载，0按CAN_FILTER_DEFAULT_RATE_HZ
 } Can_Device_Init_Config_s;
 
+/* 软件发送队列中的一帧 */
+typedef struct {
+    CAN_TxHeaderTypeDef header;
+    uint8_t data[8];
+    uint32_t stamp;                 // 入队时刻(CPU周期)
+} CanTxFrame;
+
+/* 一个优先级的软件发送队列 */
+typedef struct {
+    CanTxFrame frames[CAN_TX_QUEUE_SIZE];
+    uint16_t head;                  // 写入计数，自由回绕
+    uint16_t tail;                  // 取出计数，自由回绕
+    uint16_t depth_max;             // 最大排队帧数
+    uint32_t enqueued;              // 入队帧数
+    uint32_t sent;                  // 发送完成帧数
+    uint32_t dropped;               // 队列满丢弃的帧数
+    uint32_t failed;                // 发送被中止的帧数
+    uint64_t latency_total;         // 入队到发送完成的周期数累计
+    uint32_t latency_max;           // 入队到发送完成的最长周期数
+#if CAN_STAT_ENABLE
+    uint32_t wait_count;            // 从队列写入邮箱的帧数
+    uint64_t wait_total;            // 入队到写入邮箱的周期数累计
+    uint32_t wait_max;              // 入队到写入邮箱的最长周期数
+#endif
+} CanTxLane;
+
 /* CAN总线管理结构 */
 typedef struct {
     CAN_HandleTypeDef *hcan;
     Can_Device devices[MAX_DEVICES_PER_CAN_BUS];
-    osal_mutex_t bus_mutex;
     uint8_t device_count;
+    uint8_t filter_banks;       // 本总线当前使用的过滤器组数
+    uint32_t tx_seq[3];         // 各邮箱的提交序号
+    CanTxDoneState tx_done;     // 发送完成状态，只在临界区中修改
+    osal_mailbox_t tx_notify;   // 发布tx_done，唤醒等待本总线发送完成或空闲邮箱的线程
+    CanTxDoneState tx_notify_buf[2];
+    CanTxLane tx_lanes[CAN_TX_PRIO_NUM];    // 软件发送队列
+    uint8_t tx_queued_mask;     // 正在发送队列帧的邮箱
+    uint8_t tx_lane_of[3];      // 各邮箱中队列帧所属的队列
+    uint32_t tx_stamp[3];       // 各邮箱中队列帧的入队时刻
+#if CAN_PROFILE_ENABLE
+    uint32_t rx_irq_count;              // 接收中断次数
+    uint32_t rx_frame_count;            // 接收中断中取出的帧数
+    uint64_t rx_isr_cycles_total;       // 接收中断周期数累计(查找总线、取帧、分发或放入下半部缓冲)
+    uint32_t rx_isr_cycles_max;         // 单次中断平均到每帧的最长周期数
+    uint32_t rx_dispatch_count;         // 分发帧数
+    uint64_t rx_dispatch_cycles_total;  // 分发(查找设备、拷贝数据、设置事件)周期数累计
+    uint32_t rx_dispatch_cycles_max;    // 单帧分发最长周期数
+#endif
+#if CAN_STAT_ENABLE
+    // FIFO0/FIFO1中断优先级不同，接收计数按FIFO分开，互相嵌套也不会丢失
+    uint32_t stat_rx_frames[2];         // 各FIFO接收帧数
+    uint64_t stat_rx_bits[2];           // 各FIFO接收帧不含填充位的位数(含帧间隔)
+    uint64_t stat_rx_stuff[2];          // 各FIFO接收帧的填充位上界
+    uint32_t stat_rx_unmatched;         // 没有设备接收的帧数(过滤器掩码放宽时多收的ID)
+    uint32_t stat_tx_frames;            // 发送成功帧数
+    uint64_t stat_tx_bits;              // 发送帧不含填充位的位数(含帧间隔)
+    uint64_t stat_tx_stuff;             // 发送帧的填充位上界
+    uint32_t stat_tx_errors;            // 发送错误(邮箱报告传输错误)次数
+    uint32_t stat_fifo_overrun[2];      // FIFO0/FIFO1溢出次数
+    uint32_t stat_err_warning;          // 进入错误警告(错误计数>=96)次数
+    uint32_t stat_err_passive;          // 进入错误被动(错误计数>=128)次数
+    uint32_t stat_bus_off;              // 离线次数
+#endif
 } CANBusManager;
 
 typedef struct
@@ -54,6 +147,8 @@ typedef struct
     CAN_HandleTypeDef *can_handle;
     CAN_TxHeaderTypeDef txconf;     // 发送配置
     uint32_t tx_mailbox;            // 发送邮箱号
+    CanTxToken tx_token;            // 发送令牌
+    CAN_TxPriority tx_prio;         // CAN_MODE_QUEUE下使用的发送队列，清零时为CAN_TX_PRIO_HIGH
     uint8_t tx_buff[8];             // 发送缓冲区
 } CanTxMessage_t;
 
@@ -71,18 +166,39 @@ typedef struct
  */
 Can_Device* BSP_CAN_Device_Init(Can_Device_Init_Config_s *config);
 /**
- * @description: 发送CAN设备
+ * @description: 发送CAN设备，tx_mode为CAN_MODE_QUEUE时放入tx_prio对应的发送队列后立即返回
  * @param {Can_Device*} dev
  * @return {osal_status_t}，osal_scucess表示成功，其他表示失败
  */
 osal_status_t BSP_CAN_SendDevice(Can_Device *device);
 /**
- * @description: 发送CAN设备
+ * @description: 发送CAN消息，mode为CAN_MODE_QUEUE时放入tx_message->tx_prio对应的发送队列后立即返回
  * @param {CanTxMessage_t *}，CAN发送消息结构体指针 
- * @param {mode}，发送模式CAN_MODE_BLOCKING/CAN_MODE_IT
+ * @param {mode}，发送模式CAN_MODE_BLOCKING/CAN_MODE_IT/CAN_MODE_QUEUE
  * @return {osal_status_t}，osal_scucess表示成功，其他表示失败
  */
 osal_status_t BSP_CAN_SendMessage(CanTxMessage_t *tx_message,uint8_t mode);
+/**
+ * @description: 把CAN消息放入软件发送队列，立即返回，可在中断中调用
+ * @param {CanTxMessage_t *}，CAN发送消息结构体指针，入队时拷贝
+ * @param {CAN_TxPriority} prio，发送队列优先级
+ * @return {osal_status_t}，OSAL_SUCCESS表示已入队，OSAL_NO_MEMORY表示队列满被丢弃，其他表示失败
+ */
+osal_status_t BSP_CAN_QueueMessage(CanTxMessage_t *tx_message, CAN_TxPriority prio);
+/**
+ * @description: 把CAN消息写入空闲发送邮箱后立即返回，不等待发送完成；邮箱全满时等待本总线的下一次发送完成
+ * @param {CanTxMessage_t *}，CAN发送消息结构体指针，成功时写回tx_mailbox和tx_token
+ * @param {osal_tick_t} timeout，等待空闲邮箱的超时时间
+ * @return {osal_status_t}，OSAL_SUCCESS表示已写入邮箱，OSAL_TIMEOUT表示超时仍无空闲邮箱，其他表示失败
+ */
+osal_status_t BSP_CAN_Submit(CanTxMessage_t *tx_message, osal_tick_t timeout);
+/**
+ * @description: 等待令牌对应的一帧发送完成，只被同一总线同一邮箱的完成唤醒
+ * @param {CanTxToken} token，BSP_CAN_Submit等得到的发送令牌
+ * @param {osal_tick_t} timeout，超时时间
+ * @return {osal_status_t}，OSAL_SUCCESS表示已发出，OSAL_ERROR表示被中止，OSAL_TIMEOUT表示超时
+ */
+osal_status_t BSP_CAN_WaitTx(CanTxToken token, osal_tick_t timeout);
 /**
  * @description: 读取单个CAN设备数据
  * @param {Can_Device*} device
@@ -96,8 +212,8 @@ osal_status_t BSP_CAN_ReadSingleDevice(Can_Device *device,osal_tick_t timeout);
  * @param {Can_Device**} devices - 设备指针数组
  * @param {uint8_t} device_count - 设备数量
  * @param {osal_tick_t} timeout - 超时时间
- * @return {uint32_t}，返回触发事件的设备flag，0表示超时或错误
+ * @return {Can_Device*}，返回收到数据的设备，NULL表示超时或错误
  */
-uint32_t BSP_CAN_ReadMultipleDevice(Can_Device** devices, uint8_t device_count, osal_tick_t timeout);
+Can_Device* BSP_CAN_ReadMultipleDevice(Can_Device** devices, uint8_t device_count, osal_tick_t timeout);
 
 #endif // _BSP_CAN_H_
\ No newline at end of file
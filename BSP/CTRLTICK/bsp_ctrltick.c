@@ -0,0 +1,215 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-17 09:20:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-17 09:20:00
+ * @FilePath: /rm_base/BSP/CTRLTICK/bsp_ctrltick.c
+ * @Description: 硬件定时器控制节拍实现
+ */
+#include "bsp_ctrltick.h"
+#include "shell.h"
+#include <string.h>
+
+#define log_tag "CTRLTICK"
+#include "log.h"
+
+#define CTRLTICK_BASE_US  (1000000U / CTRLTICK_BASE_HZ)
+
+static TIM_HandleTypeDef ctrltick_htim;             // 控制节拍定时器句柄，定时器不在CubeMX中配置
+static CtrlTick_Client ctrltick_clients[CTRLTICK_CLIENT_NUM];
+static uint8_t ctrltick_client_count = 0;
+static uint32_t ctrltick_count = 0;             // 基础节拍计数
+static uint32_t ctrltick_cycles_per_count = 0;  // 定时器每个计数对应的CPU周期数
+static uint8_t ctrltick_started = 0;
+
+static void shell_ctrltick_cmd(int argc, char **argv);
+
+osal_status_t BSP_CtrlTick_Init(void)
+{
+    if (ctrltick_started) {
+        return OSAL_SUCCESS;
+    }
+
+    // 基本定时器挂在APB1上，APB1预分频不为1时定时器时钟倍频
+    uint32_t tim_clock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != 0) {
+        tim_clock *= 2;
+    }
+    uint32_t prescaler = tim_clock / CTRLTICK_COUNT_HZ;
+    uint32_t reload = CTRLTICK_COUNT_HZ / CTRLTICK_BASE_HZ;
+    if (prescaler == 0 || prescaler > 0x10000U || tim_clock % CTRLTICK_COUNT_HZ != 0 ||
+        reload == 0 || reload > 0x10000U || CTRLTICK_COUNT_HZ % CTRLTICK_BASE_HZ != 0) {
+        LOG_ERROR("Timer clock %lu Hz can not generate %d Hz tick", tim_clock, CTRLTICK_BASE_HZ);
+        return OSAL_ERROR;
+    }
+    ctrltick_cycles_per_count = SystemCoreClock / CTRLTICK_COUNT_HZ;
+
+    CTRLTICK_TIM_CLK_ENABLE();
+    ctrltick_htim.Instance = CTRLTICK_TIM;
+    ctrltick_htim.Init.Prescaler = prescaler - 1;
+    ctrltick_htim.Init.CounterMode = TIM_COUNTERMODE_UP;
+    ctrltick_htim.Init.Period = reload - 1;
+    ctrltick_htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    ctrltick_htim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&ctrltick_htim) != HAL_OK) {
+        LOG_ERROR("Failed to init control tick timer");
+        return OSAL_ERROR;
+    }
+    HAL_NVIC_SetPriority(CTRLTICK_IRQn, CTRLTICK_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(CTRLTICK_IRQn);
+    if (HAL_TIM_Base_Start_IT(&ctrltick_htim) != HAL_OK) {
+        LOG_ERROR("Failed to start control tick timer");
+        return OSAL_ERROR;
+    }
+    ctrltick_started = 1;
+
+    shell_register_function("ctrltick", shell_ctrltick_cmd, "Show control tick release statistics");
+    LOG_INFO("Control tick started: %d Hz", CTRLTICK_BASE_HZ);
+    return OSAL_SUCCESS;
+}
+
+CtrlTick_Client* BSP_CtrlTick_Register(CtrlTick_Init_Config *config)
+{
+    if (config == NULL || config->period_us == 0 ||
+        config->period_us % CTRLTICK_BASE_US != 0 || config->phase_us % CTRLTICK_BASE_US != 0 ||
+        config->phase_us >= config->period_us || config->period_us / CTRLTICK_BASE_US > 0xFFFFU) {
+        LOG_ERROR("Invalid control tick config");
+        return NULL;
+    }
+
+    if (ctrltick_client_count >= CTRLTICK_CLIENT_NUM) {
+        LOG_ERROR("Max control tick clients reached: %d", CTRLTICK_CLIENT_NUM);
+        return NULL;
+    }
+
+    CtrlTick_Client* client = &ctrltick_clients[ctrltick_client_count];
+    memset(client, 0, sizeof(CtrlTick_Client));
+    client->name = config->name;
+    client->period_us = config->period_us;
+    client->phase_us = config->phase_us;
+    client->period_ticks = (uint16_t)(config->period_us / CTRLTICK_BASE_US);
+    if (osal_sem_create(&client->release_sem, config->name, 0) != OSAL_SUCCESS) {
+        LOG_ERROR("Failed to create release semaphore");
+        return NULL;
+    }
+
+    // 相位相对全局节拍计数对齐，中断中只做递减
+    osal_critical_state_t crit;
+    osal_enter_critical(&crit);
+    uint32_t phase_ticks = config->phase_us / CTRLTICK_BASE_US;
+    uint32_t pos = ctrltick_count % client->period_ticks;
+    client->countdown = (uint16_t)((phase_ticks + client->period_ticks - pos) % client->period_ticks);
+    ctrltick_client_count++;
+    osal_exit_critical(&crit);
+
+    LOG_INFO("Control tick client registered: %s, period %lu us, phase %lu us",
+             config->name, config->period_us, config->phase_us);
+    return client;
+}
+
+osal_status_t BSP_CtrlTick_Wait(CtrlTick_Client *client, osal_tick_t timeout)
+{
+    if (client == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    osal_status_t status = osal_sem_wait(&client->release_sem, timeout);
+    if (status != OSAL_SUCCESS) {
+        return status;
+    }
+
+    // 唤醒延迟 = 中断进入延迟 + 线程调度延迟
+    uint32_t late = osal_cycle_get() - client->release_cyc;
+    client->pending = 0;
+    client->wakes++;
+    client->late_last = late;
+    client->late_total += late;
+    if (late > client->late_max) {
+        client->late_max = late;
+    }
+    return OSAL_SUCCESS;
+}
+
+void BSP_CtrlTick_Reset_Stats(void)
+{
+    for (uint8_t i = 0; i < ctrltick_client_count; i++) {
+        CtrlTick_Client* client = &ctrltick_clients[i];
+        client->releases = 0;
+        client->overruns = 0;
+        client->late_last = 0;
+        client->late_max = 0;
+        client->late_total = 0;
+        client->wakes = 0;
+    }
+}
+
+void BSP_CtrlTick_PeriodElapsed(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance != CTRLTICK_TIM) {
+        return;
+    }
+
+    // 更新事件之后计数器已走过的值即为中断进入延迟，由此倒推理想释放时刻
+    uint32_t release = osal_cycle_get() - __HAL_TIM_GET_COUNTER(htim) * ctrltick_cycles_per_count;
+    ctrltick_count++;
+
+    for (uint8_t i = 0; i < ctrltick_client_count; i++) {
+        CtrlTick_Client* client = &ctrltick_clients[i];
+        if (client->countdown != 0) {
+            client->countdown--;
+            continue;
+        }
+        client->countdown = client->period_ticks - 1;
+
+        // 线程还没取走上一次释放，不再累积信号量，避免线程追赶式连续执行
+        if (client->pending) {
+            client->overruns++;
+            continue;
+        }
+        client->release_cyc = release;
+        client->pending = 1;
+        client->releases++;
+        osal_sem_post(&client->release_sem);
+    }
+}
+
+#if CTRLTICK_IRQ_HANDLER_ENABLE
+/* CubeMX没有使用控制节拍定时器，由这里提供中断入口 */
+void TIM7_IRQHandler(void)
+{
+    HAL_TIM_IRQHandler(&ctrltick_htim);
+}
+#endif
+
+static void shell_ctrltick_cmd(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        BSP_CtrlTick_Reset_Stats();
+        shell_printf("Control tick statistics cleared.\r\n\r\n");
+        return;
+    }
+
+    shell_printf("Control Tick: base %d Hz (late in CPU cycles)\r\n", CTRLTICK_BASE_HZ);
+    shell_printf("%-16s %-8s %-8s %-10s %-8s %-10s %-10s %-10s\r\n",
+                 "Name", "Period", "Phase", "Releases", "Overrun", "LateLast", "LateAvg", "LateMax");
+    shell_printf("-------------------------------------------------------------------------------------\r\n");
+
+    if (ctrltick_client_count == 0) {
+        shell_printf("No clients registered.\r\n");
+    }
+    for (uint8_t i = 0; i < ctrltick_client_count; i++) {
+        const CtrlTick_Client* client = &ctrltick_clients[i];
+        unsigned long late_avg = client->wakes ? (unsigned long)(client->late_total / client->wakes) : 0;
+        shell_printf("%-16s %-8lu %-8lu %-10lu %-8lu %-10lu %-10lu %-10lu\r\n",
+                     client->name ? client->name : "N/A",
+                     (unsigned long)client->period_us,
+                     (unsigned long)client->phase_us,
+                     (unsigned long)client->releases,
+                     (unsigned long)client->overruns,
+                     (unsigned long)client->late_last,
+                     late_avg,
+                     (unsigned long)client->late_max);
+    }
+    shell_printf("Use 'ctrltick reset' to clear statistics.\r\n");
+    shell_printf("\r\n");
+}
@@ -0,0 +1,80 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-17 09:20:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-17 09:20:00
+ * @FilePath: /rm_base/BSP/CTRLTICK/bsp_ctrltick.h
+ * @Description: 硬件定时器控制节拍，按亚毫秒周期和相位释放控制线程，不依赖RTOS tick
+ */
+#ifndef _BSP_CTRLTICK_H_
+#define _BSP_CTRLTICK_H_
+
+#include "BSP_CONFIG.h"
+#include "osal_def.h"
+#include "tim.h"
+#include <stdint.h>
+
+/* 控制节拍客户端结构体，每个控制线程一个 */
+typedef struct {
+    const char *name;             // 名称
+    uint32_t period_us;           // 周期(us)
+    uint32_t phase_us;            // 相对节拍网格的相位偏移(us)
+    uint16_t period_ticks;        // 周期(基础节拍数)
+    uint16_t countdown;           // 距下一次释放的基础节拍数
+    volatile uint8_t pending;     // 已释放但线程尚未取走
+    volatile uint32_t release_cyc;// 理想释放时刻(DWT周期计数)
+    osal_sem_t release_sem;       // 释放信号量
+
+    /* 统计，延迟单位为CPU周期 */
+    uint32_t releases;            // 释放次数
+    uint32_t overruns;            // 上一次释放尚未被取走时又到期的次数
+    uint32_t late_last;           // 最近一次唤醒延迟
+    uint32_t late_max;            // 最大唤醒延迟
+    uint64_t late_total;          // 累计唤醒延迟
+    uint32_t wakes;               // 唤醒次数
+} CtrlTick_Client;
+
+/* 控制节拍客户端初始化配置 */
+typedef struct {
+    const char *name;             // 名称
+    uint32_t period_us;           // 周期(us)，必须是基础节拍周期的整数倍
+    uint32_t phase_us;            // 相位偏移(us)，必须是基础节拍周期的整数倍且小于周期
+} CtrlTick_Init_Config;
+
+/* 函数声明 */
+
+/**
+ * @description: 初始化控制节拍定时器(CTRLTICK_TIM)，设置为CTRLTICK_BASE_HZ更新中断并启动
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 定时器时钟无法整除出基础节拍
+ */
+osal_status_t BSP_CtrlTick_Init(void);
+
+/**
+ * @description: 注册控制节拍客户端，相位相对全局节拍网格，同周期不同相位的线程不会同时释放
+ * @param {CtrlTick_Init_Config*} config - 初始化配置
+ * @return {CtrlTick_Client*} 成功返回客户端指针，失败返回NULL
+ */
+CtrlTick_Client* BSP_CtrlTick_Register(CtrlTick_Init_Config *config);
+
+/**
+ * @description: 等待下一次释放，在控制线程循环开头调用
+ * @param {CtrlTick_Client*} client - 客户端指针
+ * @param {osal_tick_t} timeout - 超时时间
+ * @return {osal_status_t} OSAL_SUCCESS - 已释放, OSAL_TIMEOUT - 超时, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t BSP_CtrlTick_Wait(CtrlTick_Client *client, osal_tick_t timeout);
+
+/**
+ * @description: 清零所有客户端统计
+ * @return {*}
+ */
+void BSP_CtrlTick_Reset_Stats(void);
+
+/**
+ * @description: 内部函数 - 定时器更新中断处理，由HAL_TIM_PeriodElapsedCallback调用
+ * @param {TIM_HandleTypeDef*} htim - 定时器句柄
+ * @return {*}
+ */
+void BSP_CtrlTick_PeriodElapsed(TIM_HandleTypeDef *htim);
+
+#endif // _BSP_CTRLTICK_H_
@@ -8,12 +8,21 @@
  */
 #include "bsp_gpio.h"
 #include "osal_def.h"
+#include "osal_defer.h"
 #include <string.h>
-#include <stdio.h>
 
 /* 内部GPIO EXTI设备数组 */
 static GPIO_EXTI_Device gpio_exti_devices[GPIO_EXTI_DEVICE_NUM] = {0};
 static uint8_t gpio_exti_device_count = 0;
+/* 所有EXTI设备共用的事件组，每个设备分配一个标志 */
+static osal_wevent_t gpio_exti_event;
+#if BSP_IRQ_DEFER_ENABLE
+/* 有设备的下半部提交失败，等待重新提交 */
+static volatile uint8_t gpio_exti_retry = 0;
+
+static void GPIO_EXTI_Submit(GPIO_EXTI_Device *dev);
+static void GPIO_EXTI_Resubmit(void);
+#endif
 
 GPIO_EXTI_Device* BSP_GPIO_EXTI_Register(GPIO_EXTI_Init_Config *config)
 {
@@ -40,11 +49,14 @@ GPIO_EXTI_Device* BSP_GPIO_EXTI_Register(GPIO_EXTI_Init_Config *config)
     dev->pin = config->pin;
     dev->callback = config->callback;
     dev->is_enabled = 0; // 默认不使能
+    dev->queued = 0;
+    dev->retry = 0;
 
-    // 创建事件
-    char event_name[32];
-    snprintf(event_name, sizeof(event_name), "gpio_exti_%d", config->pin);
-    if (osal_event_create(&dev->exti_event, event_name) != OSAL_SUCCESS) {
+    // 分配事件标志
+    if (gpio_exti_device_count == 0) {
+        osal_wevent_create(&gpio_exti_event, "gpio_exti");
+    }
+    if (osal_wevent_flag_alloc(&gpio_exti_event, &dev->event_index) != OSAL_SUCCESS) {
         return NULL;
     }
 
@@ -81,9 +93,7 @@ osal_status_t BSP_GPIO_EXTI_Wait(GPIO_EXTI_Device* dev, osal_tick_t timeout)
         return OSAL_INVALID_PARAM;
     }
 
-    unsigned int actual_flags;
-    return osal_event_wait(&dev->exti_event,GPIO_EXTI_EVENT, 
-                          OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR ,timeout,&actual_flags);
+    return osal_wevent_wait_flag(&gpio_exti_event, dev->event_index, timeout);
 }
 
 
@@ -106,8 +116,8 @@ void BSP_GPIO_EXTI_Unregister(GPIO_EXTI_Device* dev)
         return; // 未找到设备
     }
 
-    // 删除事件
-    osal_event_delete(&dev->exti_event);
+    // 释放事件标志
+    osal_wevent_flag_free(&gpio_exti_event, dev->event_index);
 
     // 将后面的设备向前移动
     for (int i = index; i < gpio_exti_device_count - 1; i++) {
@@ -120,24 +130,90 @@ void BSP_GPIO_EXTI_Unregister(GPIO_EXTI_Device* dev)
     gpio_exti_device_count--;
 }
 
+/**
+ * @description: 外部中断后续处理，设置事件标志并调用用户回调
+ * @param {void*} arg, GPIO_EXTI_Device指针
+ * @return {*}
+ */
+static void GPIO_EXTI_Process(void *arg)
+{
+    GPIO_EXTI_Device* dev = (GPIO_EXTI_Device*)arg;
+
+#if BSP_IRQ_DEFER_ENABLE
+    // 先清除标志再处理，之后到达的中断会重新提交下半部
+    __atomic_store_n(&dev->queued, 0, __ATOMIC_SEQ_CST);
+#endif
+
+    // 设置事件标志
+    osal_wevent_set_flag(&gpio_exti_event, dev->event_index);
+
+    // 调用用户回调函数
+    if (dev->callback != NULL) {
+        dev->callback();
+    }
+
+#if BSP_IRQ_DEFER_ENABLE
+    // 队列已腾出空间，补交之前提交失败的设备
+    GPIO_EXTI_Resubmit();
+#endif
+}
+
+#if BSP_IRQ_DEFER_ENABLE
+/**
+ * @description: 提交设备的下半部，同一设备未执行前只提交一次
+ * @param {GPIO_EXTI_Device*} dev
+ * @return {*}
+ */
+static void GPIO_EXTI_Submit(GPIO_EXTI_Device *dev)
+{
+    if (__atomic_exchange_n(&dev->queued, 1, __ATOMIC_SEQ_CST) != 0) {
+        return;
+    }
+    if (osal_defer(GPIO_EXTI_Process, dev) != OSAL_SUCCESS) {
+        // 队列满或执行器未初始化，回调不能在中断中执行，记下后由下一次中断或下半部重新提交
+        dev->queued = 0;
+        dev->retry = 1;
+        gpio_exti_retry = 1;
+    }
+}
+
+/**
+ * @description: 重新提交之前提交失败的设备
+ * @return {*}
+ */
+static void GPIO_EXTI_Resubmit(void)
+{
+    if (!gpio_exti_retry) {
+        return;
+    }
+    gpio_exti_retry = 0;
+    for (int i = 0; i < gpio_exti_device_count; i++) {
+        GPIO_EXTI_Device *dev = &gpio_exti_devices[i];
+        if (__atomic_exchange_n(&dev->retry, 0, __ATOMIC_SEQ_CST) != 0 && dev->is_enabled) {
+            GPIO_EXTI_Submit(dev);
+        }
+    }
+}
+#endif
+
 /**
  * @description: 内部函数 - 处理GPIO EXTI中断，由HAL回调调用
  * @param {uint16_t} pin - GPIO引脚
  */
 void BSP_GPIO_EXTI_Handle_IRQ(uint16_t pin)
 {
+#if BSP_IRQ_DEFER_ENABLE
+    GPIO_EXTI_Resubmit();
+#endif
     // 查找对应的设备
     for (int i = 0; i < gpio_exti_device_count; i++) {
         if (gpio_exti_devices[i].pin == pin && gpio_exti_devices[i].is_enabled) {
-            GPIO_EXTI_Device* dev = &gpio_exti_devices[i];
-            
-            // 设置事件标志
-            osal_event_set(&dev->exti_event, GPIO_EXTI_EVENT);
-            
-            // 调用用户回调函数
-            if (dev->callback != NULL) {
-                dev->callback();
-            }
+#if BSP_IRQ_DEFER_ENABLE
+            // 中断中只入队，事件和回调始终在工作线程中处理
+            GPIO_EXTI_Submit(&gpio_exti_devices[i]);
+#else
+            GPIO_EXTI_Process(&gpio_exti_devices[i]);
+#endif
             break;
         }
     }
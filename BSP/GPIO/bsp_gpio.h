@@ -11,19 +11,18 @@
 
 #include "BSP_CONFIG.h"
 #include "osal_def.h"
+#include "osal_wevent.h"
 #include <stdint.h>
 
 
-/* 事件定义 */
-#define GPIO_EXTI_EVENT (0x01 << 0)
-
-
 /* GPIO EXTI设备结构体 */
 typedef struct {
     uint16_t pin;               // GPIO引脚
     void (*callback)();         // 用户回调函数
     uint8_t is_enabled;         // 中断使能状态
-    osal_event_t exti_event;    // EXTI事件标志
+    uint16_t event_index;       // EXTI事件在GPIO宽事件组中的标志
+    volatile uint8_t queued;    // 已提交下半部尚未执行
+    volatile uint8_t retry;     // 下半部提交失败，等待重新提交
 } GPIO_EXTI_Device;
 
 /* GPIO EXTI设备结构体 */
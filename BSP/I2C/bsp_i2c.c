@@ -15,9 +15,13 @@
 #include "log.h"
 
 static I2C_Bus_Manager i2c_buses[I2C_BUS_NUM] = {0};
+// 所有I2C总线共用的事件组，各总线分配自己的标志
+static osal_wevent_t i2c_event;
 
 // 内部函数声明
 static I2C_Bus_Manager* BSP_I2C_Get_Bus_Manager(I2C_HandleTypeDef* hi2c);
+static osal_status_t BSP_I2C_Wait_Event(I2C_Bus_Manager* bus_manager, uint32_t events);
+static void BSP_I2C_Set_Event(I2C_HandleTypeDef* hi2c, uint32_t event);
 
 I2C_Device* BSP_I2C_Device_Init(I2C_Device_Init_Config* config)
 {
@@ -44,21 +48,31 @@ I2C_Device* BSP_I2C_Device_Init(I2C_Device_Init_Config* config)
         bus_manager->hi2c = config->hi2c;
         bus_manager->device_count = 0;
         
-        // 创建总线互斥锁和事件
+        // 创建总线互斥锁，分配总线事件标志
+        static uint8_t event_created = 0;
         static char mutex_name[32];
-        static char event_name[32];
         snprintf(mutex_name, sizeof(mutex_name), "i2c_mutex_%p", (void*)config->hi2c);
-        snprintf(event_name, sizeof(event_name), "i2c_event_%p", (void*)config->hi2c);
         
         if (osal_mutex_create(&bus_manager->bus_mutex, mutex_name) != OSAL_SUCCESS) {
             LOG_ERROR("Failed to create bus mutex");
+            bus_manager->hi2c = NULL;
             return NULL;
         }
         
-        if (osal_event_create(&bus_manager->bus_event, event_name) != OSAL_SUCCESS) {
-            LOG_ERROR("Failed to create bus event");
-            osal_mutex_delete(&bus_manager->bus_mutex);
-            return NULL;
+        if (!event_created) {
+            osal_wevent_create(&i2c_event, "i2c_event");
+            event_created = 1;
+        }
+        for (int i = 0; i < I2C_EVENT_NUM; i++) {
+            if (osal_wevent_flag_alloc(&i2c_event, &bus_manager->event_index[i]) != OSAL_SUCCESS) {
+                LOG_ERROR("Failed to allocate bus event flag");
+                while (i-- > 0) {
+                    osal_wevent_flag_free(&i2c_event, bus_manager->event_index[i]);
+                }
+                osal_mutex_delete(&bus_manager->bus_mutex);
+                bus_manager->hi2c = NULL;
+                return NULL;
+            }
         }
     }
 
@@ -106,7 +120,9 @@ void BSP_I2C_Device_DeInit(I2C_Device* dev)
     // 如果没有设备了，清理总线管理器资源
     if (bus_manager->device_count == 0) {
         osal_mutex_delete(&bus_manager->bus_mutex);
-        osal_event_delete(&bus_manager->bus_event);
+        for (int i = 0; i < I2C_EVENT_NUM; i++) {
+            osal_wevent_flag_free(&i2c_event, bus_manager->event_index[i]);
+        }
         memset(bus_manager, 0, sizeof(I2C_Bus_Manager));
     }
 }
@@ -149,17 +165,7 @@ osal_status_t BSP_I2C_Transmit(I2C_Device* dev, uint8_t* tx_data, uint16_t size)
             hal_status = HAL_I2C_Master_Transmit_IT(dev->hi2c, dev->dev_address, tx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                           I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR,
-                                                           OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                           OSAL_WAIT_FOREVER,
-                                                           &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & I2C_EVENT_ERROR) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -169,17 +175,7 @@ osal_status_t BSP_I2C_Transmit(I2C_Device* dev, uint8_t* tx_data, uint16_t size)
             hal_status = HAL_I2C_Master_Transmit_DMA(dev->hi2c, dev->dev_address, tx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                           I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR,
-                                                           OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                           OSAL_WAIT_FOREVER,
-                                                           &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & I2C_EVENT_ERROR) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -235,17 +231,7 @@ osal_status_t BSP_I2C_Receive(I2C_Device* dev, uint8_t* rx_data, uint16_t size)
             hal_status = HAL_I2C_Master_Receive_IT(dev->hi2c, dev->dev_address, rx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                           I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR,
-                                                           OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                           OSAL_WAIT_FOREVER,
-                                                           &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & I2C_EVENT_ERROR) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -255,17 +241,7 @@ osal_status_t BSP_I2C_Receive(I2C_Device* dev, uint8_t* rx_data, uint16_t size)
             hal_status = HAL_I2C_Master_Receive_DMA(dev->hi2c, dev->dev_address, rx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                           I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR,
-                                                           OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                           OSAL_WAIT_FOREVER,
-                                                           &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & I2C_EVENT_ERROR) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -326,17 +302,7 @@ osal_status_t BSP_I2C_Mem_Write_Read(I2C_Device* dev, uint16_t mem_address,
                                                  mem_add_size, data, size);
                 if (hal_status == HAL_OK) {
                     // 等待传输完成或出错
-                    unsigned int actual_flags;
-                    osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                               I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR,
-                                                               OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                               OSAL_WAIT_FOREVER,
-                                                               &actual_flags);
-                    if (wait_status != OSAL_SUCCESS) {
-                        osal_status = OSAL_ERROR;
-                    } else if (actual_flags & I2C_EVENT_ERROR) {
-                        osal_status = OSAL_ERROR;
-                    }
+                    osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR);
                 } else {
                     osal_status = OSAL_ERROR;
                 }
@@ -347,17 +313,7 @@ osal_status_t BSP_I2C_Mem_Write_Read(I2C_Device* dev, uint16_t mem_address,
                                                   mem_add_size, data, size);
                 if (hal_status == HAL_OK) {
                     // 等待传输完成或出错
-                    unsigned int actual_flags;
-                    osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                               I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR,
-                                                               OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                               OSAL_WAIT_FOREVER,
-                                                               &actual_flags);
-                    if (wait_status != OSAL_SUCCESS) {
-                        osal_status = OSAL_ERROR;
-                    } else if (actual_flags & I2C_EVENT_ERROR) {
-                        osal_status = OSAL_ERROR;
-                    }
+                    osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_TX_COMPLETE | I2C_EVENT_ERROR);
                 } else {
                     osal_status = OSAL_ERROR;
                 }
@@ -384,17 +340,7 @@ osal_status_t BSP_I2C_Mem_Write_Read(I2C_Device* dev, uint16_t mem_address,
                                                 mem_add_size, data, size);
                 if (hal_status == HAL_OK) {
                     // 等待传输完成或出错
-                    unsigned int actual_flags;
-                    osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                               I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR,
-                                                               OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                               OSAL_WAIT_FOREVER,
-                                                               &actual_flags);
-                    if (wait_status != OSAL_SUCCESS) {
-                        osal_status = OSAL_ERROR;
-                    } else if (actual_flags & I2C_EVENT_ERROR) {
-                        osal_status = OSAL_ERROR;
-                    }
+                    osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR);
                 } else {
                     osal_status = OSAL_ERROR;
                 }
@@ -405,17 +351,7 @@ osal_status_t BSP_I2C_Mem_Write_Read(I2C_Device* dev, uint16_t mem_address,
                                                  mem_add_size, data, size);
                 if (hal_status == HAL_OK) {
                     // 等待传输完成或出错
-                    unsigned int actual_flags;
-                    osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                               I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR,
-                                                               OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                               OSAL_WAIT_FOREVER,
-                                                               &actual_flags);
-                    if (wait_status != OSAL_SUCCESS) {
-                        osal_status = OSAL_ERROR;
-                    } else if (actual_flags & I2C_EVENT_ERROR) {
-                        osal_status = OSAL_ERROR;
-                    }
+                    osal_status = BSP_I2C_Wait_Event(bus_manager, I2C_EVENT_RX_COMPLETE | I2C_EVENT_ERROR);
                 } else {
                     osal_status = OSAL_ERROR;
                 }
@@ -454,46 +390,73 @@ static I2C_Bus_Manager* BSP_I2C_Get_Bus_Manager(I2C_HandleTypeDef* hi2c)
     return NULL;
 }
 
-/* 中断回调函数 */
-void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+/**
+ * @description: 等待总线事件，任一事件发生即返回并清除
+ * @param {I2C_Bus_Manager*} bus_manager，总线管理器
+ * @param {uint32_t} events，I2C_EVENT_xxx组合
+ * @return {osal_status_t}，发生I2C_EVENT_ERROR时返回OSAL_ERROR
+ */
+static osal_status_t BSP_I2C_Wait_Event(I2C_Bus_Manager* bus_manager, uint32_t events)
+{
+    osal_wevent_mask_t mask, actual;
+
+    osal_wevent_mask_zero(&mask);
+    for (int i = 0; i < I2C_EVENT_NUM; i++) {
+        if (events & (1U << i)) {
+            osal_wevent_mask_add(&mask, bus_manager->event_index[i]);
+        }
+    }
+    if (osal_wevent_wait(&i2c_event, &mask, OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
+                         OSAL_WAIT_FOREVER, &actual) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    if (osal_wevent_mask_test(&actual, bus_manager->event_index[__builtin_ctz(I2C_EVENT_ERROR)])) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+/**
+ * @description: 设置总线事件，在中断回调中调用
+ * @param {I2C_HandleTypeDef*} hi2c，I2C句柄
+ * @param {uint32_t} event，I2C_EVENT_xxx中的一个
+ * @return {*}
+ */
+static void BSP_I2C_Set_Event(I2C_HandleTypeDef* hi2c, uint32_t event)
 {
     I2C_Bus_Manager* bus_manager = BSP_I2C_Get_Bus_Manager(hi2c);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, I2C_EVENT_TX_COMPLETE);
+    // 未初始化的总线没有分配事件标志
+    if (bus_manager == NULL || bus_manager->hi2c != hi2c) {
+        return;
     }
+    osal_wevent_set_flag(&i2c_event, bus_manager->event_index[__builtin_ctz(event)]);
+}
+
+/* 中断回调函数 */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    BSP_I2C_Set_Event(hi2c, I2C_EVENT_TX_COMPLETE);
 }
 
 
 void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-    I2C_Bus_Manager* bus_manager = BSP_I2C_Get_Bus_Manager(hi2c);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, I2C_EVENT_RX_COMPLETE);
-    }
+    BSP_I2C_Set_Event(hi2c, I2C_EVENT_RX_COMPLETE);
 }
 
 
 void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-    I2C_Bus_Manager* bus_manager = BSP_I2C_Get_Bus_Manager(hi2c);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, I2C_EVENT_TX_COMPLETE);
-    }
+    BSP_I2C_Set_Event(hi2c, I2C_EVENT_TX_COMPLETE);
 }
 
 void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-    I2C_Bus_Manager* bus_manager = BSP_I2C_Get_Bus_Manager(hi2c);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, I2C_EVENT_RX_COMPLETE);
-    }
+    BSP_I2C_Set_Event(hi2c, I2C_EVENT_RX_COMPLETE);
 }
 
 
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
 {
-    I2C_Bus_Manager* bus_manager = BSP_I2C_Get_Bus_Manager(hi2c);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, I2C_EVENT_ERROR);
-    }
+    BSP_I2C_Set_Event(hi2c, I2C_EVENT_ERROR);
 }
\ No newline at end of file
@@ -12,11 +12,13 @@
 #include "BSP_CONFIG.h"
 #include "i2c.h"
 #include "osal_def.h"
+#include "osal_wevent.h"
 
-/* I2C 事件定义 */
+/* I2C 事件定义，每条总线在I2C宽事件组中为每个事件分配一个标志 */
 #define I2C_EVENT_TX_COMPLETE (0x01 << 0)
 #define I2C_EVENT_RX_COMPLETE (0x01 << 1)
 #define I2C_EVENT_ERROR       (0x01 << 2)
+#define I2C_EVENT_NUM         3
 
 /* 传输模式枚举 */
 typedef enum {
@@ -46,7 +48,7 @@ typedef struct {
     I2C_HandleTypeDef* hi2c;                      // I2C句柄
     I2C_Device devices[MAX_DEVICES_PER_I2C_BUS];  // 设备列表
     osal_mutex_t bus_mutex;                       // 互斥锁
-    osal_event_t bus_event;                       // 事件通知
+    uint16_t event_index[I2C_EVENT_NUM];          // 总线事件在I2C宽事件组中的标志
     uint8_t device_count;                         // 当前设备数量
     I2C_Device* active_dev;                       // 当前活动设备
 } I2C_Bus_Manager;
@@ -1,6 +1,7 @@
 #include "bsp_spi.h"
 #include "gpio.h"
 #include "osal_def.h"
+#include "shell.h"
 #include "string.h"
 #include <stdio.h>
 
@@ -9,11 +10,18 @@
 
 // SPI总线管理器数组
 static SPI_Bus_Manager spi_buses[SPI_BUS_NUM];
+// 所有SPI总线共用的事件组，各总线分配自己的标志
+static osal_wevent_t spi_event;
 
 // 内部函数声明
 static SPI_Bus_Manager* BSP_SPI_Get_Bus_Manager(SPI_HandleTypeDef* hspi);
 static void BSP_SPI_Select_Device(SPI_Device* dev);
 static void BSP_SPI_Deselect_Device(SPI_Device* dev);
+static osal_status_t BSP_SPI_Wait_Event(SPI_Bus_Manager* bus_manager, uint32_t events);
+static void BSP_SPI_Set_Event(SPI_HandleTypeDef* hspi, uint32_t event);
+#if SPI_PROFILE_ENABLE
+static void shell_spi_cmd(int argc, char **argv);
+#endif
 
 SPI_Device* BSP_SPI_Device_Init(SPI_Device_Init_Config* config)
 {
@@ -40,22 +48,42 @@ SPI_Device* BSP_SPI_Device_Init(SPI_Device_Init_Config* config)
         bus_manager->hspi = config->hspi;
         bus_manager->device_count = 0;
         
-        // 创建总线事件和互斥锁
-        static char event_name[32];
+        // 分配总线事件标志，创建互斥锁
+        static uint8_t event_created = 0;
         static char mutex_name[32];
-        snprintf(event_name, sizeof(event_name), "spi_event_%p", (void*)config->hspi);
         snprintf(mutex_name, sizeof(mutex_name), "spi_mutex_%p", (void*)config->hspi);
-        
-        if (osal_event_create(&bus_manager->bus_event, event_name) != OSAL_SUCCESS) {
-            LOG_ERROR("Failed to create bus event");
-            return NULL;
+
+        if (!event_created) {
+            osal_wevent_create(&spi_event, "spi_event");
+            event_created = 1;
+        }
+        for (int i = 0; i < SPI_EVENT_NUM; i++) {
+            if (osal_wevent_flag_alloc(&spi_event, &bus_manager->event_index[i]) != OSAL_SUCCESS) {
+                LOG_ERROR("Failed to allocate bus event flag");
+                while (i-- > 0) {
+                    osal_wevent_flag_free(&spi_event, bus_manager->event_index[i]);
+                }
+                bus_manager->hspi = NULL;
+                return NULL;
+            }
         }
         
-        if (osal_mutex_create(&bus_manager->bus_mutex, mutex_name) != OSAL_SUCCESS) {
+        if (osal_hmutex_create(&bus_manager->bus_mutex, mutex_name) != OSAL_SUCCESS) {
             LOG_ERROR("Failed to create bus mutex");
-            osal_event_delete(&bus_manager->bus_event);
+            for (int i = 0; i < SPI_EVENT_NUM; i++) {
+                osal_wevent_flag_free(&spi_event, bus_manager->event_index[i]);
+            }
+            bus_manager->hspi = NULL;
             return NULL;
         }
+
+#if SPI_PROFILE_ENABLE
+        static uint8_t shell_registered = 0;
+        if (!shell_registered) {
+            shell_register_function("spi", shell_spi_cmd, "Show SPI TransReceive cycle statistics");
+            shell_registered = 1;
+        }
+#endif
     }
 
     // 添加新设备
@@ -107,8 +135,10 @@ void BSP_SPI_Device_DeInit(SPI_Device* dev)
 
     // 如果没有设备了，清理总线管理器资源
     if (bus_manager->device_count == 0) {
-        osal_event_delete(&bus_manager->bus_event);
-        osal_mutex_delete(&bus_manager->bus_mutex);
+        for (int i = 0; i < SPI_EVENT_NUM; i++) {
+            osal_wevent_flag_free(&spi_event, bus_manager->event_index[i]);
+        }
+        osal_hmutex_delete(&bus_manager->bus_mutex);
         memset(bus_manager, 0, sizeof(SPI_Bus_Manager));
     }
 }
@@ -128,8 +158,12 @@ osal_status_t BSP_SPI_TransReceive(SPI_Device* dev, const uint8_t* tx_data, uint
         return OSAL_ERROR;
     }
 
+#if SPI_PROFILE_ENABLE
+    uint32_t trx_start = osal_cycle_get();
+#endif
+
     // 等待获取总线使用权
-    if (osal_mutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
+    if (osal_hmutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
         LOG_ERROR("Failed to acquire bus mutex");
         return OSAL_ERROR;
     }
@@ -143,6 +177,11 @@ osal_status_t BSP_SPI_TransReceive(SPI_Device* dev, const uint8_t* tx_data, uint
     HAL_StatusTypeDef hal_status;
     osal_status_t osal_status = OSAL_SUCCESS;
 
+#if SPI_PROFILE_ENABLE
+    // 传输窗口：从启动HAL传输到传输完成，中断/DMA模式下包含等待完成事件
+    uint32_t xfer_start = osal_cycle_get();
+#endif
+
     // 根据配置的模式执行传输
     switch (dev->tx_mode) {
         case SPI_MODE_BLOCKING:
@@ -156,17 +195,7 @@ osal_status_t BSP_SPI_TransReceive(SPI_Device* dev, const uint8_t* tx_data, uint
             hal_status = HAL_SPI_TransmitReceive_IT(dev->hspi, (uint8_t*)tx_data, rx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                            SPI_EVENT_TX_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT,
-                                                            OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                            OSAL_WAIT_FOREVER,
-                                                            &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & SPI_EVENT_ERR_EVENT) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_SPI_Wait_Event(bus_manager, SPI_EVENT_TX_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -176,17 +205,7 @@ osal_status_t BSP_SPI_TransReceive(SPI_Device* dev, const uint8_t* tx_data, uint
             hal_status = HAL_SPI_TransmitReceive_DMA(dev->hspi, (uint8_t*)tx_data, rx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                            SPI_EVENT_TX_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT,
-                                                            OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                            OSAL_WAIT_FOREVER,
-                                                            &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & SPI_EVENT_ERR_EVENT) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_SPI_Wait_Event(bus_manager, SPI_EVENT_TX_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -198,11 +217,30 @@ osal_status_t BSP_SPI_TransReceive(SPI_Device* dev, const uint8_t* tx_data, uint
             break;
     }
 
+#if SPI_PROFILE_ENABLE
+    uint32_t xfer_cycles = osal_cycle_get() - xfer_start;
+#endif
+
     // 取消选中设备
     BSP_SPI_Deselect_Device(dev);
 
     // 释放总线使用权
-    osal_mutex_unlock(&bus_manager->bus_mutex);
+    osal_hmutex_unlock(&bus_manager->bus_mutex);
+
+#if SPI_PROFILE_ENABLE
+    // 统计只在持有总线的线程退出后更新，多线程同时访问同一总线时可能少量失真，仅用于性能对比
+    uint32_t trx_cycles = osal_cycle_get() - trx_start;
+    uint32_t overhead = trx_cycles - xfer_cycles;
+    bus_manager->trx_count++;
+    bus_manager->trx_cycles_total += trx_cycles;
+    bus_manager->trx_overhead_total += overhead;
+    if (trx_cycles > bus_manager->trx_cycles_max) {
+        bus_manager->trx_cycles_max = trx_cycles;
+    }
+    if (overhead > bus_manager->trx_overhead_max) {
+        bus_manager->trx_overhead_max = overhead;
+    }
+#endif
 
     return osal_status;
 }
@@ -221,7 +259,7 @@ osal_status_t BSP_SPI_Transmit(SPI_Device* dev, const uint8_t* tx_data, uint16_t
     }
 
     // 等待获取总线使用权
-    if (osal_mutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
+    if (osal_hmutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
         LOG_ERROR("Failed to acquire bus mutex");
         return OSAL_ERROR;
     }
@@ -248,17 +286,7 @@ osal_status_t BSP_SPI_Transmit(SPI_Device* dev, const uint8_t* tx_data, uint16_t
             hal_status = HAL_SPI_Transmit_IT(dev->hspi, (uint8_t*)tx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                            SPI_EVENT_TX_DONE_EVENT | SPI_EVENT_ERR_EVENT,
-                                                            OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                            OSAL_WAIT_FOREVER,
-                                                            &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & SPI_EVENT_ERR_EVENT) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_SPI_Wait_Event(bus_manager, SPI_EVENT_TX_DONE_EVENT | SPI_EVENT_ERR_EVENT);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -268,17 +296,7 @@ osal_status_t BSP_SPI_Transmit(SPI_Device* dev, const uint8_t* tx_data, uint16_t
             hal_status = HAL_SPI_Transmit_DMA(dev->hspi, (uint8_t*)tx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                            SPI_EVENT_TX_DONE_EVENT | SPI_EVENT_ERR_EVENT,
-                                                            OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                            OSAL_WAIT_FOREVER,
-                                                            &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & SPI_EVENT_ERR_EVENT) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_SPI_Wait_Event(bus_manager, SPI_EVENT_TX_DONE_EVENT | SPI_EVENT_ERR_EVENT);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -294,7 +312,7 @@ osal_status_t BSP_SPI_Transmit(SPI_Device* dev, const uint8_t* tx_data, uint16_t
     BSP_SPI_Deselect_Device(dev);
 
     // 释放总线使用权
-    osal_mutex_unlock(&bus_manager->bus_mutex);
+    osal_hmutex_unlock(&bus_manager->bus_mutex);
 
     return osal_status;
 }
@@ -314,7 +332,7 @@ osal_status_t BSP_SPI_Receive(SPI_Device* dev, uint8_t* rx_data, uint16_t size)
     }
 
     // 等待获取总线使用权
-    if (osal_mutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
+    if (osal_hmutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
         LOG_ERROR("Failed to acquire bus mutex");
         return OSAL_ERROR;
     }
@@ -341,17 +359,7 @@ osal_status_t BSP_SPI_Receive(SPI_Device* dev, uint8_t* rx_data, uint16_t size)
             hal_status = HAL_SPI_Receive_IT(dev->hspi, rx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                            SPI_EVENT_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT,
-                                                            OSAL_EVENT_WAIT_FLAG_OR| OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                            OSAL_WAIT_FOREVER,
-                                                            &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & SPI_EVENT_ERR_EVENT) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_SPI_Wait_Event(bus_manager, SPI_EVENT_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -361,17 +369,7 @@ osal_status_t BSP_SPI_Receive(SPI_Device* dev, uint8_t* rx_data, uint16_t size)
             hal_status = HAL_SPI_Receive_DMA(dev->hspi, rx_data, size);
             if (hal_status == HAL_OK) {
                 // 等待传输完成或出错
-                unsigned int actual_flags;
-                osal_status_t wait_status = osal_event_wait(&bus_manager->bus_event, 
-                                                            SPI_EVENT_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT,
-                                                            OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
-                                                            OSAL_WAIT_FOREVER,
-                                                            &actual_flags);
-                if (wait_status != OSAL_SUCCESS) {
-                    osal_status = OSAL_ERROR;
-                } else if (actual_flags & SPI_EVENT_ERR_EVENT) {
-                    osal_status = OSAL_ERROR;
-                }
+                osal_status = BSP_SPI_Wait_Event(bus_manager, SPI_EVENT_RX_DONE_EVENT | SPI_EVENT_ERR_EVENT);
             } else {
                 osal_status = OSAL_ERROR;
             }
@@ -387,7 +385,7 @@ osal_status_t BSP_SPI_Receive(SPI_Device* dev, uint8_t* rx_data, uint16_t size)
     BSP_SPI_Deselect_Device(dev);
 
     // 释放总线使用权
-    osal_mutex_unlock(&bus_manager->bus_mutex);
+    osal_hmutex_unlock(&bus_manager->bus_mutex);
 
     return osal_status;
 }
@@ -409,7 +407,7 @@ osal_status_t BSP_SPI_TransAndTrans(SPI_Device* dev, const uint8_t* tx_data1, ui
     }
 
     // 等待获取总线使用权
-    if (osal_mutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
+    if (osal_hmutex_lock(&bus_manager->bus_mutex, OSAL_WAIT_FOREVER) != OSAL_SUCCESS) {
         LOG_ERROR("Failed to acquire bus mutex");
         return OSAL_ERROR;
     }
@@ -436,7 +434,7 @@ osal_status_t BSP_SPI_TransAndTrans(SPI_Device* dev, const uint8_t* tx_data1, ui
     BSP_SPI_Deselect_Device(dev);
 
     // 释放总线使用权
-    osal_mutex_unlock(&bus_manager->bus_mutex);
+    osal_hmutex_unlock(&bus_manager->bus_mutex);
 
     // 检查结果
     if (hal_status1 != HAL_OK || hal_status2 != HAL_OK) {
@@ -489,35 +487,102 @@ static void BSP_SPI_Deselect_Device(SPI_Device* dev)
     }
 }
 
-/*  SPI回调函数  */
-void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+/**
+ * @description: 等待总线事件，任一事件发生即返回并清除
+ * @param {SPI_Bus_Manager*} bus_manager，总线管理器
+ * @param {uint32_t} events，SPI_EVENT_xxx组合
+ * @return {osal_status_t}，发生SPI_EVENT_ERR_EVENT时返回OSAL_ERROR
+ */
+static osal_status_t BSP_SPI_Wait_Event(SPI_Bus_Manager* bus_manager, uint32_t events)
 {
-    SPI_Bus_Manager* bus_manager = BSP_SPI_Get_Bus_Manager(hspi);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, SPI_EVENT_TX_DONE_EVENT);
+    osal_wevent_mask_t mask, actual;
+
+    osal_wevent_mask_zero(&mask);
+    for (int i = 0; i < SPI_EVENT_NUM; i++) {
+        if (events & (1U << i)) {
+            osal_wevent_mask_add(&mask, bus_manager->event_index[i]);
+        }
+    }
+    if (osal_wevent_wait(&spi_event, &mask, OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
+                         OSAL_WAIT_FOREVER, &actual) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    if (osal_wevent_mask_test(&actual, bus_manager->event_index[__builtin_ctz(SPI_EVENT_ERR_EVENT)])) {
+        return OSAL_ERROR;
     }
+    return OSAL_SUCCESS;
 }
 
-void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+/**
+ * @description: 设置总线事件，在中断回调中调用
+ * @param {SPI_HandleTypeDef*} hspi，SPI句柄
+ * @param {uint32_t} event，SPI_EVENT_xxx中的一个
+ * @return {*}
+ */
+static void BSP_SPI_Set_Event(SPI_HandleTypeDef* hspi, uint32_t event)
 {
     SPI_Bus_Manager* bus_manager = BSP_SPI_Get_Bus_Manager(hspi);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, SPI_EVENT_RX_DONE_EVENT);
+    // 未初始化的总线没有分配事件标志
+    if (bus_manager == NULL || bus_manager->hspi != hspi) {
+        return;
     }
+    osal_wevent_set_flag(&spi_event, bus_manager->event_index[__builtin_ctz(event)]);
+}
+
+/*  SPI回调函数  */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    BSP_SPI_Set_Event(hspi, SPI_EVENT_TX_DONE_EVENT);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    BSP_SPI_Set_Event(hspi, SPI_EVENT_RX_DONE_EVENT);
 }
 
 void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
 {
-    SPI_Bus_Manager* bus_manager = BSP_SPI_Get_Bus_Manager(hspi);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, SPI_EVENT_TX_RX_DONE_EVENT);
-    }
+    BSP_SPI_Set_Event(hspi, SPI_EVENT_TX_RX_DONE_EVENT);
 }
 
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
 {
-    SPI_Bus_Manager* bus_manager = BSP_SPI_Get_Bus_Manager(hspi);
-    if (bus_manager != NULL) {
-        osal_event_set(&bus_manager->bus_event, SPI_EVENT_ERR_EVENT);
+    BSP_SPI_Set_Event(hspi, SPI_EVENT_ERR_EVENT);
+}
+
+#if SPI_PROFILE_ENABLE
+static void shell_spi_cmd(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        for (int i = 0; i < SPI_BUS_NUM; i++) {
+            spi_buses[i].trx_count = 0;
+            spi_buses[i].trx_cycles_max = 0;
+            spi_buses[i].trx_cycles_total = 0;
+            spi_buses[i].trx_overhead_max = 0;
+            spi_buses[i].trx_overhead_total = 0;
+        }
+        shell_printf("SPI statistics cleared.\r\n\r\n");
+        return;
     }
-}
\ No newline at end of file
+
+    shell_printf("SPI TransReceive (CPU cycles, OSAL inline %s):\r\n", OSAL_INLINE_ENABLE ? "on" : "off");
+    shell_printf("%-12s %-10s %-10s %-10s %-12s %-12s\r\n", "Bus", "Calls", "Avg", "Max", "OverheadAvg", "OverheadMax");
+    shell_printf("-------------------------------------------------------------------------\r\n");
+    for (int i = 0; i < SPI_BUS_NUM; i++) {
+        SPI_Bus_Manager *bus = &spi_buses[i];
+        if (bus->hspi == NULL) {
+            continue;
+        }
+        shell_printf("%-12p %-10lu %-10lu %-10lu %-12lu %-12lu\r\n",
+                     (void *)bus->hspi->Instance,
+                     (unsigned long)bus->trx_count,
+                     bus->trx_count ? (unsigned long)(bus->trx_cycles_total / bus->trx_count) : 0UL,
+                     (unsigned long)bus->trx_cycles_max,
+                     bus->trx_count ? (unsigned long)(bus->trx_overhead_total / bus->trx_count) : 0UL,
+                     (unsigned long)bus->trx_overhead_max);
+    }
+    shell_printf("Overhead = call total - transfer window (lock, chip select, unlock, bookkeeping).\r\n");
+    shell_printf("Use 'spi reset' to clear statistics.\r\n");
+    shell_printf("\r\n");
+}
+#endif
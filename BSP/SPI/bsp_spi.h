@@ -3,14 +3,17 @@
 
 #include "BSP_CONFIG.h"
 #include "osal_def.h"
+#include "osal_hmutex.h"
+#include "osal_wevent.h"
 #include "spi.h"
 
 
-/* SPI事件定义 */
+/* SPI事件定义，每条总线在SPI宽事件组中为每个事件分配一个标志 */
 #define SPI_EVENT_TX_DONE_EVENT    (0x01 << 0)
 #define SPI_EVENT_RX_DONE_EVENT    (0x01 << 1)
 #define SPI_EVENT_TX_RX_DONE_EVENT (0x01 << 2)
 #define SPI_EVENT_ERR_EVENT        (0x01 << 3)
+#define SPI_EVENT_NUM              4
 
 /* 传输模式枚举 */
 typedef enum {
@@ -42,10 +45,17 @@ typedef struct {
 typedef struct {
     SPI_HandleTypeDef* hspi;                    // SPI句柄
     SPI_Device devices[MAX_DEVICES_PER_BUS];    // 设备列表
-    osal_event_t bus_event;                     // 总线事件
-    osal_mutex_t bus_mutex;                     // 总线互斥锁
+    uint16_t event_index[SPI_EVENT_NUM];        // 总线事件在SPI宽事件组中的标志
+    osal_hmutex_t bus_mutex;                    // 总线互斥锁(无竞争时不进入内核)
     uint8_t device_count;                       // 当前设备数量
     volatile SPI_Device* active_dev;            // 当前活动设备
+#if SPI_PROFILE_ENABLE
+    uint32_t trx_count;                         // BSP_SPI_TransReceive调用次数
+    uint32_t trx_cycles_max;                    // 单次调用最长周期数
+    uint64_t trx_cycles_total;                  // 调用周期数累计
+    uint32_t trx_overhead_max;                  // 单次调用中除传输本身外(加解锁、片选、事件等待)的最长周期数
+    uint64_t trx_overhead_total;                // 除传输本身外的周期数累计
+#endif
 } SPI_Bus_Manager;
 
 
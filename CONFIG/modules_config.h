@@ -25,17 +25,19 @@
 #define MAX_OFFLINE_DEVICES               12                                    // 最大离线设备数量，这里根据需要自己修改
 #define OFFLINE_MODULE_ENABLE             1                                     // 开启离线检测功能,注意下述功能在启用模块才有效 
 #if OFFLINE_MODULE_ENABLE
-   #define OFFLINE_THREAD_STACK_SIZE      1024                                  // 离线检测线程栈大小 
-   #define OFFLINE_THREAD_STACK_SECTION   __attribute__((section(".ccmram")))   // 线程栈内存区域 
-   #define OFFLINE_THREAD_PRIORITY        1                                     // 离线检测线程优先级 
+   #define OFFLINE_TASK_PERIOD_MS         10                                    // 离线检测周期(ms)，在osal_coro调度线程中运行
    #define OFFLINE_WATCHDOG_ENABLE        1                                     // 启用离线检测看门狗功能
    #define OFFLINE_BEEP_ENABLE            1                                     // 开启离线蜂鸣器功能 
-   #define OFFLINE_BEEP_PERIOD            2000                                  //注意这里的周期，由于在定时器(10ms)中,尽量保证整除
+   #define OFFLINE_BEEP_PERIOD            2000                                  //报警周期(ms)
    #define OFFLINE_BEEP_ON_TIME           100                                   //这里BEEP_ON_TIME BEEP_OFF_TIME 共同影响
    #define OFFLINE_BEEP_OFF_TIME          100                                   //最大beep times（BEEP_PERIOD / （这里BEEP_ON_TIME + BEEP_OFF_TIME））
    #define OFFLINE_BEEP_TUNE_VALUE        500                                   //这两个部分决定beep的音调，音色
    #define OFFLINE_BEEP_CTRL_VALUE        100
 #endif
+/* MESSAGE_CENTER 消息中心 */
+#define MESSAGE_MAX_TOPICS                16                                    // 最大话题数量
+#define MESSAGE_POOL_SIZE                 4096                                  // 话题数据槽存储池大小(字节)
+#define MESSAGE_DEFAULT_DEPTH             4                                     // 默认每个话题的数据槽数量(2的幂)
 
 
 
@@ -0,0 +1,212 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-19 16:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-19 16:00:00
+ * @FilePath: /rm_base/OSAL/osal_coro.c
+ * @Description: 无栈协程调度器实现
+ */
+#include "osal_coro.h"
+
+/*
+ * 协程以单链表组织，新协程插在表头。插入可能发生在任意线程，摘除只由调度线程完成，
+ * 两者都修改表头，因此都在临界区中进行；遍历只读next指针，不需要加锁。
+ */
+static osal_coro_t *volatile coro_list = NULL;
+static volatile uint8_t coro_wake_pending = 0;
+static uint8_t coro_initialized = 0;
+static osal_sem_t coro_sem;
+static osal_thread_t coro_thread;
+OSAL_CORO_STACK_SECTION static uint8_t coro_stack[OSAL_CORO_STACK_SIZE] __attribute__((aligned(8)));
+
+static void coro_unlink(osal_coro_t *prev, osal_coro_t *co)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    if (prev == NULL) {
+        /* 遍历期间表头可能插入了新协程，重新查找前驱 */
+        if (coro_list == co) {
+            coro_list = co->next;
+        } else {
+            prev = coro_list;
+            while (prev->next != co) {
+                prev = prev->next;
+            }
+        }
+    }
+    if (prev != NULL) {
+        prev->next = co->next;
+    }
+    co->next = NULL;
+    co->fn = NULL;
+    osal_exit_critical(&crit);
+}
+
+static void coro_run(void)
+{
+    for (;;) {
+        osal_tick_t now = osal_tick_get();
+        osal_tick_t next_wake = 0;
+        osal_tick_t timeout;
+        uint8_t has_ready = 0, has_waiting = 0, has_delayed = 0;
+        osal_coro_t *prev = NULL;
+        osal_coro_t *co = coro_list;
+
+        /* 先清除唤醒标志再遍历，之后的唤醒会重新释放信号量 */
+        __atomic_store_n(&coro_wake_pending, 0, __ATOMIC_SEQ_CST);
+
+        while (co != NULL) {
+            osal_coro_t *next = co->next;
+            uint8_t woken = __atomic_exchange_n(&co->woken, 0, __ATOMIC_ACQ_REL);
+            uint8_t due = woken || co->state == OSAL_CORO_READY || co->state == OSAL_CORO_WAITING ||
+                          (long)(now - co->wake_tick) >= 0;
+
+            if (due) {
+                uint32_t start = osal_cycle_get();
+                co->state = co->fn(co);
+                uint32_t cycles = osal_cycle_get() - start;
+                co->runs++;
+                if (cycles > co->run_max) {
+                    co->run_max = cycles;
+                }
+                now = osal_tick_get();
+            }
+
+            switch (co->state) {
+            case OSAL_CORO_EXITED:
+                coro_unlink(prev, co);
+                co = next;
+                continue;
+            case OSAL_CORO_READY:
+                has_ready = 1;
+                break;
+            case OSAL_CORO_WAITING:
+                has_waiting = 1;
+                break;
+            default:
+                if (!has_delayed || (long)(co->wake_tick - next_wake) < 0) {
+                    next_wake = co->wake_tick;
+                    has_delayed = 1;
+                }
+                break;
+            }
+            prev = co;
+            co = next;
+        }
+
+        if (has_ready) {
+            continue;
+        }
+        /* 等待条件的协程每个tick检查一次 */
+        if (has_waiting) {
+            timeout = 1;
+        } else if (has_delayed) {
+            now = osal_tick_get();
+            if ((long)(next_wake - now) <= 0) {
+                continue;
+            }
+            timeout = next_wake - now;
+        } else {
+            timeout = OSAL_WAIT_FOREVER;
+        }
+        osal_sem_wait(&coro_sem, timeout);
+    }
+}
+
+#if (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+static void coro_thread_entry(void *argument)
+{
+    (void)argument;
+    coro_run();
+}
+#else
+static void coro_thread_entry(unsigned long argument)
+{
+    (void)argument;
+    coro_run();
+}
+#endif
+
+static void coro_kick(void)
+{
+    if (!__atomic_load_n(&coro_initialized, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    if (__atomic_exchange_n(&coro_wake_pending, 1, __ATOMIC_SEQ_CST) == 0) {
+        osal_sem_post(&coro_sem);
+    }
+}
+
+osal_status_t osal_coro_init(void)
+{
+    if (coro_initialized) {
+        return OSAL_SUCCESS;
+    }
+
+    if (osal_sem_create(&coro_sem, "coro", 0) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    if (osal_thread_create(&coro_thread, "coro", coro_thread_entry, NULL,
+                           coro_stack, sizeof(coro_stack), OSAL_CORO_THREAD_PRIORITY) != OSAL_SUCCESS) {
+        osal_sem_delete(&coro_sem);
+        return OSAL_ERROR;
+    }
+    __atomic_store_n(&coro_initialized, 1, __ATOMIC_RELEASE);
+    osal_thread_start(&coro_thread);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_coro_start(osal_coro_t *co, const char *name, osal_coro_fn_t fn, void *arg)
+{
+    osal_critical_state_t crit;
+
+    if (co == NULL || fn == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    osal_enter_critical(&crit);
+    if (co->fn != NULL) {
+        osal_exit_critical(&crit);
+        return OSAL_INVALID_PARAM;
+    }
+    co->lc = 0;
+    co->state = OSAL_CORO_READY;
+    co->woken = 0;
+    co->wake_tick = osal_tick_get();
+    co->fn = fn;
+    co->arg = arg;
+    co->name = name;
+    co->runs = 0;
+    co->run_max = 0;
+    co->next = coro_list;
+    coro_list = co;
+    osal_exit_critical(&crit);
+
+    coro_kick();
+    return OSAL_SUCCESS;
+}
+
+void osal_coro_wake(osal_coro_t *co)
+{
+    if (co == NULL) {
+        return;
+    }
+    __atomic_store_n(&co->woken, 1, __ATOMIC_RELEASE);
+    coro_kick();
+}
+
+osal_coro_t *osal_coro_next(osal_coro_t *co)
+{
+    return (co == NULL) ? coro_list : co->next;
+}
+
+void osal_coro_period_next(osal_coro_t *co, osal_tick_t period)
+{
+    osal_tick_t now = osal_tick_get();
+
+    co->wake_tick += period;
+    if ((long)(now - co->wake_tick) >= 0) {
+        co->wake_tick = now + period;
+    }
+}
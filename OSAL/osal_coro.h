@@ -0,0 +1,140 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-19 16:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-19 16:00:00
+ * @FilePath: /rm_base/OSAL/osal_coro.h
+ * @Description: 无栈协程，大量轻量的周期/状态机任务共用一个线程协作运行
+ */
+#ifndef __OSAL_CORO_H__
+#define __OSAL_CORO_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 调度线程栈大小，所有协程共用 */
+#ifndef OSAL_CORO_STACK_SIZE
+#define OSAL_CORO_STACK_SIZE        1024
+#endif
+
+/* 调度线程栈内存区域 */
+#ifndef OSAL_CORO_STACK_SECTION
+#define OSAL_CORO_STACK_SECTION
+#endif
+
+/* 调度线程优先级，承载离线检测(含看门狗喂狗)，协程必须短小 */
+#ifndef OSAL_CORO_THREAD_PRIORITY
+#if (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+#define OSAL_CORO_THREAD_PRIORITY   (configMAX_PRIORITIES - 2)
+#else
+#define OSAL_CORO_THREAD_PRIORITY   1
+#endif
+#endif
+
+/* 协程函数返回值，同时也是协程状态 */
+#define OSAL_CORO_READY     0   /* 让出，下一轮立即继续 */
+#define OSAL_CORO_DELAYED   1   /* 休眠到wake_tick */
+#define OSAL_CORO_WAITING   2   /* 等待条件，每个tick检查一次 */
+#define OSAL_CORO_EXITED    3   /* 已结束，从调度链表移除 */
+
+struct osal_coro;
+
+/*
+ * 协程函数，每次被调度时从上次让出的位置继续执行。
+ * 协程没有自己的栈，局部变量在让出后不保留，需要跨越让出点的状态放在静态变量或arg指向的结构体中；
+ * OSAL_CORO_BEGIN/END之间不能再使用switch语句。
+ */
+typedef uint8_t (*osal_coro_fn_t)(struct osal_coro *co);
+
+typedef struct osal_coro {
+    uint16_t lc;                /* 继续执行的位置(行号)，0表示从头开始 */
+    uint8_t state;              /* OSAL_CORO_* */
+    volatile uint8_t woken;     /* osal_coro_wake置位，调度器清除 */
+    osal_tick_t wake_tick;      /* DELAYED：唤醒时刻；带超时等待：超时时刻 */
+    osal_coro_fn_t fn;          /* 非NULL表示协程已启动 */
+    void *arg;
+    const char *name;
+    uint32_t runs;              /* 被调度次数 */
+    uint32_t run_max;           /* 单次最长运行时间(osal_cycle_get周期数) */
+    struct osal_coro *next;
+} osal_coro_t;
+
+#define OSAL_CORO_MS_TO_TICKS(ms)   ((osal_tick_t)(((uint64_t)(ms) * OSAL_TICK_RATE_HZ + 999U) / 1000U))
+
+/* 协程体开始/结束 */
+#define OSAL_CORO_BEGIN(co)         switch ((co)->lc) { case 0:
+#define OSAL_CORO_END(co)           } (co)->lc = 0; return OSAL_CORO_EXITED
+
+/* 让出，其他协程运行一轮后继续 */
+#define OSAL_CORO_YIELD(co) \
+    do { (co)->lc = __LINE__; return OSAL_CORO_READY; case __LINE__:; } while (0)
+
+/* 休眠ms毫秒 */
+#define OSAL_CORO_DELAY_MS(co, ms) \
+    do { (co)->wake_tick = osal_tick_get() + OSAL_CORO_MS_TO_TICKS(ms); \
+         (co)->lc = __LINE__; return OSAL_CORO_DELAYED; case __LINE__:; } while (0)
+
+/* 休眠到指定tick时刻，时刻已过则下一轮立即继续 */
+#define OSAL_CORO_DELAY_UNTIL(co, tick) \
+    do { (co)->wake_tick = (tick); \
+         (co)->lc = __LINE__; return OSAL_CORO_DELAYED; case __LINE__:; } while (0)
+
+/* 按固定周期休眠，释放时刻不随执行时间漂移；落后超过一个周期时从当前时刻重新开始 */
+#define OSAL_CORO_PERIOD_MS(co, ms) \
+    do { osal_coro_period_next((co), OSAL_CORO_MS_TO_TICKS(ms)); \
+         (co)->lc = __LINE__; return OSAL_CORO_DELAYED; case __LINE__:; } while (0)
+
+/* 等待条件成立 */
+#define OSAL_CORO_WAIT_UNTIL(co, cond) \
+    do { (co)->lc = __LINE__; case __LINE__: if (!(cond)) { return OSAL_CORO_WAITING; } } while (0)
+
+/* 等待条件成立或超时，之后需要重新判断条件区分两种情况 */
+#define OSAL_CORO_WAIT_UNTIL_TIMEOUT(co, cond, ms) \
+    do { (co)->wake_tick = osal_tick_get() + OSAL_CORO_MS_TO_TICKS(ms); (co)->lc = __LINE__; case __LINE__: \
+         if (!(cond) && (long)(osal_tick_get() - (co)->wake_tick) < 0) { return OSAL_CORO_WAITING; } } while (0)
+
+/* 结束协程 */
+#define OSAL_CORO_EXIT(co)          do { (co)->lc = 0; return OSAL_CORO_EXITED; } while (0)
+
+/**
+ * @description: 初始化协程调度器并启动调度线程
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 信号量或线程创建失败
+ */
+osal_status_t osal_coro_init(void);
+
+/**
+ * @description: 启动协程，可在调度器初始化前后调用；不可在中断中调用
+ * @param {osal_coro_t*} co, 协程控制块，需静态分配
+ * @param {const char*} name, 名称
+ * @param {osal_coro_fn_t} fn, 协程函数
+ * @param {void*} arg, 协程参数，协程中通过co->arg访问
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误或协程正在运行
+ */
+osal_status_t osal_coro_start(osal_coro_t *co, const char *name, osal_coro_fn_t fn, void *arg);
+
+/**
+ * @description: 立即唤醒协程(结束休眠或重新检查等待条件)，可在中断中调用
+ * @param {osal_coro_t*} co, 协程控制块
+ * @return {*}
+ */
+void osal_coro_wake(osal_coro_t *co);
+
+/**
+ * @description: 遍历已启动的协程，供shell等调试工具使用
+ * @param {osal_coro_t*} co, 传NULL获取第一个
+ * @return {osal_coro_t*} 下一个协程，没有时返回NULL
+ */
+osal_coro_t *osal_coro_next(osal_coro_t *co);
+
+/* 内部接口：OSAL_CORO_PERIOD_MS使用 */
+void osal_coro_period_next(osal_coro_t *co, osal_tick_t period);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_CORO_H__ */
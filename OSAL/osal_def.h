@@ -17,6 +17,7 @@ extern "C" {
 /* OSAL支持的RTOS类型 */
 #define OSAL_THREADX       (1)
 #define OSAL_FREERTOS      (2)
+#define OSAL_POSIX         (3)   /* 主机(Linux)构建，基于pthread，用于在PC上运行和性能测试 */
 
 /* 配置当前使用的RTOS类型，默认为裸机模式 */
 #ifndef OSAL_RTOS_TYPE
@@ -31,6 +32,9 @@ extern "C" {
     #include "task.h"
     #include "semphr.h"
     #include "event_groups.h"
+    #elif OSAL_RTOS_TYPE == OSAL_POSIX
+    #include <pthread.h>
+    #include <time.h>
     #else
     #error "OSAL_RTOS_TYPE is not defined"
     #endif
@@ -58,6 +62,21 @@ typedef struct {
 } osal_thread_t;
 typedef UBaseType_t osal_thread_priority_t;
 typedef void (*osal_thread_entry_t)(void *);
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+// POSIX下，线程入口参数与ThreadX保持一致(ULONG)，方便模块代码直接移植
+typedef unsigned int osal_thread_priority_t;
+typedef void (*osal_thread_entry_t)(unsigned long);
+typedef struct {
+    pthread_t handle;                // pthread句柄
+    pthread_mutex_t lock;            // 保护挂起状态
+    pthread_cond_t cond;             // 挂起/恢复通知
+    const char *name;                // 线程名称
+    osal_thread_entry_t entry;       // 入口函数
+    unsigned long argument;          // 入口参数
+    osal_thread_priority_t priority; // 优先级(仅记录，主机下不参与调度)
+    volatile uint8_t started;        // pthread是否已创建
+    volatile uint8_t suspended;      // 挂起请求
+} osal_thread_t;
 #endif
 
 /* 信号量相关类型定义 */
@@ -69,6 +88,13 @@ typedef struct {
     SemaphoreHandle_t sem_handle;
     StaticSemaphore_t sem_buffer;
 } osal_sem_t;
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned int count;
+    const char *name;
+} osal_sem_t;
 #endif
 
 /* 互斥量相关类型定义 */
@@ -80,6 +106,12 @@ typedef struct {
     SemaphoreHandle_t mutex_handle;
     StaticSemaphore_t mutex_buffer;
 } osal_mutex_t;
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+// 与ThreadX一致，互斥量可被同一线程递归获取
+typedef struct {
+    pthread_mutex_t handle;
+    const char *name;
+} osal_mutex_t;
 #endif
 
 /* 事件相关类型定义 */
@@ -91,6 +123,13 @@ typedef struct {
     EventGroupHandle_t handle;
     StaticEventGroup_t buffer;
 } osal_event_t;
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned int flags;
+    const char *name;
+} osal_event_t;
 #endif
 /* 事件等待选项 */
 #define OSAL_EVENT_WAIT_FLAG_AND            0x01U  /* 等待所有指定的事件标志都被设置 */
@@ -109,6 +148,17 @@ typedef struct {
 } osal_timer_t;
 // 严格按照FreeRTOS标准定义回调函数类型
 typedef void (*osal_timer_callback_t)(TimerHandle_t xTimer);
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+// 回调参数与ThreadX保持一致，回调在timer_create(SIGEV_THREAD)创建的线程中执行
+typedef void (*osal_timer_callback_t)(unsigned long);
+typedef struct {
+    timer_t handle;
+    osal_timer_callback_t callback;
+    unsigned long argument;
+    unsigned int period_ms;
+    uint8_t periodic;
+    const char *name;
+} osal_timer_t;
 #endif
 
 /* 定时器模式 */
@@ -124,6 +174,21 @@ typedef TX_QUEUE osal_queue_t;
 typedef struct {
     QueueHandle_t handle;
     StaticQueue_t buffer;
+    unsigned int msg_size;
+} osal_queue_t;
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+// POSIX下消息存放在用户提供的msg_buffer中(环形队列)
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t *buffer;
+    unsigned int msg_size;
+    unsigned int msg_count;
+    unsigned int head;
+    unsigned int tail;
+    unsigned int count;
+    const char *name;
 } osal_queue_t;
 #endif
 
@@ -132,6 +197,17 @@ typedef struct {
 typedef ULONG osal_tick_t;
 #elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
 typedef TickType_t osal_tick_t;
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+typedef unsigned long osal_tick_t;   /* 1 tick = 1 ms，与ThreadX配置(TX_TIMER_TICKS_PER_SECOND=1000)一致 */
+#endif
+
+/* 系统tick频率(Hz) */
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+#define OSAL_TICK_RATE_HZ        TX_TIMER_TICKS_PER_SECOND
+#elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+#define OSAL_TICK_RATE_HZ        configTICK_RATE_HZ
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+#define OSAL_TICK_RATE_HZ        1000
 #endif
 
 /* 中断临界区控制定义 */
@@ -139,8 +215,38 @@ typedef TickType_t osal_tick_t;
 typedef UINT osal_critical_state_t;
 #elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
 typedef BaseType_t osal_critical_state_t;
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+typedef int osal_critical_state_t;   /* POSIX下临界区由全局递归互斥量模拟 */
+#endif
+
+/*
+ * 临界区屏蔽方式：0 - PRIMASK，关闭全部可屏蔽中断；1 - BASEPRI，只屏蔽优先级数值>=OSAL_CRITICAL_BASEPRI_PRIORITY的中断，
+ * 更高优先级(数值更小)的中断在临界区中照常响应，这类零延迟中断不能调用任何OSAL接口。
+ * 由CMake选项OSAL_CRITICAL_BASEPRI打开，ThreadX内核同时切换为BASEPRI(TX_PORT_USE_BASEPRI)，两者屏蔽阈值一致。
+ * FreeRTOS的taskENTER_CRITICAL本身就是BASEPRI，阈值为configMAX_SYSCALL_INTERRUPT_PRIORITY。
+ */
+#ifndef OSAL_CRITICAL_BASEPRI_ENABLE
+#define OSAL_CRITICAL_BASEPRI_ENABLE    0
+#endif
+
+/* 被临界区屏蔽的最高中断优先级(NVIC抢占优先级，0~15)，数值小于它的中断为零延迟中断 */
+#ifndef OSAL_CRITICAL_BASEPRI_PRIORITY
+#define OSAL_CRITICAL_BASEPRI_PRIORITY  2
 #endif
 
+/* 中断屏蔽时长统计，由CMake选项OSAL_CRITICAL_STATS打开，可通过shell的ps critical命令查看 */
+#ifndef OSAL_CRITICAL_STATS_ENABLE
+#define OSAL_CRITICAL_STATS_ENABLE      0
+#endif
+
+typedef struct {
+    uint32_t count;             /* 最外层临界区次数 */
+    uint32_t max_cycles;        /* 最长屏蔽时长(周期数) */
+    uint64_t total_cycles;      /* 屏蔽时长累计(周期数) */
+    void *max_caller;           /* 最长一次临界区的调用位置(进入临界区的返回地址) */
+    uint32_t isr_violation;     /* 零延迟中断中调用临界区的次数，BASEPRI模式下应始终为0 */
+} osal_critical_stats_t;
+
 
 /* 常量定义 */
 #define OSAL_WAIT_FOREVER        ((osal_tick_t)-1)
@@ -341,9 +447,9 @@ uint8_t osal_timer_is_active(osal_timer_t *timer);
  * @description: 创建队列
  * @param {osal_queue_t*} queue - 队列句柄指针
  * @param {const char*} name - 队列名称
- * @param {unsigned int} msg_size - 消息大小(字节)
+ * @param {unsigned int} msg_size - 消息大小(字节)，ThreadX下必须是4的整数倍(1~16个ULONG)
  * @param {unsigned int} msg_count - 消息数量
- * @param {void*} msg_buffer - 消息缓冲区内存
+ * @param {void*} msg_buffer - 消息缓冲区内存，大小为msg_size * msg_count字节
  * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 失败
  */
 osal_status_t osal_queue_create(osal_queue_t *queue, 
@@ -370,6 +476,36 @@ osal_status_t osal_queue_send(osal_queue_t *queue, void *msg_ptr, osal_tick_t ti
  */
 osal_status_t osal_queue_recv(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout);
 
+/**
+ * @description: 批量发送，一次临界区内写入尽可能多的消息；队列满时等待至少能发送1条或超时，可在中断中调用(OSAL_NO_WAIT)
+ * @param {osal_queue_t*} queue - 队列句柄指针
+ * @param {const void*} msgs - 连续存放的消息数组
+ * @param {unsigned int} count - 消息条数
+ * @param {osal_tick_t} timeout - 超时时间
+ * @return {unsigned int} 实际发送的消息条数
+ */
+unsigned int osal_queue_send_n(osal_queue_t *queue, const void *msgs, unsigned int count, osal_tick_t timeout);
+
+/**
+ * @description: 批量接收，等待队列中至少有min_count条消息后一次临界区内取出至多max_count条；
+ *               超时返回已取到的消息(可能少于min_count)，可在中断中调用(OSAL_NO_WAIT)
+ * @param {osal_queue_t*} queue - 队列句柄指针
+ * @param {void*} msgs - 消息存储数组，至少max_count条
+ * @param {unsigned int} max_count - 最多接收的消息条数
+ * @param {unsigned int} min_count - 至少等到的消息条数，0或1表示有消息即返回，超过队列容量时按容量计
+ * @param {osal_tick_t} timeout - 超时时间
+ * @return {unsigned int} 实际接收的消息条数
+ */
+unsigned int osal_queue_recv_n(osal_queue_t *queue, void *msgs, unsigned int max_count, unsigned int min_count,
+                               osal_tick_t timeout);
+
+/**
+ * @description: 获取队列中的消息条数
+ * @param {osal_queue_t*} queue - 队列句柄指针
+ * @return {unsigned int}
+ */
+unsigned int osal_queue_count(osal_queue_t *queue);
+
 /**
  * @description: 删除队列
  * @param {osal_queue_t*} queue - 队列句柄指针
@@ -392,6 +528,19 @@ osal_status_t osal_enter_critical(osal_critical_state_t *crit);
  */
 osal_status_t osal_exit_critical(osal_critical_state_t *crit);
 
+/**
+ * @description: 获取中断屏蔽时长统计，只统计经过osal_enter_critical的临界区，不包括RTOS内核内部的临界区
+ * @param {osal_critical_stats_t*} stats 输出统计
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 未打开统计
+ */
+osal_status_t osal_critical_stats_get(osal_critical_stats_t *stats);
+
+/**
+ * @description: 清零中断屏蔽时长统计
+ * @return {*}
+ */
+void osal_critical_stats_reset(void);
+
 
 // 通用延时函数
 /**
@@ -403,13 +552,45 @@ void osal_delay_ms(unsigned int ms);
 /**
  * @description: 微秒延时
  * @param {unsigned int} us
- * @note: 该函数是nop延时，注意rtos下，时间过长会阻塞系统调度
+ * @note: 该函数按DWT周期计数忙等，期间占用CPU；线程中较长的等待使用osal_utimer.h中的osal_sleep_us
  * @return {*}
  */
 void osal_delay_us(unsigned int us);
+/**
+ * @description: 获取系统tick计数
+ * @return {osal_tick_t}
+ */
+osal_tick_t osal_tick_get(void);
+/**
+ * @description: 绝对时间延时，休眠到*prev_wake + increment时刻，并更新*prev_wake，用于无累积漂移的周期任务
+ * @param {osal_tick_t*} prev_wake, 上一次唤醒的目标时刻，首次使用前设置为osal_tick_get()
+ * @param {osal_tick_t} increment, 周期(tick)
+ * @return {osal_status_t} OSAL_SUCCESS - 正常休眠, OSAL_TIMEOUT - 目标时刻已过(未休眠), OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_delay_until(osal_tick_t *prev_wake, osal_tick_t increment);
+/**
+ * @description: 获取高精度周期计数，MCU上为DWT->CYCCNT(需先调用DWT_Init)，主机上为纳秒
+ * @note: 32位计数会回绕，只用于计算短时间间隔
+ * @return {uint32_t}
+ */
+uint32_t osal_cycle_get(void);
+/**
+ * @description: 每微秒对应的周期计数
+ * @return {uint32_t}
+ */
+uint32_t osal_cycle_per_us(void);
 
 #ifdef __cplusplus
 }
 #endif
 
+/* 内联模式：ThreadX下热路径接口展开为static inline包装，由CMake选项OSAL_INLINE打开，见osal_inline.h */
+#ifndef OSAL_INLINE_ENABLE
+#define OSAL_INLINE_ENABLE      0
+#endif
+
+#if OSAL_INLINE_ENABLE
+#include "osal_inline.h"
+#endif
+
 #endif /* __OSAL_DEF_H__ */
\ No newline at end of file
@@ -0,0 +1,194 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-19 10:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-19 10:00:00
+ * @FilePath: /rm_base/OSAL/osal_defer.c
+ * @Description: 中断下半部执行器实现
+ */
+#include "osal_defer.h"
+
+/*
+ * 有界多生产者/单消费者队列：每个槽位带序号，seq == pos表示空闲可写，seq == pos + 1表示已写入可读。
+ * 生产者(中断或线程)用CAS抢占写位置(Cortex-M4上为LDREX/STREX，中断嵌套时自动重试)，写完数据后发布序号，
+ * 全程不关中断。工作线程是唯一的消费者，读完后把序号推进一圈交还给生产者。
+ */
+typedef struct {
+    volatile uint32_t seq;
+    osal_defer_fn_t fn;
+    void *arg;
+    uint32_t stamp;             /* 入队时刻(osal_cycle_get) */
+} defer_slot_t;
+
+#define DEFER_MASK  (OSAL_DEFER_QUEUE_SIZE - 1U)
+
+static defer_slot_t defer_slots[OSAL_DEFER_QUEUE_SIZE];
+static volatile uint32_t defer_tail = 0;   /* 生产者写位置 */
+static uint32_t defer_head = 0;            /* 消费者读位置，只由工作线程访问 */
+static volatile uint8_t defer_wake_pending = 0;
+static uint8_t defer_initialized = 0;
+static osal_sem_t defer_sem;
+static osal_thread_t defer_thread;
+static osal_defer_stats_t defer_stats = {0};
+OSAL_DEFER_STACK_SECTION static uint8_t defer_stack[OSAL_DEFER_STACK_SIZE] __attribute__((aligned(8)));
+
+/* 取出并执行当前队列中的全部条目，返回执行条数 */
+static uint32_t defer_drain(void)
+{
+    uint32_t count = 0;
+
+    for (;;) {
+        defer_slot_t *slot = &defer_slots[defer_head & DEFER_MASK];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != defer_head + 1U) {
+            break;
+        }
+        osal_defer_fn_t fn = slot->fn;
+        void *arg = slot->arg;
+        uint32_t start = osal_cycle_get();
+        uint32_t latency = start - slot->stamp;
+        __atomic_store_n(&slot->seq, defer_head + OSAL_DEFER_QUEUE_SIZE, __ATOMIC_RELEASE);
+        defer_head++;
+
+        fn(arg);
+
+        uint32_t exec = osal_cycle_get() - start;
+        defer_stats.executed++;
+        defer_stats.latency_total += latency;
+        if (latency > defer_stats.latency_max) {
+            defer_stats.latency_max = latency;
+        }
+        if (exec > defer_stats.exec_max) {
+            defer_stats.exec_max = exec;
+            defer_stats.exec_max_fn = fn;
+        }
+        count++;
+    }
+    return count;
+}
+
+static void defer_run(void)
+{
+    for (;;) {
+        osal_sem_wait(&defer_sem, OSAL_WAIT_FOREVER);
+        /* 先清除唤醒标志再取队列，之后入队的条目会重新释放信号量 */
+        __atomic_store_n(&defer_wake_pending, 0, __ATOMIC_SEQ_CST);
+        uint32_t count = defer_drain();
+        if (count == 0) {
+            continue;
+        }
+        defer_stats.batches++;
+        if (count > defer_stats.batch_max) {
+            defer_stats.batch_max = count;
+        }
+    }
+}
+
+#if (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+static void defer_thread_entry(void *argument)
+{
+    (void)argument;
+    defer_run();
+}
+#else
+static void defer_thread_entry(unsigned long argument)
+{
+    (void)argument;
+    defer_run();
+}
+#endif
+
+osal_status_t osal_defer_init(void)
+{
+    if (defer_initialized) {
+        return OSAL_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < OSAL_DEFER_QUEUE_SIZE; i++) {
+        defer_slots[i].seq = i;
+    }
+    defer_tail = 0;
+    defer_head = 0;
+    defer_wake_pending = 0;
+
+    if (osal_sem_create(&defer_sem, "defer", 0) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    if (osal_thread_create(&defer_thread, "defer", defer_thread_entry, NULL,
+                           defer_stack, sizeof(defer_stack), OSAL_DEFER_THREAD_PRIORITY) != OSAL_SUCCESS) {
+        osal_sem_delete(&defer_sem);
+        return OSAL_ERROR;
+    }
+    __atomic_store_n(&defer_initialized, 1, __ATOMIC_RELEASE);
+    osal_thread_start(&defer_thread);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_defer(osal_defer_fn_t fn, void *arg)
+{
+    defer_slot_t *slot;
+    uint32_t pos;
+
+    if (fn == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    if (!__atomic_load_n(&defer_initialized, __ATOMIC_ACQUIRE)) {
+        return OSAL_ERROR;
+    }
+
+    pos = __atomic_load_n(&defer_tail, __ATOMIC_RELAXED);
+    for (;;) {
+        slot = &defer_slots[pos & DEFER_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&defer_tail, &pos, pos + 1U, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_add_fetch(&defer_stats.dropped, 1, __ATOMIC_RELAXED);
+            return OSAL_NO_MEMORY;
+        } else {
+            pos = __atomic_load_n(&defer_tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->fn = fn;
+    slot->arg = arg;
+    slot->stamp = osal_cycle_get();
+    __atomic_store_n(&slot->seq, pos + 1U, __ATOMIC_RELEASE);
+
+    /* 工作线程被唤醒后清除标志前，后续入队不再重复释放信号量 */
+    if (__atomic_exchange_n(&defer_wake_pending, 1, __ATOMIC_SEQ_CST) == 0) {
+        osal_sem_post(&defer_sem);
+    }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_defer_stats_get(osal_defer_stats_t *stats)
+{
+    osal_critical_state_t crit;
+
+    if (stats == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_enter_critical(&crit);
+    *stats = defer_stats;
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+void osal_defer_stats_reset(void)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    defer_stats.executed = 0;
+    defer_stats.dropped = 0;
+    defer_stats.batches = 0;
+    defer_stats.batch_max = 0;
+    defer_stats.latency_max = 0;
+    defer_stats.latency_total = 0;
+    defer_stats.exec_max = 0;
+    defer_stats.exec_max_fn = NULL;
+    osal_exit_critical(&crit);
+}
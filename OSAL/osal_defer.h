@@ -0,0 +1,93 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-19 10:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-19 10:00:00
+ * @FilePath: /rm_base/OSAL/osal_defer.h
+ * @Description: 中断下半部执行器，中断中把处理函数无锁入队，由高优先级工作线程批量执行
+ */
+#ifndef __OSAL_DEFER_H__
+#define __OSAL_DEFER_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 队列深度，必须是2的幂 */
+#ifndef OSAL_DEFER_QUEUE_SIZE
+#define OSAL_DEFER_QUEUE_SIZE       32
+#endif
+
+/* 工作线程栈大小 */
+#ifndef OSAL_DEFER_STACK_SIZE
+#define OSAL_DEFER_STACK_SIZE       1024
+#endif
+
+/* 工作线程栈内存区域 */
+#ifndef OSAL_DEFER_STACK_SECTION
+#define OSAL_DEFER_STACK_SECTION
+#endif
+
+/* 工作线程优先级，应高于所有等待中断事件的线程 */
+#ifndef OSAL_DEFER_THREAD_PRIORITY
+#if (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+#define OSAL_DEFER_THREAD_PRIORITY  (configMAX_PRIORITIES - 1)
+#else
+#define OSAL_DEFER_THREAD_PRIORITY  0
+#endif
+#endif
+
+#if (OSAL_DEFER_QUEUE_SIZE & (OSAL_DEFER_QUEUE_SIZE - 1)) != 0
+#error "OSAL_DEFER_QUEUE_SIZE must be a power of 2"
+#endif
+
+/* 下半部处理函数，在工作线程中执行 */
+typedef void (*osal_defer_fn_t)(void *arg);
+
+/* 统计，时间单位为osal_cycle_get的周期数 */
+typedef struct {
+    uint32_t executed;              /* 已执行条目数 */
+    uint32_t dropped;               /* 队列满被丢弃的条目数 */
+    uint32_t batches;               /* 工作线程被唤醒处理的批次数 */
+    uint32_t batch_max;             /* 单批最多条目数 */
+    uint32_t latency_max;           /* 入队到开始执行的最大延迟 */
+    uint64_t latency_total;         /* 延迟累计，平均值 = latency_total / executed */
+    uint32_t exec_max;              /* 单条最长执行时间 */
+    osal_defer_fn_t exec_max_fn;    /* 执行时间最长的处理函数 */
+} osal_defer_stats_t;
+
+/**
+ * @description: 初始化下半部执行器并启动工作线程，需在任何中断调用osal_defer之前调用
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 信号量或线程创建失败
+ */
+osal_status_t osal_defer_init(void);
+
+/**
+ * @description: 把处理函数放入队列，由工作线程执行；可在中断和线程中调用，无锁、不阻塞
+ * @param {osal_defer_fn_t} fn, 处理函数
+ * @param {void*} arg, 处理函数参数
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_NO_MEMORY - 队列满已丢弃, OSAL_ERROR - 未初始化, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_defer(osal_defer_fn_t fn, void *arg);
+
+/**
+ * @description: 获取统计
+ * @param {osal_defer_stats_t*} stats, 输出统计
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_defer_stats_get(osal_defer_stats_t *stats);
+
+/**
+ * @description: 清零统计
+ * @return {*}
+ */
+void osal_defer_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_DEFER_H__ */
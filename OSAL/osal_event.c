@@ -7,7 +7,22 @@
  * @Description: OSAL事件管理接口实现
  */
 
+#define OSAL_INLINE_IMPL    /* 本文件提供库中的函数实体，不使用osal_inline.h的映射 */
 #include "osal_def.h"
+#include "osal_lockstat.h"
+#include "osal_waitany.h"
+
+#if OSAL_LOCK_STATS_ENABLE
+/* 开启统计时，下面各后端实现编译为*_raw，由文件末尾的统计包装函数调用 */
+#define osal_event_create osal_event_create_raw
+#define osal_event_wait osal_event_wait_raw
+#define osal_event_delete osal_event_delete_raw
+#endif
+
+#if OSAL_WAIT_ANY_ENABLE
+/* 开启多对象等待时，osal_event_set编译为*_raw，由文件末尾的包装函数在成功后通知等待者 */
+#define osal_event_set osal_event_set_raw
+#endif
 
 #if (OSAL_RTOS_TYPE == OSAL_THREADX)
 
@@ -230,4 +245,148 @@ osal_status_t osal_event_delete(osal_event_t *event)
     return OSAL_SUCCESS;
 }
 
-#endif
\ No newline at end of file
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+#include "osal_posix.h"
+
+/* POSIX下的事件实现 */
+osal_status_t osal_event_create(osal_event_t *event, const char *name)
+{
+    if (event == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    if (pthread_mutex_init(&event->lock, NULL) != 0) {
+        return OSAL_ERROR;
+    }
+    if (osal_posix_cond_init(&event->cond) != 0) {
+        pthread_mutex_destroy(&event->lock);
+        return OSAL_ERROR;
+    }
+    event->flags = 0;
+    event->name = name;
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_event_set(osal_event_t *event, unsigned int flags)
+{
+    if (event == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&event->lock);
+    event->flags |= flags;
+    /* 等待条件各不相同，需要唤醒所有等待者各自判断 */
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_event_wait(osal_event_t *event, unsigned int requested_flags, 
+                              unsigned int options, osal_tick_t timeout, unsigned int *actual_flags)
+{
+    struct timespec abstime;
+    int ret = 0;
+    int satisfied;
+
+    if (event == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (timeout != OSAL_WAIT_FOREVER && timeout != OSAL_NO_WAIT) {
+        osal_posix_abstime(timeout, &abstime);
+    }
+
+    pthread_mutex_lock(&event->lock);
+    for (;;) {
+        /* 与ThreadX一致，未指定OR时按AND逻辑处理 */
+        if (options & OSAL_EVENT_WAIT_FLAG_OR) {
+            satisfied = (event->flags & requested_flags) != 0;
+        } else {
+            satisfied = (event->flags & requested_flags) == requested_flags;
+        }
+        if (satisfied || timeout == OSAL_NO_WAIT || ret == ETIMEDOUT) {
+            break;
+        }
+        ret = osal_posix_cond_wait(&event->cond, &event->lock,
+                                   (timeout == OSAL_WAIT_FOREVER) ? NULL : &abstime);
+    }
+
+    if (actual_flags != NULL) {
+        *actual_flags = event->flags;
+    }
+    if (satisfied && (options & OSAL_EVENT_WAIT_FLAG_CLEAR)) {
+        event->flags &= ~requested_flags;
+    }
+    pthread_mutex_unlock(&event->lock);
+
+    return satisfied ? OSAL_SUCCESS : OSAL_TIMEOUT;
+}
+
+osal_status_t osal_event_clear(osal_event_t *event, unsigned int flags)
+{
+    if (event == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&event->lock);
+    event->flags &= ~flags;
+    pthread_mutex_unlock(&event->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_event_delete(osal_event_t *event)
+{
+    if (event == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->lock);
+    return OSAL_SUCCESS;
+}
+
+#endif
+
+#if OSAL_LOCK_STATS_ENABLE
+#undef osal_event_create
+#undef osal_event_wait
+#undef osal_event_delete
+
+osal_status_t osal_event_create(osal_event_t *event, const char *name)
+{
+    osal_status_t status = osal_event_create_raw(event, name);
+    if (status == OSAL_SUCCESS) {
+        osal_lockstat_register(event, name, OSAL_LOCKSTAT_EVENT);
+    }
+    return status;
+}
+
+osal_status_t osal_event_wait(osal_event_t *event, unsigned int requested_flags, 
+                              unsigned int options, osal_tick_t timeout, unsigned int *actual_flags)
+{
+    osal_status_t status;
+
+    OSAL_LOCKSTAT_WAIT(status, event, timeout,
+                       osal_event_wait_raw(event, requested_flags, options, _lockstat_timeout, actual_flags));
+    return status;
+}
+
+osal_status_t osal_event_delete(osal_event_t *event)
+{
+    osal_lockstat_unregister(event);
+    return osal_event_delete_raw(event);
+}
+
+#endif /* OSAL_LOCK_STATS_ENABLE */
+
+#if OSAL_WAIT_ANY_ENABLE
+#undef osal_event_set
+
+osal_status_t osal_event_set(osal_event_t *event, unsigned int flags)
+{
+    osal_status_t status = osal_event_set_raw(event, flags);
+    if (status == OSAL_SUCCESS) {
+        osal_waitany_notify(event);
+    }
+    return status;
+}
+
+#endif /* OSAL_WAIT_ANY_ENABLE */
@@ -0,0 +1,337 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-20 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-20 14:00:00
+ * @FilePath: /rm_base/OSAL/osal_heap.c
+ * @Description: TLSF堆分配器实现
+ */
+#include "osal_heap.h"
+
+/*
+ * 空闲块按大小分到两级链表中：一级按2的幂分档，每档再线性分为16个二级档，每级用一个位图标记非空链表。
+ * 分配时把请求向上取整到档位上界，用位图的最低置位找到第一个一定够用的非空链表，取表头即可，不遍历链表；
+ * 释放时与物理相邻的空闲块合并后放回对应链表。两者都只有常数步操作，在临界区中完成。
+ *
+ * 每块前有prev_phys和size两个字的头部，已分配块的负载从next_free开始；空闲块的负载前两个字用作空闲链表指针。
+ * 堆末尾有一个大小为0、始终标记为已分配的哨兵块，合并时不需要判断越界。
+ */
+typedef struct heap_block {
+    struct heap_block *prev_phys;   /* 物理上的前一块，第一块为NULL */
+    size_t size;                    /* 负载字节数，bit0为空闲标志 */
+    struct heap_block *next_free;   /* 以下只在空闲块中有效 */
+    struct heap_block *prev_free;
+} heap_block_t;
+
+#define HEAP_ALIGN_LOG2     3
+#define HEAP_ALIGN          (1U << HEAP_ALIGN_LOG2)
+#define HEAP_SL_LOG2        4
+#define HEAP_SL_COUNT       (1U << HEAP_SL_LOG2)
+#define HEAP_FL_SHIFT       (HEAP_SL_LOG2 + HEAP_ALIGN_LOG2)
+#define HEAP_SMALL_SIZE     (1U << HEAP_FL_SHIFT)       /* 小于它的块都在一级第0档，二级按HEAP_ALIGN线性分档 */
+#define HEAP_FL_COUNT       (OSAL_HEAP_MAX_LOG2 - HEAP_FL_SHIFT + 1)
+
+#define HEAP_FREE_BIT       ((size_t)1)
+#define HEAP_HDR            (offsetof(heap_block_t, next_free))
+#define HEAP_ALIGN_UP(x)    (((x) + (HEAP_ALIGN - 1U)) & ~(size_t)(HEAP_ALIGN - 1U))
+#define HEAP_BLOCK_MIN      HEAP_ALIGN_UP(sizeof(heap_block_t) - HEAP_HDR)
+#define HEAP_ALLOC_MAX      ((size_t)1 << (OSAL_HEAP_MAX_LOG2 - 1))
+
+typedef struct {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[HEAP_FL_COUNT];
+    heap_block_t *blocks[HEAP_FL_COUNT][HEAP_SL_COUNT];
+} heap_control_t;
+
+OSAL_HEAP_SECTION static uint8_t heap_pool[OSAL_HEAP_SIZE] __attribute__((aligned(8)));
+static heap_control_t heap_ctrl;
+static osal_heap_stats_t heap_stats = {0};
+static uint8_t heap_ready = 0;
+
+#if OSAL_HEAP_TIMING_ENABLE
+#define HEAP_CYCLES()       osal_cycle_get()
+#else
+#define HEAP_CYCLES()       0U
+#endif
+
+static inline uint32_t heap_fls(uint32_t x)
+{
+    return 31U - (uint32_t)__builtin_clz(x);
+}
+
+static inline uint32_t heap_ffs(uint32_t x)
+{
+    return (uint32_t)__builtin_ctz(x);
+}
+
+static inline size_t block_size(const heap_block_t *block)
+{
+    return block->size & ~HEAP_FREE_BIT;
+}
+
+static inline uint8_t block_is_free(const heap_block_t *block)
+{
+    return (block->size & HEAP_FREE_BIT) != 0;
+}
+
+static inline heap_block_t *block_next(const heap_block_t *block)
+{
+    return (heap_block_t *)((uint8_t *)block + HEAP_HDR + block_size(block));
+}
+
+static inline void *block_to_ptr(heap_block_t *block)
+{
+    return (uint8_t *)block + HEAP_HDR;
+}
+
+static inline heap_block_t *block_from_ptr(void *ptr)
+{
+    return (heap_block_t *)((uint8_t *)ptr - HEAP_HDR);
+}
+
+/* 块大小所在的档位 */
+static inline void mapping_insert(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size < HEAP_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)size >> HEAP_ALIGN_LOG2;
+    } else {
+        uint32_t f = heap_fls((uint32_t)size);
+        *sl = ((uint32_t)size >> (f - HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+        *fl = f - (HEAP_FL_SHIFT - 1U);
+    }
+}
+
+/* 请求大小向上取整到档位上界，该档中任意块都满足请求 */
+static inline void mapping_search(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= HEAP_SMALL_SIZE) {
+        size += ((size_t)1 << (heap_fls((uint32_t)size) - HEAP_SL_LOG2)) - 1U;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static heap_block_t *find_suitable(uint32_t fl, uint32_t sl)
+{
+    uint32_t sl_map;
+
+    if (fl >= HEAP_FL_COUNT) {
+        return NULL;
+    }
+    sl_map = heap_ctrl.sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = (fl + 1U < 32U) ? (heap_ctrl.fl_bitmap & (~0U << (fl + 1U))) : 0;
+        if (fl_map == 0) {
+            return NULL;
+        }
+        fl = heap_ffs(fl_map);
+        sl_map = heap_ctrl.sl_bitmap[fl];
+    }
+    sl = heap_ffs(sl_map);
+    return heap_ctrl.blocks[fl][sl];
+}
+
+static void free_list_insert(heap_block_t *block)
+{
+    uint32_t fl, sl;
+    heap_block_t *head;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    head = heap_ctrl.blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head != NULL) {
+        head->prev_free = block;
+    }
+    heap_ctrl.blocks[fl][sl] = block;
+    heap_ctrl.fl_bitmap |= 1U << fl;
+    heap_ctrl.sl_bitmap[fl] |= 1U << sl;
+    block->size |= HEAP_FREE_BIT;
+    heap_stats.free_blocks++;
+}
+
+static void free_list_remove(heap_block_t *block)
+{
+    uint32_t fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    if (block->prev_free != NULL) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        heap_ctrl.blocks[fl][sl] = block->next_free;
+        if (block->next_free == NULL) {
+            heap_ctrl.sl_bitmap[fl] &= ~(1U << sl);
+            if (heap_ctrl.sl_bitmap[fl] == 0) {
+                heap_ctrl.fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+    if (block->next_free != NULL) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    block->size &= ~HEAP_FREE_BIT;
+    heap_stats.free_blocks--;
+}
+
+static void heap_init(void)
+{
+    heap_block_t *first = (heap_block_t *)heap_pool;
+    heap_block_t *sentinel;
+    /* 哨兵块只用到头部，但按完整结构体预留，避免越界访问 */
+    size_t size = (OSAL_HEAP_SIZE - HEAP_HDR - sizeof(heap_block_t)) & ~(size_t)(HEAP_ALIGN - 1U);
+
+    first->prev_phys = NULL;
+    first->size = size;
+    sentinel = block_next(first);
+    sentinel->prev_phys = first;
+    sentinel->size = 0;
+    free_list_insert(first);
+
+    heap_stats.total = (uint32_t)(size + HEAP_HDR);
+    heap_ready = 1;
+}
+
+void *osal_malloc(size_t size)
+{
+    osal_critical_state_t crit;
+    heap_block_t *block = NULL;
+    uint32_t fl, sl;
+
+    if (size == 0 || size > HEAP_ALLOC_MAX) {
+        return NULL;
+    }
+    size = HEAP_ALIGN_UP(size);
+    if (size < HEAP_BLOCK_MIN) {
+        size = HEAP_BLOCK_MIN;
+    }
+
+    osal_enter_critical(&crit);
+    uint32_t start = HEAP_CYCLES();
+    if (!heap_ready) {
+        heap_init();
+    }
+
+    mapping_search(size, &fl, &sl);
+    block = find_suitable(fl, sl);
+    if (block == NULL) {
+        /* 向上取整后没有可用档位时，再看请求所在档位的表头是否刚好够用(只检查一块，仍是O(1)) */
+        mapping_insert(size, &fl, &sl);
+        block = heap_ctrl.blocks[fl][sl];
+        if (block != NULL && block_size(block) < size) {
+            block = NULL;
+        }
+    }
+    if (block != NULL) {
+        free_list_remove(block);
+        /* 剩余部分放得下一个最小块时切分出来放回空闲链表 */
+        size_t remain = block_size(block) - size;
+        if (remain >= HEAP_HDR + HEAP_BLOCK_MIN) {
+            heap_block_t *rest = (heap_block_t *)((uint8_t *)block_to_ptr(block) + size);
+            rest->prev_phys = block;
+            rest->size = remain - HEAP_HDR;
+            block_next(rest)->prev_phys = rest;
+            block->size = size;
+            free_list_insert(rest);
+        }
+        heap_stats.used += (uint32_t)(block_size(block) + HEAP_HDR);
+        if (heap_stats.used > heap_stats.peak) {
+            heap_stats.peak = heap_stats.used;
+        }
+        heap_stats.alloc_count++;
+    } else {
+        heap_stats.fail_count++;
+    }
+
+    uint32_t cycles = HEAP_CYCLES() - start;
+    if (cycles > heap_stats.alloc_cycles_max) {
+        heap_stats.alloc_cycles_max = cycles;
+    }
+    osal_exit_critical(&crit);
+
+    return (block != NULL) ? block_to_ptr(block) : NULL;
+}
+
+void osal_free(void *ptr)
+{
+    osal_critical_state_t crit;
+    heap_block_t *block, *neighbor;
+
+    if (ptr == NULL || (uint8_t *)ptr < heap_pool + HEAP_HDR || (uint8_t *)ptr >= heap_pool + OSAL_HEAP_SIZE) {
+        return;
+    }
+    block = block_from_ptr(ptr);
+
+    osal_enter_critical(&crit);
+    if (!heap_ready || block_is_free(block)) {
+        osal_exit_critical(&crit);
+        return;
+    }
+    uint32_t start = HEAP_CYCLES();
+
+    heap_stats.used -= (uint32_t)(block_size(block) + HEAP_HDR);
+    heap_stats.free_count++;
+
+    /* 与前后相邻的空闲块合并 */
+    neighbor = block->prev_phys;
+    if (neighbor != NULL && block_is_free(neighbor)) {
+        free_list_remove(neighbor);
+        neighbor->size += HEAP_HDR + block_size(block);
+        block = neighbor;
+        block_next(block)->prev_phys = block;
+    }
+    neighbor = block_next(block);
+    if (block_is_free(neighbor)) {
+        free_list_remove(neighbor);
+        block->size += HEAP_HDR + block_size(neighbor);
+        block_next(block)->prev_phys = block;
+    }
+    free_list_insert(block);
+
+    uint32_t cycles = HEAP_CYCLES() - start;
+    if (cycles > heap_stats.free_cycles_max) {
+        heap_stats.free_cycles_max = cycles;
+    }
+    osal_exit_critical(&crit);
+}
+
+osal_status_t osal_heap_stats_get(osal_heap_stats_t *stats)
+{
+    osal_critical_state_t crit;
+
+    if (stats == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    osal_enter_critical(&crit);
+    if (!heap_ready) {
+        heap_init();
+    }
+    *stats = heap_stats;
+    /* 最大空闲块在最高的非空档位中，只需遍历这一条链表 */
+    stats->largest_free = 0;
+    if (heap_ctrl.fl_bitmap != 0) {
+        uint32_t fl = heap_fls(heap_ctrl.fl_bitmap);
+        uint32_t sl = heap_fls(heap_ctrl.sl_bitmap[fl]);
+        for (heap_block_t *block = heap_ctrl.blocks[fl][sl]; block != NULL; block = block->next_free) {
+            if (block_size(block) > stats->largest_free) {
+                stats->largest_free = (uint32_t)block_size(block);
+            }
+        }
+    }
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+void osal_heap_stats_reset(void)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    heap_stats.peak = heap_stats.used;
+    heap_stats.alloc_count = 0;
+    heap_stats.free_count = 0;
+    heap_stats.fail_count = 0;
+    heap_stats.alloc_cycles_max = 0;
+    heap_stats.free_cycles_max = 0;
+    osal_exit_critical(&crit);
+}
@@ -0,0 +1,89 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-20 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-20 14:00:00
+ * @FilePath: /rm_base/OSAL/osal_heap.h
+ * @Description: TLSF(两级分离适配)堆分配器，分配与释放都是O(1)，最坏耗时有界
+ */
+#ifndef __OSAL_HEAP_H__
+#define __OSAL_HEAP_H__
+
+#include "osal_def.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 堆大小(字节) */
+#ifndef OSAL_HEAP_SIZE
+#define OSAL_HEAP_SIZE          8192
+#endif
+
+/* 堆内存区域 */
+#ifndef OSAL_HEAP_SECTION
+#define OSAL_HEAP_SECTION
+#endif
+
+/* 一级索引覆盖的最大块大小为2^OSAL_HEAP_MAX_LOG2，堆大小不能超过它；每增加1多占16个链表头 */
+#ifndef OSAL_HEAP_MAX_LOG2
+#define OSAL_HEAP_MAX_LOG2      16
+#endif
+
+/* 记录单次分配/释放的最长耗时，ThreadX下读DWT只需一个周期；POSIX下osal_cycle_get是系统调用，主机性能测试中关闭 */
+#ifndef OSAL_HEAP_TIMING_ENABLE
+#define OSAL_HEAP_TIMING_ENABLE 1
+#endif
+
+#if (OSAL_HEAP_SIZE) > (1UL << (OSAL_HEAP_MAX_LOG2))
+#error "OSAL_HEAP_SIZE exceeds 2^OSAL_HEAP_MAX_LOG2"
+#endif
+
+/* 统计，used/peak包含每块的头部开销，时间单位为osal_cycle_get的周期数 */
+typedef struct {
+    uint32_t total;             /* 可分配总字节数 */
+    uint32_t used;              /* 已分配字节数 */
+    uint32_t peak;              /* 已分配字节数峰值 */
+    uint32_t free_blocks;       /* 空闲块数 */
+    uint32_t largest_free;      /* 最大空闲块，碎片率 = 1 - largest_free / (total - used) */
+    uint32_t alloc_count;       /* 成功分配次数 */
+    uint32_t free_count;        /* 释放次数 */
+    uint32_t fail_count;        /* 分配失败次数 */
+    uint32_t alloc_cycles_max;  /* 单次分配最长耗时，OSAL_HEAP_TIMING_ENABLE为0时恒为0 */
+    uint32_t free_cycles_max;   /* 单次释放最长耗时，同上 */
+} osal_heap_stats_t;
+
+/**
+ * @description: 分配内存，返回地址8字节对齐；首次调用时初始化堆，可在中断中调用
+ * @param {size_t} size, 字节数
+ * @return {void*} 成功返回内存地址，失败或size为0返回NULL
+ */
+void *osal_malloc(size_t size);
+
+/**
+ * @description: 释放osal_malloc分配的内存，NULL、堆外地址和重复释放会被忽略；可在中断中调用
+ * @param {void*} ptr, 内存地址
+ * @return {*}
+ */
+void osal_free(void *ptr);
+
+/**
+ * @description: 获取统计
+ * @param {osal_heap_stats_t*} stats, 输出统计
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_heap_stats_get(osal_heap_stats_t *stats);
+
+/**
+ * @description: 清零计数与最长耗时，峰值重置为当前已分配字节数
+ * @return {*}
+ */
+void osal_heap_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_HEAP_H__ */
@@ -0,0 +1,269 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-18 10:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-18 10:00:00
+ * @FilePath: /rm_base/OSAL/osal_hmutex.c
+ * @Description: 混合互斥量实现
+ */
+#include "osal_hmutex.h"
+#include "osal_lockstat.h"
+
+/* 当前线程标识与优先级操作，只在慢路径中使用优先级 */
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+
+static inline uintptr_t hmutex_self(void)
+{
+    return (uintptr_t)tx_thread_identify();
+}
+
+static inline osal_thread_priority_t hmutex_priority_get(uintptr_t thread)
+{
+    return ((TX_THREAD *)thread)->tx_thread_priority;
+}
+
+static inline void hmutex_priority_set(uintptr_t thread, osal_thread_priority_t priority)
+{
+    UINT old_priority;
+    tx_thread_priority_change((TX_THREAD *)thread, priority, &old_priority);
+}
+
+/* ThreadX数值越小优先级越高 */
+#define HMUTEX_PRIO_HIGHER(a, b)    ((a) < (b))
+
+#elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+
+static inline uintptr_t hmutex_self(void)
+{
+    return (uintptr_t)xTaskGetCurrentTaskHandle();
+}
+
+static inline osal_thread_priority_t hmutex_priority_get(uintptr_t thread)
+{
+    return uxTaskPriorityGet((TaskHandle_t)thread);
+}
+
+static inline void hmutex_priority_set(uintptr_t thread, osal_thread_priority_t priority)
+{
+    vTaskPrioritySet((TaskHandle_t)thread, priority);
+}
+
+/* FreeRTOS数值越大优先级越高 */
+#define HMUTEX_PRIO_HIGHER(a, b)    ((a) > (b))
+
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+
+/* 主机上线程按普通调度策略运行，不做优先级提升 */
+static inline uintptr_t hmutex_self(void)
+{
+    return (uintptr_t)pthread_self();
+}
+
+static inline osal_thread_priority_t hmutex_priority_get(uintptr_t thread)
+{
+    (void)thread;
+    return 0;
+}
+
+static inline void hmutex_priority_set(uintptr_t thread, osal_thread_priority_t priority)
+{
+    (void)thread;
+    (void)priority;
+}
+
+#define HMUTEX_PRIO_HIGHER(a, b)    ((a) < (b))
+
+#endif
+
+/* owner最低位：有线程在等待或持有者已被提升优先级，解锁时需要走慢路径 */
+#define HMUTEX_FLAG_CONTENDED   ((uintptr_t)1)
+
+static inline uint8_t hmutex_try_acquire(osal_hmutex_t *mutex, uintptr_t desired)
+{
+    uintptr_t expected = 0;
+    return __atomic_compare_exchange_n(&mutex->owner, &expected, desired, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/*
+ * 给持有者打上竞争标记，必要时把持有者优先级提升到当前线程的优先级。
+ * 在临界区中完成，与持有者的慢路径解锁互斥，保证boosted/saved_priority总是属于当前持有者。
+ * 返回0表示锁已被释放，调用者应重新尝试获取。
+ */
+static uint8_t hmutex_mark_owner(osal_hmutex_t *mutex, uintptr_t self)
+{
+    osal_critical_state_t crit;
+    uintptr_t owner, thread;
+    osal_thread_priority_t self_priority = hmutex_priority_get(self);
+
+    osal_enter_critical(&crit);
+    owner = __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED);
+    do {
+        if (owner == 0) {
+            osal_exit_critical(&crit);
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n(&mutex->owner, &owner, owner | HMUTEX_FLAG_CONTENDED, 0,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    thread = owner & ~HMUTEX_FLAG_CONTENDED;
+    if (HMUTEX_PRIO_HIGHER(self_priority, hmutex_priority_get(thread))) {
+        if (!mutex->boosted) {
+            mutex->saved_priority = hmutex_priority_get(thread);
+            mutex->boosted = 1;
+        }
+        hmutex_priority_set(thread, self_priority);
+    }
+    osal_exit_critical(&crit);
+    return 1;
+}
+
+/* 慢路径不内联，保持快路径的函数序言精简 */
+static __attribute__((noinline)) osal_status_t hmutex_lock_slow(osal_hmutex_t *mutex, uintptr_t self, osal_tick_t timeout)
+{
+    osal_status_t status = OSAL_TIMEOUT;
+    osal_tick_t start = osal_tick_get();
+    osal_tick_t elapsed, remaining;
+    uintptr_t desired;
+
+    mutex->slow_count++;
+    __atomic_add_fetch(&mutex->waiters, 1, __ATOMIC_SEQ_CST);
+    for (;;) {
+        /* 还有其他等待者时带着竞争标记获取，保证本线程解锁时会唤醒下一个 */
+        desired = self | ((__atomic_load_n(&mutex->waiters, __ATOMIC_SEQ_CST) > 1) ? HMUTEX_FLAG_CONTENDED : 0);
+        if (hmutex_try_acquire(mutex, desired)) {
+            status = OSAL_SUCCESS;
+            break;
+        }
+        if (timeout == OSAL_NO_WAIT) {
+            break;
+        }
+        /* 持有者恰好释放了锁则立即重试，否则持有者解锁时一定走慢路径释放wait_sem */
+        if (!hmutex_mark_owner(mutex, self)) {
+            continue;
+        }
+
+        remaining = OSAL_WAIT_FOREVER;
+        if (timeout != OSAL_WAIT_FOREVER) {
+            elapsed = osal_tick_get() - start;
+            if (elapsed >= timeout) {
+                break;
+            }
+            remaining = timeout - elapsed;
+        }
+        /* 被唤醒或超时后都回到循环开头重试一次 */
+        if (osal_sem_wait(&mutex->wait_sem, remaining) != OSAL_SUCCESS) {
+            timeout = OSAL_NO_WAIT;
+        }
+    }
+    __atomic_sub_fetch(&mutex->waiters, 1, __ATOMIC_SEQ_CST);
+    return status;
+}
+
+osal_status_t osal_hmutex_create(osal_hmutex_t *mutex, const char *name)
+{
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    mutex->owner = 0;
+    mutex->waiters = 0;
+    mutex->recursion = 0;
+    mutex->boosted = 0;
+    mutex->saved_priority = 0;
+    mutex->slow_count = 0;
+    if (osal_sem_create(&mutex->wait_sem, name, 0) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+#if OSAL_LOCK_STATS_ENABLE
+    osal_lockstat_register(mutex, name, OSAL_LOCKSTAT_MUTEX);
+#endif
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_hmutex_lock(osal_hmutex_t *mutex, osal_tick_t timeout)
+{
+    uintptr_t self;
+    osal_status_t status = OSAL_SUCCESS;
+
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    self = hmutex_self();
+    if (hmutex_try_acquire(mutex, self)) {
+        mutex->recursion = 1;
+#if OSAL_LOCK_STATS_ENABLE
+        osal_lockstat_record(mutex, OSAL_SUCCESS, 0, 0);
+        osal_lockstat_hold_begin(mutex);
+#endif
+        return OSAL_SUCCESS;
+    }
+    if ((mutex->owner & ~HMUTEX_FLAG_CONTENDED) == self) {
+        mutex->recursion++;
+        return OSAL_SUCCESS;
+    }
+
+#if OSAL_LOCK_STATS_ENABLE
+    uint32_t wait_start = osal_cycle_get();
+    status = hmutex_lock_slow(mutex, self, timeout);
+    osal_lockstat_record(mutex, status, timeout != OSAL_NO_WAIT, osal_cycle_get() - wait_start);
+    if (status == OSAL_SUCCESS) {
+        osal_lockstat_hold_begin(mutex);
+    }
+#else
+    status = hmutex_lock_slow(mutex, self, timeout);
+#endif
+    if (status == OSAL_SUCCESS) {
+        mutex->recursion = 1;
+    }
+    return status;
+}
+
+osal_status_t osal_hmutex_unlock(osal_hmutex_t *mutex)
+{
+    osal_critical_state_t crit;
+    uintptr_t self, expected;
+
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    self = hmutex_self();
+    if ((mutex->owner & ~HMUTEX_FLAG_CONTENDED) != self) {
+        return OSAL_ERROR;
+    }
+    if (--mutex->recursion != 0) {
+        return OSAL_SUCCESS;
+    }
+
+#if OSAL_LOCK_STATS_ENABLE
+    osal_lockstat_hold_end(mutex);
+#endif
+    /* 无竞争标记时一次CAS完成解锁 */
+    expected = self;
+    if (__atomic_compare_exchange_n(&mutex->owner, &expected, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        return OSAL_SUCCESS;
+    }
+
+    /* 有竞争：恢复优先级与释放锁在同一临界区内完成，然后唤醒一个等待者 */
+    osal_enter_critical(&crit);
+    __atomic_store_n(&mutex->owner, 0, __ATOMIC_SEQ_CST);
+    if (mutex->boosted) {
+        mutex->boosted = 0;
+        hmutex_priority_set(self, mutex->saved_priority);
+    }
+    osal_exit_critical(&crit);
+    osal_sem_post(&mutex->wait_sem);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_hmutex_delete(osal_hmutex_t *mutex)
+{
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+#if OSAL_LOCK_STATS_ENABLE
+    osal_lockstat_unregister(mutex);
+#endif
+    return osal_sem_delete(&mutex->wait_sem);
+}
@@ -0,0 +1,69 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-18 10:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-18 10:00:00
+ * @FilePath: /rm_base/OSAL/osal_hmutex.h
+ * @Description: 混合互斥量，无竞争时只用原子操作加解锁，发生竞争时才进入内核等待，并提升持有者优先级
+ */
+#ifndef __OSAL_HMUTEX_H__
+#define __OSAL_HMUTEX_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * owner为持有者线程标识，0表示空闲，最低位为竞争标记。无竞争时加锁、解锁各为一次CAS(Cortex-M4上为LDREX/STREX)。
+ * 加锁失败的线程计入waiters，给持有者打上竞争标记后阻塞在wait_sem上，阻塞前若自身优先级高于持有者则提升持有者优先级。
+ * 带竞争标记的解锁走慢路径：恢复原优先级并释放wait_sem唤醒一个等待者重新竞争。
+ * 支持同一线程嵌套加锁；不可在中断中使用。
+ */
+typedef struct {
+    volatile uintptr_t owner;               /* 持有者线程标识|竞争标记，0表示空闲 */
+    volatile uint32_t waiters;              /* 慢路径中的等待线程数 */
+    uint32_t recursion;                     /* 嵌套加锁次数 */
+    uint8_t boosted;                        /* 持有者优先级已被提升 */
+    osal_thread_priority_t saved_priority;  /* 提升前持有者的优先级 */
+    osal_sem_t wait_sem;                    /* 等待者阻塞用 */
+    uint32_t slow_count;                    /* 进入慢路径的次数 */
+} osal_hmutex_t;
+
+/**
+ * @description: 创建混合互斥量
+ * @param {osal_hmutex_t*} mutex, 互斥量指针
+ * @param {const char*} name, 名称
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 失败
+ */
+osal_status_t osal_hmutex_create(osal_hmutex_t *mutex, const char *name);
+
+/**
+ * @description: 加锁
+ * @param {osal_hmutex_t*} mutex, 互斥量指针
+ * @param {osal_tick_t} timeout, 超时时间
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 超时, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_hmutex_lock(osal_hmutex_t *mutex, osal_tick_t timeout);
+
+/**
+ * @description: 解锁
+ * @param {osal_hmutex_t*} mutex, 互斥量指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 当前线程不是持有者, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_hmutex_unlock(osal_hmutex_t *mutex);
+
+/**
+ * @description: 删除混合互斥量
+ * @param {osal_hmutex_t*} mutex, 互斥量指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_hmutex_delete(osal_hmutex_t *mutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_HMUTEX_H__ */
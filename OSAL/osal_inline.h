@@ -0,0 +1,208 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-20 10:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-20 10:00:00
+ * @FilePath: /rm_base/OSAL/osal_inline.h
+ * @Description: 内联模式，热路径接口展开为static inline包装，直接调用tx_*，省去函数调用与参数检查
+ */
+#ifndef __OSAL_INLINE_H__
+#define __OSAL_INLINE_H__
+
+/*
+ * 由osal_def.h在OSAL_INLINE_ENABLE=1时包含，不要直接包含本文件。
+ * 映射用函数式宏实现：osal_sem_post(sem)展开为内联版本，不带括号的osal_sem_post(取函数地址)仍然是库中的函数实体，
+ * OSAL库照常编译全部外部函数，未开启内联模式编译的代码和已有目标文件不受影响。
+ * 只有ThreadX后端提供内联版本；开启锁竞争统计、中断屏蔽统计时，对应接口仍走库中带统计的实现。
+ */
+
+#include "osal_def.h"
+
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+
+#include "stm32f4xx.h"  /* DWT->CYCCNT */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 内联版本的参数检查，由CMake在Debug构建中打开 */
+#ifndef OSAL_INLINE_PARAM_CHECK
+#define OSAL_INLINE_PARAM_CHECK     0
+#endif
+
+#if OSAL_INLINE_PARAM_CHECK
+#define OSAL_INLINE_CHECK(cond)     do { if (!(cond)) { return OSAL_INVALID_PARAM; } } while (0)
+#else
+#define OSAL_INLINE_CHECK(cond)     ((void)0)
+#endif
+
+/* 与osal_waitany.h中的默认值保持一致 */
+#ifndef OSAL_WAIT_ANY_ENABLE
+#define OSAL_WAIT_ANY_ENABLE        1
+#endif
+
+#if OSAL_WAIT_ANY_ENABLE
+/* 与osal_waitany_notify相同，这里不能包含osal_waitany.h(它依赖本文件所在的osal_def.h) */
+extern volatile uint32_t osal_waitany_active;
+void osal_waitany_notify_slow(const void *obj);
+#define OSAL_INLINE_NOTIFY(obj) \
+    do { __atomic_thread_fence(__ATOMIC_SEQ_CST); \
+         if (__atomic_load_n(&osal_waitany_active, __ATOMIC_RELAXED) != 0) { osal_waitany_notify_slow(obj); } } while (0)
+#else
+#define OSAL_INLINE_NOTIFY(obj)     ((void)0)
+#endif
+
+/* OSAL_WAIT_FOREVER与TX_WAIT_FOREVER都是全1，超时直接传给tx_* */
+
+static inline osal_status_t osal_inline_sem_post(osal_sem_t *sem)
+{
+    OSAL_INLINE_CHECK(sem != NULL);
+    if (tx_semaphore_put((TX_SEMAPHORE *)sem) != TX_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    OSAL_INLINE_NOTIFY(sem);
+    return OSAL_SUCCESS;
+}
+
+static inline osal_status_t osal_inline_sem_wait(osal_sem_t *sem, osal_tick_t timeout)
+{
+    OSAL_INLINE_CHECK(sem != NULL);
+    UINT result = tx_semaphore_get((TX_SEMAPHORE *)sem, timeout);
+    return (result == TX_SUCCESS) ? OSAL_SUCCESS : (result == TX_NO_INSTANCE) ? OSAL_TIMEOUT : OSAL_ERROR;
+}
+
+static inline osal_status_t osal_inline_mutex_lock(osal_mutex_t *mutex, osal_tick_t timeout)
+{
+    OSAL_INLINE_CHECK(mutex != NULL);
+    UINT result = tx_mutex_get((TX_MUTEX *)mutex, timeout);
+    return (result == TX_SUCCESS) ? OSAL_SUCCESS : (result == TX_NOT_AVAILABLE) ? OSAL_TIMEOUT : OSAL_ERROR;
+}
+
+static inline osal_status_t osal_inline_mutex_unlock(osal_mutex_t *mutex)
+{
+    OSAL_INLINE_CHECK(mutex != NULL);
+    return (tx_mutex_put((TX_MUTEX *)mutex) == TX_SUCCESS) ? OSAL_SUCCESS : OSAL_ERROR;
+}
+
+static inline osal_status_t osal_inline_event_set(osal_event_t *event, unsigned int flags)
+{
+    OSAL_INLINE_CHECK(event != NULL);
+    if (tx_event_flags_set((TX_EVENT_FLAGS_GROUP *)event, (ULONG)flags, TX_OR) != TX_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    OSAL_INLINE_NOTIFY(event);
+    return OSAL_SUCCESS;
+}
+
+static inline osal_status_t osal_inline_event_wait(osal_event_t *event, unsigned int requested_flags,
+                                                   unsigned int options, osal_tick_t timeout, unsigned int *actual_flags)
+{
+    ULONG actual_flags_local;
+    UINT get_option;
+
+    OSAL_INLINE_CHECK(event != NULL);
+    /* options通常是常量，选项换算在编译期完成 */
+    if (options & OSAL_EVENT_WAIT_FLAG_OR) {
+        get_option = (options & OSAL_EVENT_WAIT_FLAG_CLEAR) ? TX_OR_CLEAR : TX_OR;
+    } else {
+        get_option = (options & OSAL_EVENT_WAIT_FLAG_CLEAR) ? TX_AND_CLEAR : TX_AND;
+    }
+    UINT result = tx_event_flags_get((TX_EVENT_FLAGS_GROUP *)event, (ULONG)requested_flags,
+                                     get_option, &actual_flags_local, timeout);
+    if (actual_flags != NULL) {
+        *actual_flags = (unsigned int)actual_flags_local;
+    }
+    return (result == TX_SUCCESS) ? OSAL_SUCCESS : (result == TX_NO_EVENTS) ? OSAL_TIMEOUT : OSAL_ERROR;
+}
+
+static inline osal_status_t osal_inline_event_clear(osal_event_t *event, unsigned int flags)
+{
+    /* 与osal_event.c相同，ThreadX下标志在wait中清除 */
+    (void)event;
+    (void)flags;
+    OSAL_INLINE_CHECK(event != NULL);
+    return OSAL_SUCCESS;
+}
+
+static inline osal_status_t osal_inline_queue_send(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout)
+{
+    OSAL_INLINE_CHECK(queue != NULL && msg_ptr != NULL);
+    UINT result = tx_queue_send((TX_QUEUE *)queue, msg_ptr, timeout);
+    if (result != TX_SUCCESS) {
+        return (result == TX_QUEUE_FULL) ? OSAL_TIMEOUT : OSAL_ERROR;
+    }
+    OSAL_INLINE_NOTIFY(queue);
+    return OSAL_SUCCESS;
+}
+
+static inline osal_status_t osal_inline_queue_recv(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout)
+{
+    OSAL_INLINE_CHECK(queue != NULL && msg_ptr != NULL);
+    UINT result = tx_queue_receive((TX_QUEUE *)queue, msg_ptr, timeout);
+    return (result == TX_SUCCESS) ? OSAL_SUCCESS : (result == TX_QUEUE_EMPTY) ? OSAL_TIMEOUT : OSAL_ERROR;
+}
+
+static inline osal_status_t osal_inline_enter_critical(osal_critical_state_t *crit)
+{
+    OSAL_INLINE_CHECK(crit != NULL);
+    TX_INTERRUPT_SAVE_AREA
+    TX_DISABLE
+    *crit = interrupt_save;
+    return OSAL_SUCCESS;
+}
+
+static inline osal_status_t osal_inline_exit_critical(osal_critical_state_t *crit)
+{
+    OSAL_INLINE_CHECK(crit != NULL);
+    TX_INTERRUPT_SAVE_AREA
+    interrupt_save = *crit;
+    TX_RESTORE
+    return OSAL_SUCCESS;
+}
+
+static inline osal_tick_t osal_inline_tick_get(void)
+{
+    return tx_time_get();
+}
+
+static inline uint32_t osal_inline_cycle_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* OSAL库中实现这些接口的源文件定义OSAL_INLINE_IMPL，不做映射 */
+#ifndef OSAL_INLINE_IMPL
+
+#define osal_sem_post(sem)                      osal_inline_sem_post(sem)
+#define osal_event_set(event, flags)            osal_inline_event_set(event, flags)
+#define osal_event_clear(event, flags)          osal_inline_event_clear(event, flags)
+#define osal_queue_send(queue, msg, timeout)    osal_inline_queue_send(queue, msg, timeout)
+#define osal_tick_get()                         osal_inline_tick_get()
+#define osal_cycle_get()                        osal_inline_cycle_get()
+
+/* 锁竞争统计在库函数中记录 */
+#if !OSAL_LOCK_STATS_ENABLE
+#define osal_sem_wait(sem, timeout)             osal_inline_sem_wait(sem, timeout)
+#define osal_mutex_lock(mutex, timeout)         osal_inline_mutex_lock(mutex, timeout)
+#define osal_mutex_unlock(mutex)                osal_inline_mutex_unlock(mutex)
+#define osal_event_wait(event, flags, options, timeout, actual) \
+                                                osal_inline_event_wait(event, flags, options, timeout, actual)
+#define osal_queue_recv(queue, msg, timeout)    osal_inline_queue_recv(queue, msg, timeout)
+#endif
+
+/* 中断屏蔽时长统计在库函数中记录 */
+#if !OSAL_CRITICAL_STATS_ENABLE
+#define osal_enter_critical(crit)               osal_inline_enter_critical(crit)
+#define osal_exit_critical(crit)                osal_inline_exit_critical(crit)
+#endif
+
+#endif /* OSAL_INLINE_IMPL */
+
+#endif /* OSAL_RTOS_TYPE == OSAL_THREADX */
+
+#endif /* __OSAL_INLINE_H__ */
@@ -7,10 +7,77 @@
  * @Description: OSAL中断管理接口实现
  */
 
+#define OSAL_INLINE_IMPL    /* 本文件提供库中的函数实体，不使用osal_inline.h的映射 */
 #include "osal_def.h"
 
+#if (OSAL_RTOS_TYPE != OSAL_POSIX)
+#include "stm32f4xx.h"  /* __NVIC_PRIO_BITS, __get_IPSR, NVIC_GetPriority */
+#endif
+
+#if OSAL_CRITICAL_STATS_ENABLE
+
+/* 统计变量只在临界区内修改，临界区之间互斥，不需要额外保护 */
+static uint32_t critical_nesting = 0;
+static uint32_t critical_start = 0;
+static void *critical_caller = NULL;
+static osal_critical_stats_t critical_stats = {0};
+
+/* 进入最外层临界区时记录起始周期，在中断屏蔽之后调用 */
+static inline void critical_stats_enter(void *caller)
+{
+#if (OSAL_RTOS_TYPE == OSAL_THREADX) && OSAL_CRITICAL_BASEPRI_ENABLE
+    /* 零延迟中断不受BASEPRI屏蔽，在其中调用临界区说明中断优先级配置错误 */
+    uint32_t ipsr = __get_IPSR();
+    if (ipsr != 0 && NVIC_GetPriority((IRQn_Type)((int32_t)ipsr - 16)) < OSAL_CRITICAL_BASEPRI_PRIORITY) {
+        critical_stats.isr_violation++;
+    }
+#endif
+    if (critical_nesting++ == 0) {
+        critical_caller = caller;
+        critical_start = osal_cycle_get();
+    }
+}
+
+/* 退出最外层临界区时更新屏蔽时长，在中断恢复之前调用 */
+static inline void critical_stats_exit(void)
+{
+    if (critical_nesting == 0 || --critical_nesting != 0) {
+        return;
+    }
+    uint32_t cycles = osal_cycle_get() - critical_start;
+    critical_stats.count++;
+    critical_stats.total_cycles += cycles;
+    if (cycles > critical_stats.max_cycles) {
+        critical_stats.max_cycles = cycles;
+        critical_stats.max_caller = critical_caller;
+    }
+}
+
+#define CRITICAL_STATS_ENTER()  critical_stats_enter(__builtin_return_address(0))
+#define CRITICAL_STATS_EXIT()   critical_stats_exit()
+
+#else
+
+#define CRITICAL_STATS_ENTER()
+#define CRITICAL_STATS_EXIT()
+
+#endif /* OSAL_CRITICAL_STATS_ENABLE */
+
 #if (OSAL_RTOS_TYPE == OSAL_THREADX)
 
+/* BASEPRI模式下TX_DISABLE由ThreadX移植层写BASEPRI，OSAL与内核必须使用同一个屏蔽阈值 */
+#if OSAL_CRITICAL_BASEPRI_ENABLE
+#ifndef TX_PORT_USE_BASEPRI
+#error "OSAL_CRITICAL_BASEPRI_ENABLE requires TX_PORT_USE_BASEPRI"
+#endif
+#if (TX_PORT_BASEPRI) != ((OSAL_CRITICAL_BASEPRI_PRIORITY) << (8 - __NVIC_PRIO_BITS))
+#error "TX_PORT_BASEPRI does not match OSAL_CRITICAL_BASEPRI_PRIORITY"
+#endif
+#if (OSAL_CRITICAL_BASEPRI_PRIORITY) < 1 || (OSAL_CRITICAL_BASEPRI_PRIORITY) >= (1 << __NVIC_PRIO_BITS)
+#error "OSAL_CRITICAL_BASEPRI_PRIORITY out of range"
+#endif
+#endif
+
 /* ThreadX下的中断临界区实现 */
 osal_status_t osal_enter_critical(osal_critical_state_t *crit)
 {
@@ -22,6 +89,7 @@ osal_status_t osal_enter_critical(osal_critical_state_t *crit)
     TX_INTERRUPT_SAVE_AREA
     TX_DISABLE
     *crit = interrupt_save;
+    CRITICAL_STATS_ENTER();
     return OSAL_SUCCESS;
 }
 
@@ -33,6 +101,7 @@ osal_status_t osal_exit_critical(osal_critical_state_t *crit)
     
     /* 使用ThreadX宏方法恢复中断状态 */
     TX_INTERRUPT_SAVE_AREA
+    CRITICAL_STATS_EXIT();
     interrupt_save = *crit;
     TX_RESTORE
     return OSAL_SUCCESS;
@@ -56,6 +125,7 @@ osal_status_t osal_enter_critical(osal_critical_state_t *crit)
         taskENTER_CRITICAL();
         *crit = 0; /* 在任务环境中不需要保存状态 */
     }
+    CRITICAL_STATS_ENTER();
     return OSAL_SUCCESS;
 }
 
@@ -65,6 +135,7 @@ osal_status_t osal_exit_critical(osal_critical_state_t *crit)
         return OSAL_INVALID_PARAM;
     }
     
+    CRITICAL_STATS_EXIT();
     /* 判断是否在中断环境中 */
     if (xPortIsInsideInterrupt()) {
         /* 在中断中使用中断安全的API */
@@ -76,4 +147,62 @@ osal_status_t osal_exit_critical(osal_critical_state_t *crit)
     return OSAL_SUCCESS;
 }
 
-#endif
\ No newline at end of file
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+
+/* POSIX下没有中断，使用全局递归互斥量模拟临界区，保证临界区之间互斥且可嵌套 */
+static pthread_mutex_t osal_critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+osal_status_t osal_enter_critical(osal_critical_state_t *crit)
+{
+    if (crit == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&osal_critical_lock);
+    *crit = 0;
+    CRITICAL_STATS_ENTER();
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_exit_critical(osal_critical_state_t *crit)
+{
+    if (crit == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    CRITICAL_STATS_EXIT();
+    pthread_mutex_unlock(&osal_critical_lock);
+    return OSAL_SUCCESS;
+}
+
+#endif
+
+osal_status_t osal_critical_stats_get(osal_critical_stats_t *stats)
+{
+    if (stats == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+#if OSAL_CRITICAL_STATS_ENABLE
+    osal_critical_state_t crit;
+    osal_enter_critical(&crit);
+    *stats = critical_stats;
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+#else
+    return OSAL_ERROR;
+#endif
+}
+
+void osal_critical_stats_reset(void)
+{
+#if OSAL_CRITICAL_STATS_ENABLE
+    osal_critical_state_t crit;
+    osal_enter_critical(&crit);
+    critical_stats.count = 0;
+    critical_stats.max_cycles = 0;
+    critical_stats.total_cycles = 0;
+    critical_stats.max_caller = NULL;
+    critical_stats.isr_violation = 0;
+    osal_exit_critical(&crit);
+#endif
+}
@@ -0,0 +1,164 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-15 14:10:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-15 14:10:00
+ * @FilePath: /rm_base/OSAL/osal_lockstat.c
+ * @Description: OSAL同步原语竞争与等待时间统计实现
+ */
+#include "osal_lockstat.h"
+
+#if OSAL_LOCK_STATS_ENABLE
+
+#include <string.h>
+
+#if (OSAL_LOCKSTAT_MAX & (OSAL_LOCKSTAT_MAX - 1)) != 0
+#error "OSAL_LOCKSTAT_MAX must be a power of two"
+#endif
+
+/* 以对象地址为键的开放寻址哈希表，删除时留下墓碑保证探测链不断 */
+#define LOCKSTAT_TOMBSTONE   ((const void *)1)
+
+static osal_lockstat_t lockstat_table[OSAL_LOCKSTAT_MAX];
+
+static inline uint32_t lockstat_hash(const void *obj)
+{
+    uintptr_t key = (uintptr_t)obj;
+    return (uint32_t)((key >> 3) ^ (key >> 11)) & (OSAL_LOCKSTAT_MAX - 1);
+}
+
+static osal_lockstat_t *lockstat_find(const void *obj)
+{
+    uint32_t idx = lockstat_hash(obj);
+
+    for (uint32_t i = 0; i < OSAL_LOCKSTAT_MAX; i++) {
+        osal_lockstat_t *entry = &lockstat_table[(idx + i) & (OSAL_LOCKSTAT_MAX - 1)];
+        if (entry->obj == obj) {
+            return entry;
+        }
+        if (entry->obj == NULL) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+void osal_lockstat_register(const void *obj, const char *name, osal_lockstat_type_t type)
+{
+    osal_critical_state_t crit;
+    osal_lockstat_t *slot = NULL;
+    uint32_t idx = lockstat_hash(obj);
+
+    osal_enter_critical(&crit);
+    /* 重复创建同一对象时复用原条目 */
+    slot = lockstat_find(obj);
+    for (uint32_t i = 0; slot == NULL && i < OSAL_LOCKSTAT_MAX; i++) {
+        osal_lockstat_t *entry = &lockstat_table[(idx + i) & (OSAL_LOCKSTAT_MAX - 1)];
+        if (entry->obj == NULL || entry->obj == LOCKSTAT_TOMBSTONE) {
+            slot = entry;
+        }
+    }
+    if (slot != NULL) {
+        memset(slot, 0, sizeof(*slot));
+        slot->obj = obj;
+        slot->name = name;
+        slot->type = (uint8_t)type;
+    }
+    osal_exit_critical(&crit);
+}
+
+void osal_lockstat_unregister(const void *obj)
+{
+    osal_critical_state_t crit;
+    osal_lockstat_t *entry;
+
+    osal_enter_critical(&crit);
+    entry = lockstat_find(obj);
+    if (entry != NULL) {
+        entry->obj = LOCKSTAT_TOMBSTONE;
+    }
+    osal_exit_critical(&crit);
+}
+
+void osal_lockstat_record(const void *obj, osal_status_t status, uint8_t contended, uint32_t wait)
+{
+    osal_critical_state_t crit;
+    osal_lockstat_t *entry = lockstat_find(obj);
+
+    if (entry == NULL) {
+        return;
+    }
+
+    osal_enter_critical(&crit);
+    if (status == OSAL_SUCCESS) {
+        entry->acquire++;
+    } else {
+        entry->timeout++;
+    }
+    if (contended) {
+        entry->contended++;
+        entry->wait_total += wait;
+        if (wait > entry->wait_max) {
+            entry->wait_max = wait;
+        }
+    }
+    osal_exit_critical(&crit);
+}
+
+/* 持有时间只由持有者本身修改，不需要临界区 */
+void osal_lockstat_hold_begin(const void *obj)
+{
+    osal_lockstat_t *entry = lockstat_find(obj);
+
+    if (entry != NULL && entry->depth++ == 0) {
+        entry->hold_start = osal_cycle_get();
+    }
+}
+
+void osal_lockstat_hold_end(const void *obj)
+{
+    osal_lockstat_t *entry = lockstat_find(obj);
+    uint32_t hold;
+
+    if (entry == NULL || entry->depth == 0) {
+        return;
+    }
+    if (--entry->depth == 0) {
+        hold = osal_cycle_get() - entry->hold_start;
+        entry->hold_total += hold;
+        if (hold > entry->hold_max) {
+            entry->hold_max = hold;
+        }
+    }
+}
+
+const osal_lockstat_t *osal_lockstat_get(unsigned int index)
+{
+    if (index >= OSAL_LOCKSTAT_MAX) {
+        return NULL;
+    }
+    if (lockstat_table[index].obj == NULL || lockstat_table[index].obj == LOCKSTAT_TOMBSTONE) {
+        return NULL;
+    }
+    return &lockstat_table[index];
+}
+
+void osal_lockstat_reset(void)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    for (uint32_t i = 0; i < OSAL_LOCKSTAT_MAX; i++) {
+        osal_lockstat_t *entry = &lockstat_table[i];
+        entry->acquire = 0;
+        entry->contended = 0;
+        entry->timeout = 0;
+        entry->wait_max = 0;
+        entry->wait_total = 0;
+        entry->hold_max = 0;
+        entry->hold_total = 0;
+    }
+    osal_exit_critical(&crit);
+}
+
+#endif /* OSAL_LOCK_STATS_ENABLE */
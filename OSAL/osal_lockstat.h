@@ -0,0 +1,128 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-15 14:10:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-15 14:10:00
+ * @FilePath: /rm_base/OSAL/osal_lockstat.h
+ * @Description: OSAL同步原语竞争与等待时间统计(编译期开关，关闭时不产生任何代码)
+ */
+#ifndef __OSAL_LOCKSTAT_H__
+#define __OSAL_LOCKSTAT_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 统计开关，可在CMake中通过OSAL_LOCK_STATS选项打开 */
+#ifndef OSAL_LOCK_STATS_ENABLE
+#define OSAL_LOCK_STATS_ENABLE      0
+#endif
+
+/* 可统计的对象数量，必须是2的幂 */
+#ifndef OSAL_LOCKSTAT_MAX
+#define OSAL_LOCKSTAT_MAX           64
+#endif
+
+#if OSAL_LOCK_STATS_ENABLE
+
+typedef enum {
+    OSAL_LOCKSTAT_MUTEX = 0,
+    OSAL_LOCKSTAT_SEM,
+    OSAL_LOCKSTAT_EVENT,
+    OSAL_LOCKSTAT_QUEUE,
+} osal_lockstat_type_t;
+
+/* 时间单位为osal_cycle_get()的计数，MCU上为DWT周期，主机上为纳秒 */
+typedef struct {
+    const void *obj;            /* 对象地址，NULL表示空闲 */
+    const char *name;           /* 对象名称 */
+    uint8_t type;               /* osal_lockstat_type_t */
+    uint16_t depth;             /* 互斥量嵌套深度 */
+    uint32_t hold_start;        /* 互斥量最外层加锁时刻 */
+    uint32_t acquire;           /* 成功获取次数 */
+    uint32_t contended;         /* 需要阻塞等待的次数 */
+    uint32_t timeout;           /* 等待超时/失败次数 */
+    uint32_t wait_max;          /* 最大阻塞时间 */
+    uint64_t wait_total;        /* 累计阻塞时间 */
+    uint32_t hold_max;          /* 互斥量最大持有时间 */
+    uint64_t hold_total;        /* 互斥量累计持有时间 */
+} osal_lockstat_t;
+
+/**
+ * @description: 对象创建成功后登记
+ * @param {const void*} obj, 对象地址
+ * @param {const char*} name, 对象名称
+ * @param {osal_lockstat_type_t} type, 对象类型
+ * @return {*}
+ */
+void osal_lockstat_register(const void *obj, const char *name, osal_lockstat_type_t type);
+
+/**
+ * @description: 对象删除时注销
+ * @param {const void*} obj, 对象地址
+ * @return {*}
+ */
+void osal_lockstat_unregister(const void *obj);
+
+/**
+ * @description: 记录一次获取/等待结果
+ * @param {const void*} obj, 对象地址
+ * @param {osal_status_t} status, 获取结果
+ * @param {uint8_t} contended, 是否发生了阻塞
+ * @param {uint32_t} wait, 阻塞时间
+ * @return {*}
+ */
+void osal_lockstat_record(const void *obj, osal_status_t status, uint8_t contended, uint32_t wait);
+
+/**
+ * @description: 互斥量加锁/解锁时记录持有时间，仅最外层计入
+ * @param {const void*} obj, 互斥量地址
+ * @return {*}
+ */
+void osal_lockstat_hold_begin(const void *obj);
+void osal_lockstat_hold_end(const void *obj);
+
+/**
+ * @description: 按序号遍历统计表
+ * @param {unsigned int} index, 0 ~ OSAL_LOCKSTAT_MAX-1
+ * @return {osal_lockstat_t*} 已登记的条目，空闲位置返回NULL
+ */
+const osal_lockstat_t *osal_lockstat_get(unsigned int index);
+
+/**
+ * @description: 清零所有统计数据(保留登记信息)
+ * @return {*}
+ */
+void osal_lockstat_reset(void);
+
+/*
+ * 统一的等待包装：先以OSAL_NO_WAIT尝试，失败且允许等待时才计为一次竞争并计时阻塞时间。
+ * call为以_lockstat_timeout作为超时参数的原始调用表达式。
+ */
+#define OSAL_LOCKSTAT_WAIT(status, obj, timeout, call)                          \
+    do {                                                                        \
+        osal_tick_t _lockstat_timeout = OSAL_NO_WAIT;                           \
+        uint8_t _lockstat_contended = 0;                                        \
+        uint32_t _lockstat_start = 0;                                           \
+        (status) = (call);                                                      \
+        if ((status) != OSAL_SUCCESS && (status) != OSAL_INVALID_PARAM &&       \
+            (timeout) != OSAL_NO_WAIT) {                                        \
+            _lockstat_contended = 1;                                            \
+            _lockstat_timeout = (timeout);                                      \
+            _lockstat_start = osal_cycle_get();                                 \
+            (status) = (call);                                                  \
+        }                                                                       \
+        osal_lockstat_record((obj), (status), _lockstat_contended,              \
+                             _lockstat_contended ? osal_cycle_get() - _lockstat_start : 0); \
+    } while (0)
+
+#endif /* OSAL_LOCK_STATS_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_LOCKSTAT_H__ */
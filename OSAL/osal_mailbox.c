@@ -0,0 +1,124 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-22 09:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-22 09:00:00
+ * @FilePath: /rm_base/OSAL/osal_mailbox.c
+ * @Description: 最新值邮箱实现
+ */
+#include "osal_mailbox.h"
+
+osal_status_t osal_mailbox_create(osal_mailbox_t *mb, const char *name, void *buf0, void *buf1, unsigned int size)
+{
+    if (mb == NULL || osal_seqlock_init(&mb->data, buf0, buf1, size) != OSAL_SUCCESS) {
+        return OSAL_INVALID_PARAM;
+    }
+    if (osal_sem_create(&mb->wake, name, 0) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    mb->name = name;
+    mb->waiters = 0;
+    mb->consumed = 0;
+    mb->writes = 0;
+    mb->dropped = 0;
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_mailbox_delete(osal_mailbox_t *mb)
+{
+    if (mb == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    return osal_sem_delete(&mb->wake);
+}
+
+osal_status_t osal_mailbox_post(osal_mailbox_t *mb, const void *value)
+{
+    osal_critical_state_t crit;
+    uint16_t waiters;
+
+    if (mb == NULL || value == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    /* 顺序锁只允许一个写者，中断和线程的写入在临界区中串行 */
+    osal_enter_critical(&crit);
+    uint32_t seq = osal_seqlock_version(&mb->data);
+    if (seq != 0 && mb->consumed != seq) {
+        mb->dropped++;
+    }
+    osal_seqlock_write(&mb->data, value);
+    mb->writes++;
+    waiters = mb->waiters;
+    mb->waiters = 0;
+    while (waiters-- > 0) {
+        osal_sem_post(&mb->wake);
+    }
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+/* 读出当前值并记录为已读取 */
+static uint32_t mailbox_take(osal_mailbox_t *mb, void *out)
+{
+    uint32_t seq = osal_seqlock_read(&mb->data, out);
+    mb->consumed = seq;
+    return seq;
+}
+
+osal_status_t osal_mailbox_read(osal_mailbox_t *mb, void *out, uint32_t *last_seq, osal_tick_t timeout)
+{
+    osal_critical_state_t crit;
+    osal_tick_t start, elapsed, remaining;
+
+    if (mb == NULL || out == NULL || last_seq == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    start = osal_tick_get();
+    for (;;) {
+        /* 检查和登记在同一临界区中，写入只可能发生在登记之前或之后，不会丢失唤醒 */
+        osal_enter_critical(&crit);
+        if (osal_seqlock_version(&mb->data) != *last_seq) {
+            osal_exit_critical(&crit);
+            *last_seq = mailbox_take(mb, out);
+            return OSAL_SUCCESS;
+        }
+        if (timeout == OSAL_NO_WAIT) {
+            osal_exit_critical(&crit);
+            return OSAL_TIMEOUT;
+        }
+        mb->waiters++;
+        osal_exit_critical(&crit);
+
+        remaining = OSAL_WAIT_FOREVER;
+        if (timeout != OSAL_WAIT_FOREVER) {
+            elapsed = osal_tick_get() - start;
+            remaining = (elapsed < timeout) ? timeout - elapsed : OSAL_NO_WAIT;
+        }
+        if (remaining == OSAL_NO_WAIT || osal_sem_wait(&mb->wake, remaining) != OSAL_SUCCESS) {
+            /*
+             * 超时：写者还没有清零计数时撤销登记；已清零说明写者为本线程释放过信号量，
+             * 计数留给下一次等待，多出的唤醒由循环重新检查版本号吸收
+             */
+            osal_enter_critical(&crit);
+            if (mb->waiters > 0) {
+                mb->waiters--;
+            }
+            osal_exit_critical(&crit);
+            if (osal_seqlock_version(&mb->data) != *last_seq) {
+                *last_seq = mailbox_take(mb, out);
+                return OSAL_SUCCESS;
+            }
+            return OSAL_TIMEOUT;
+        }
+    }
+}
+
+uint32_t osal_mailbox_peek(osal_mailbox_t *mb, void *out)
+{
+    if (mb == NULL || out == NULL) {
+        return 0;
+    }
+    return mailbox_take(mb, out);
+}
@@ -0,0 +1,97 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-22 09:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-22 09:00:00
+ * @FilePath: /rm_base/OSAL/osal_mailbox.h
+ * @Description: 最新值邮箱，只保存一份任意大小的数据，写入覆盖旧值并唤醒等待的读者
+ */
+#ifndef __OSAL_MAILBOX_H__
+#define __OSAL_MAILBOX_H__
+
+#include "osal_def.h"
+#include "osal_seqlock.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 数据存放在顺序锁中，写入在临界区中完成，中断和线程都可以写，写者从不阻塞。
+ * 读者记录自己读到的版本号，等待比它更新的数据；等待的读者计数在写入时清零，并按计数释放唤醒信号量，
+ * 所有等待的读者都会被唤醒。被覆盖前没有任何读者读过的数据计入dropped。
+ */
+typedef struct {
+    const char *name;
+    osal_seqlock_t data;
+    osal_sem_t wake;
+    volatile uint16_t waiters;      /* 正在等待新数据的读者数 */
+    volatile uint32_t consumed;     /* 最近一次被读取的版本号 */
+    uint32_t writes;                /* 写入次数 */
+    uint32_t dropped;               /* 未被读取就被覆盖的次数 */
+} osal_mailbox_t;
+
+/**
+ * @description: 创建邮箱
+ * @param {osal_mailbox_t*} mb, 邮箱
+ * @param {const char*} name, 名称
+ * @param {void*} buf0, 数据缓冲0
+ * @param {void*} buf1, 数据缓冲1
+ * @param {unsigned int} size, 数据大小(字节)
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 创建信号量失败
+ */
+osal_status_t osal_mailbox_create(osal_mailbox_t *mb, const char *name, void *buf0, void *buf1, unsigned int size);
+
+/**
+ * @description: 删除邮箱
+ * @param {osal_mailbox_t*} mb, 邮箱
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_mailbox_delete(osal_mailbox_t *mb);
+
+/**
+ * @description: 写入新值，覆盖旧值并唤醒所有等待的读者；可在中断中调用
+ * @param {osal_mailbox_t*} mb, 邮箱
+ * @param {const void*} value, 新值，大小为创建时的size
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_mailbox_post(osal_mailbox_t *mb, const void *value);
+
+/**
+ * @description: 读取比*last_seq更新的值，没有时等待写入；不可在中断中调用(OSAL_NO_WAIT除外)
+ * @param {osal_mailbox_t*} mb, 邮箱
+ * @param {void*} out, 输出缓冲，大小为创建时的size
+ * @param {uint32_t*} last_seq, 输入上次读到的版本号(首次为0)，输出本次读到的版本号
+ * @param {osal_tick_t} timeout, 超时时间
+ * @return {osal_status_t} OSAL_SUCCESS - 读到新值, OSAL_TIMEOUT - 超时, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_mailbox_read(osal_mailbox_t *mb, void *out, uint32_t *last_seq, osal_tick_t timeout);
+
+/**
+ * @description: 不等待，读取当前值
+ * @param {osal_mailbox_t*} mb, 邮箱
+ * @param {void*} out, 输出缓冲，大小为创建时的size
+ * @return {uint32_t} 读到的版本号，0表示尚未写入过(out为全0)
+ */
+uint32_t osal_mailbox_peek(osal_mailbox_t *mb, void *out);
+
+/* 类型化辅助宏：声明type类型的邮箱name，写入/读取时检查指针类型 */
+#define OSAL_MAILBOX_DEFINE(type, name) \
+    static type name##_buf[2];          \
+    static osal_mailbox_t name
+
+#define OSAL_MAILBOX_CREATE(name) \
+    osal_mailbox_create(&(name), #name, &name##_buf[0], &name##_buf[1], sizeof(name##_buf[0]))
+
+#define OSAL_MAILBOX_POST(name, ptr) \
+    ((void)sizeof((ptr) == &name##_buf[0]), osal_mailbox_post(&(name), (ptr)))
+
+#define OSAL_MAILBOX_READ(name, ptr, last_seq, timeout) \
+    ((void)sizeof((ptr) == &name##_buf[0]), osal_mailbox_read(&(name), (ptr), (last_seq), (timeout)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_MAILBOX_H__ */
@@ -0,0 +1,206 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-15 09:40:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-15 09:40:00
+ * @FilePath: /rm_base/OSAL/osal_mempool.c
+ * @Description: 固定大小内存块池实现，ThreadX下使用tx_block_pool，其他后端使用无锁空闲链表
+ */
+#include "osal_mempool.h"
+
+/* 分配成功后更新占用统计，高水位在并发下偶尔少记一次可以接受 */
+static void mempool_account_alloc(osal_mempool_t *pool)
+{
+    uint32_t used = __atomic_add_fetch(&pool->used, 1U, __ATOMIC_RELAXED);
+    if (used > pool->peak) {
+        pool->peak = used;
+    }
+}
+
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+
+/* ThreadX下的块池实现 */
+osal_status_t osal_mempool_create(osal_mempool_t *pool, const char *name,
+                                  unsigned int block_size, unsigned int block_count,
+                                  void *storage)
+{
+    UINT result;
+
+    if (pool == NULL || storage == NULL || block_size == 0 || block_count == 0 ||
+        ((uintptr_t)storage % OSAL_MEMPOOL_ALIGN) != 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pool->block_size = OSAL_MEMPOOL_BLOCK_SIZE(block_size);
+    pool->block_count = block_count;
+    pool->used = 0;
+    pool->peak = 0;
+    pool->alloc_fail = 0;
+    pool->name = name;
+
+    result = tx_block_pool_create(&pool->pool, (CHAR *)name, pool->block_size, storage,
+                                  OSAL_MEMPOOL_STORAGE_SIZE(block_size, block_count));
+    if (result != TX_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+void *osal_mempool_alloc(osal_mempool_t *pool, osal_tick_t timeout)
+{
+    VOID *block = NULL;
+    UINT result;
+
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    if (timeout == OSAL_WAIT_FOREVER) {
+        result = tx_block_allocate(&pool->pool, &block, TX_WAIT_FOREVER);
+    } else {
+        result = tx_block_allocate(&pool->pool, &block, timeout);
+    }
+
+    if (result != TX_SUCCESS) {
+        __atomic_fetch_add(&pool->alloc_fail, 1U, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    mempool_account_alloc(pool);
+    return block;
+}
+
+osal_status_t osal_mempool_free(osal_mempool_t *pool, void *block)
+{
+    if (pool == NULL || block == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (tx_block_release(block) != TX_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    __atomic_fetch_sub(&pool->used, 1U, __ATOMIC_RELAXED);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_mempool_delete(osal_mempool_t *pool)
+{
+    if (pool == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (tx_block_pool_delete(&pool->pool) != TX_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+#else
+
+/*
+ * 无锁空闲链表(Treiber栈)。空闲块的前4字节存放下一个空闲块的索引，
+ * 链表头为{标签:16, 索引:16}，每次修改标签加1，避免中断抢占导致的ABA问题。
+ */
+#define MEMPOOL_INDEX_END                (0xFFFFU)
+#define MEMPOOL_HEAD(tag, index)         ((((uint32_t)(tag)) << 16) | ((uint32_t)(index) & 0xFFFFU))
+#define MEMPOOL_HEAD_INDEX(head)         ((head) & 0xFFFFU)
+#define MEMPOOL_HEAD_TAG(head)           ((head) >> 16)
+
+static inline uint8_t *mempool_block(osal_mempool_t *pool, uint32_t index)
+{
+    return pool->base + index * pool->block_size;
+}
+
+static inline volatile uint32_t *mempool_next(osal_mempool_t *pool, uint32_t index)
+{
+    return (volatile uint32_t *)mempool_block(pool, index);
+}
+
+osal_status_t osal_mempool_create(osal_mempool_t *pool, const char *name,
+                                  unsigned int block_size, unsigned int block_count,
+                                  void *storage)
+{
+    if (pool == NULL || storage == NULL || block_size == 0 || block_count == 0 ||
+        block_count > OSAL_MEMPOOL_MAX_BLOCKS || ((uintptr_t)storage % OSAL_MEMPOOL_ALIGN) != 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pool->base = (uint8_t *)storage;
+    pool->block_size = OSAL_MEMPOOL_BLOCK_SIZE(block_size);
+    pool->block_count = block_count;
+    pool->used = 0;
+    pool->peak = 0;
+    pool->alloc_fail = 0;
+    pool->name = name;
+
+    for (uint32_t i = 0; i < block_count; i++) {
+        *mempool_next(pool, i) = (i + 1U < block_count) ? (i + 1U) : MEMPOOL_INDEX_END;
+    }
+    __atomic_store_n(&pool->free_head, MEMPOOL_HEAD(0, 0), __ATOMIC_RELEASE);
+    return OSAL_SUCCESS;
+}
+
+void *osal_mempool_alloc(osal_mempool_t *pool, osal_tick_t timeout)
+{
+    uint32_t head;
+    uint32_t index;
+    uint32_t next;
+
+    (void)timeout;
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    head = __atomic_load_n(&pool->free_head, __ATOMIC_ACQUIRE);
+    do {
+        index = MEMPOOL_HEAD_INDEX(head);
+        if (index == MEMPOOL_INDEX_END) {
+            __atomic_fetch_add(&pool->alloc_fail, 1U, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        /* 块可能已被其他上下文取走，此时读到的next无效，但标签变化会使CAS失败 */
+        next = *mempool_next(pool, index);
+    } while (!__atomic_compare_exchange_n(&pool->free_head, &head,
+                                          MEMPOOL_HEAD(MEMPOOL_HEAD_TAG(head) + 1U, next),
+                                          1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    mempool_account_alloc(pool);
+    return mempool_block(pool, index);
+}
+
+osal_status_t osal_mempool_free(osal_mempool_t *pool, void *block)
+{
+    uintptr_t offset;
+    uint32_t index;
+    uint32_t head;
+
+    if (pool == NULL || block == NULL || (uint8_t *)block < pool->base) {
+        return OSAL_INVALID_PARAM;
+    }
+    offset = (uintptr_t)((uint8_t *)block - pool->base);
+    if (offset >= (uintptr_t)pool->block_size * pool->block_count || (offset % pool->block_size) != 0) {
+        return OSAL_INVALID_PARAM;
+    }
+    index = (uint32_t)(offset / pool->block_size);
+
+    head = __atomic_load_n(&pool->free_head, __ATOMIC_ACQUIRE);
+    do {
+        *mempool_next(pool, index) = MEMPOOL_HEAD_INDEX(head);
+    } while (!__atomic_compare_exchange_n(&pool->free_head, &head,
+                                          MEMPOOL_HEAD(MEMPOOL_HEAD_TAG(head) + 1U, index),
+                                          1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    __atomic_fetch_sub(&pool->used, 1U, __ATOMIC_RELAXED);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_mempool_delete(osal_mempool_t *pool)
+{
+    if (pool == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    pool->base = NULL;
+    pool->block_count = 0;
+    return OSAL_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-15 09:40:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-15 09:40:00
+ * @FilePath: /rm_base/OSAL/osal_mempool.h
+ * @Description: 固定大小内存块池，O(1)分配/释放，可在中断中使用
+ */
+#ifndef __OSAL_MEMPOOL_H__
+#define __OSAL_MEMPOOL_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 内存块按8字节对齐 */
+#define OSAL_MEMPOOL_ALIGN                     (8U)
+#define OSAL_MEMPOOL_BLOCK_SIZE(block_size)    (((block_size) + OSAL_MEMPOOL_ALIGN - 1U) & ~(OSAL_MEMPOOL_ALIGN - 1U))
+/* 创建时需要的存储区大小(字节)，ThreadX每个块额外需要一个指针大小的块头 */
+#define OSAL_MEMPOOL_STORAGE_SIZE(block_size, block_count) \
+    ((OSAL_MEMPOOL_BLOCK_SIZE(block_size) + sizeof(void *)) * (block_count))
+/* 无锁空闲链表使用16位块索引 */
+#define OSAL_MEMPOOL_MAX_BLOCKS                (0xFFFFU)
+
+typedef struct {
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+    TX_BLOCK_POOL pool;             /* ThreadX块池 */
+#else
+    uint8_t *base;                  /* 块区起始地址 */
+    volatile uint32_t free_head;    /* 高16位为ABA标签，低16位为空闲块索引 */
+#endif
+    uint32_t block_size;            /* 对齐后的块大小 */
+    uint32_t block_count;           /* 块数量 */
+    volatile uint32_t used;         /* 当前已分配块数 */
+    volatile uint32_t peak;         /* 历史最大已分配块数(高水位) */
+    volatile uint32_t alloc_fail;   /* 分配失败次数 */
+    const char *name;
+} osal_mempool_t;
+
+/**
+ * @description: 创建内存块池
+ * @param {osal_mempool_t*} pool, 块池句柄指针
+ * @param {const char*} name, 名称
+ * @param {unsigned int} block_size, 块大小(字节)
+ * @param {unsigned int} block_count, 块数量
+ * @param {void*} storage, 存储区，至少OSAL_MEMPOOL_STORAGE_SIZE(block_size, block_count)字节，8字节对齐
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 失败
+ */
+osal_status_t osal_mempool_create(osal_mempool_t *pool, const char *name,
+                                  unsigned int block_size, unsigned int block_count,
+                                  void *storage);
+
+/**
+ * @description: 分配一个内存块，中断中可调用(ThreadX下中断中只能使用OSAL_NO_WAIT)
+ * @param {osal_mempool_t*} pool, 块池句柄指针
+ * @param {osal_tick_t} timeout, 等待时间，仅ThreadX支持阻塞等待，其他后端立即返回
+ * @return {void*} 内存块指针，失败返回NULL并累加alloc_fail
+ */
+void *osal_mempool_alloc(osal_mempool_t *pool, osal_tick_t timeout);
+
+/**
+ * @description: 释放内存块，中断中可调用
+ * @param {osal_mempool_t*} pool, 块池句柄指针
+ * @param {void*} block, 内存块指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 失败
+ */
+osal_status_t osal_mempool_free(osal_mempool_t *pool, void *block);
+
+/**
+ * @description: 删除内存块池
+ * @param {osal_mempool_t*} pool, 块池句柄指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 失败
+ */
+osal_status_t osal_mempool_delete(osal_mempool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_MEMPOOL_H__ */
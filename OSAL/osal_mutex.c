@@ -1,4 +1,14 @@
+#define OSAL_INLINE_IMPL    /* 本文件提供库中的函数实体，不使用osal_inline.h的映射 */
 #include "osal_def.h"
+#include "osal_lockstat.h"
+
+#if OSAL_LOCK_STATS_ENABLE
+/* 开启统计时，下面各后端实现编译为*_raw，由文件末尾的统计包装函数调用 */
+#define osal_mutex_create osal_mutex_create_raw
+#define osal_mutex_lock osal_mutex_lock_raw
+#define osal_mutex_unlock osal_mutex_unlock_raw
+#define osal_mutex_delete osal_mutex_delete_raw
+#endif
 
 #if (OSAL_RTOS_TYPE == OSAL_THREADX)
 
@@ -151,4 +161,108 @@ osal_status_t osal_mutex_delete(osal_mutex_t *mutex)
     return OSAL_SUCCESS;
 }
 
-#endif
\ No newline at end of file
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+#include "osal_posix.h"
+
+osal_status_t osal_mutex_create(osal_mutex_t *mutex, const char *name)
+{
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutexattr_t attr;
+    int ret;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    ret = pthread_mutex_init(&mutex->handle, &attr);
+    pthread_mutexattr_destroy(&attr);
+    mutex->name = name;
+
+    return (ret == 0) ? OSAL_SUCCESS : OSAL_ERROR;
+}
+
+osal_status_t osal_mutex_lock(osal_mutex_t *mutex, osal_tick_t timeout)
+{
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    int ret;
+    if (timeout == OSAL_WAIT_FOREVER) {
+        ret = pthread_mutex_lock(&mutex->handle);
+    } else if (timeout == OSAL_NO_WAIT) {
+        ret = pthread_mutex_trylock(&mutex->handle);
+    } else {
+        struct timespec abstime;
+        osal_posix_abstime(timeout, &abstime);
+        ret = pthread_mutex_clocklock(&mutex->handle, CLOCK_MONOTONIC, &abstime);
+    }
+
+    if (ret == 0) {
+        return OSAL_SUCCESS;
+    } else if (ret == ETIMEDOUT || ret == EBUSY) {
+        return OSAL_TIMEOUT;
+    } else {
+        return OSAL_ERROR;
+    }
+}
+
+osal_status_t osal_mutex_unlock(osal_mutex_t *mutex)
+{
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    return (pthread_mutex_unlock(&mutex->handle) == 0) ? OSAL_SUCCESS : OSAL_ERROR;
+}
+
+osal_status_t osal_mutex_delete(osal_mutex_t *mutex)
+{
+    if (mutex == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    return (pthread_mutex_destroy(&mutex->handle) == 0) ? OSAL_SUCCESS : OSAL_ERROR;
+}
+
+#endif
+
+#if OSAL_LOCK_STATS_ENABLE
+#undef osal_mutex_create
+#undef osal_mutex_lock
+#undef osal_mutex_unlock
+#undef osal_mutex_delete
+
+osal_status_t osal_mutex_create(osal_mutex_t *mutex, const char *name)
+{
+    osal_status_t status = osal_mutex_create_raw(mutex, name);
+    if (status == OSAL_SUCCESS) {
+        osal_lockstat_register(mutex, name, OSAL_LOCKSTAT_MUTEX);
+    }
+    return status;
+}
+
+osal_status_t osal_mutex_lock(osal_mutex_t *mutex, osal_tick_t timeout)
+{
+    osal_status_t status;
+
+    OSAL_LOCKSTAT_WAIT(status, mutex, timeout, osal_mutex_lock_raw(mutex, _lockstat_timeout));
+    if (status == OSAL_SUCCESS) {
+        osal_lockstat_hold_begin(mutex);
+    }
+    return status;
+}
+
+osal_status_t osal_mutex_unlock(osal_mutex_t *mutex)
+{
+    /* 先结束计时再解锁，避免其他线程获取后修改同一条目 */
+    osal_lockstat_hold_end(mutex);
+    return osal_mutex_unlock_raw(mutex);
+}
+
+osal_status_t osal_mutex_delete(osal_mutex_t *mutex)
+{
+    osal_lockstat_unregister(mutex);
+    return osal_mutex_delete_raw(mutex);
+}
+
+#endif /* OSAL_LOCK_STATS_ENABLE */
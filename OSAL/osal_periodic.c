@@ -0,0 +1,142 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-16 15:30:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-16 15:30:00
+ * @FilePath: /rm_base/OSAL/osal_periodic.c
+ * @Description: 周期任务实现
+ */
+#include "osal_periodic.h"
+
+#define PERIODIC_TICK_US     (1000000U / OSAL_TICK_RATE_HZ)
+
+static osal_periodic_t *periodic_list = NULL;
+
+static void periodic_run(osal_periodic_t *task)
+{
+    osal_tick_t late_ticks;
+    uint32_t start, exec_us, late_us, response_us, missed;
+
+    for (;;) {
+        /* 释放时刻固定在next_release上，唤醒延迟和上一周期的执行时间都不会累积 */
+        late_ticks = osal_tick_get() - task->next_release;
+        start = osal_cycle_get();
+        task->entry(task->argument);
+        exec_us = (osal_cycle_get() - start) / osal_cycle_per_us();
+
+        late_us = (uint32_t)late_ticks * PERIODIC_TICK_US;
+        response_us = late_us + exec_us;
+        task->jobs++;
+        task->exec_total_us += exec_us;
+        if (exec_us < task->exec_min_us) {
+            task->exec_min_us = exec_us;
+        }
+        if (exec_us > task->exec_max_us) {
+            task->exec_max_us = exec_us;
+        }
+        if (late_us > task->late_max_us) {
+            task->late_max_us = late_us;
+        }
+        if (response_us > task->deadline_us) {
+            task->deadline_miss++;
+            if (task->overrun_hook != NULL) {
+                task->overrun_hook(task, response_us);
+            }
+        }
+
+        if (osal_delay_until(&task->next_release, task->period_ticks) == OSAL_TIMEOUT) {
+            /* 已经落后一个以上周期时丢弃错过的释放，重新对齐到周期网格上，避免连续补跑 */
+            missed = (uint32_t)((osal_tick_get() - task->next_release) / task->period_ticks);
+            if (missed > 0) {
+                task->skipped += missed;
+                task->next_release += (osal_tick_t)missed * task->period_ticks;
+            }
+        }
+    }
+}
+
+#if (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+static void periodic_thread_entry(void *argument)
+{
+    periodic_run((osal_periodic_t *)argument);
+}
+#else
+static void periodic_thread_entry(unsigned long argument)
+{
+    periodic_run((osal_periodic_t *)argument);
+}
+#endif
+
+osal_status_t osal_periodic_create(osal_periodic_t *task, const char *name,
+                                   uint32_t period_us, uint32_t deadline_us,
+                                   osal_periodic_entry_t entry, void *argument,
+                                   void *stack_pointer, unsigned int stack_size,
+                                   osal_thread_priority_t priority)
+{
+    osal_critical_state_t crit;
+    osal_periodic_t *it;
+
+    if (task == NULL || entry == NULL || period_us == 0 || (period_us % PERIODIC_TICK_US) != 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    task->name = name;
+    task->entry = entry;
+    task->argument = argument;
+    task->overrun_hook = NULL;
+    task->period_us = period_us;
+    task->deadline_us = (deadline_us == 0) ? period_us : deadline_us;
+    task->period_ticks = (osal_tick_t)(period_us / PERIODIC_TICK_US);
+    task->next_release = 0;
+    osal_periodic_reset_stats(task);
+
+    if (osal_thread_create(&task->thread, name, periodic_thread_entry, task,
+                           stack_pointer, stack_size, priority) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+
+    osal_enter_critical(&crit);
+    for (it = periodic_list; it != NULL && it != task; it = it->next) {
+    }
+    if (it == NULL) {
+        task->next = periodic_list;
+        periodic_list = task;
+    }
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_periodic_start(osal_periodic_t *task)
+{
+    if (task == NULL) {
+        return OSAL_ERROR;
+    }
+    task->next_release = osal_tick_get();
+    return osal_thread_start(&task->thread);
+}
+
+void osal_periodic_set_overrun_hook(osal_periodic_t *task, osal_periodic_overrun_hook_t hook)
+{
+    if (task != NULL) {
+        task->overrun_hook = hook;
+    }
+}
+
+void osal_periodic_reset_stats(osal_periodic_t *task)
+{
+    if (task == NULL) {
+        return;
+    }
+    task->jobs = 0;
+    task->deadline_miss = 0;
+    task->skipped = 0;
+    task->exec_min_us = UINT32_MAX;
+    task->exec_max_us = 0;
+    task->exec_total_us = 0;
+    task->late_max_us = 0;
+}
+
+osal_periodic_t *osal_periodic_next(osal_periodic_t *task)
+{
+    return (task == NULL) ? periodic_list : task->next;
+}
@@ -0,0 +1,101 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-16 15:30:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-16 15:30:00
+ * @FilePath: /rm_base/OSAL/osal_periodic.h
+ * @Description: 周期任务，按绝对时刻释放，统计截止时间错过次数和执行时间
+ */
+#ifndef __OSAL_PERIODIC_H__
+#define __OSAL_PERIODIC_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct osal_periodic;
+
+/* 每个周期调用一次的任务函数 */
+typedef void (*osal_periodic_entry_t)(void *argument);
+/* 错过截止时间时调用，response_us为本次从释放时刻到执行完成的时间 */
+typedef void (*osal_periodic_overrun_hook_t)(struct osal_periodic *task, uint32_t response_us);
+
+typedef struct osal_periodic {
+    osal_thread_t thread;                   /* 执行任务的线程 */
+    const char *name;
+    osal_periodic_entry_t entry;
+    void *argument;
+    osal_periodic_overrun_hook_t overrun_hook;
+    uint32_t period_us;                     /* 周期(us)，必须是tick周期的整数倍 */
+    uint32_t deadline_us;                   /* 相对释放时刻的截止时间(us) */
+    osal_tick_t period_ticks;
+    osal_tick_t next_release;               /* 下一次释放的绝对tick */
+
+    /* 统计 */
+    uint32_t jobs;                          /* 已执行次数 */
+    uint32_t deadline_miss;                 /* 响应时间超过截止时间的次数 */
+    uint32_t skipped;                       /* 因严重超时被跳过的释放次数 */
+    uint32_t exec_min_us;                   /* 最小执行时间 */
+    uint32_t exec_max_us;                   /* 最大执行时间 */
+    uint64_t exec_total_us;                 /* 累计执行时间，平均值 = exec_total_us / jobs */
+    uint32_t late_max_us;                   /* 最大释放延迟(唤醒时刻晚于释放时刻) */
+
+    struct osal_periodic *next;             /* 已创建周期任务链表，供shell遍历 */
+} osal_periodic_t;
+
+/**
+ * @description: 创建周期任务(创建后不运行，需调用osal_periodic_start)
+ * @param {osal_periodic_t*} task, 周期任务句柄指针
+ * @param {const char*} name, 名称
+ * @param {uint32_t} period_us, 周期(us)，必须是tick周期的整数倍，亚毫秒周期请使用控制节拍服务
+ * @param {uint32_t} deadline_us, 截止时间(us)，0表示与周期相同
+ * @param {osal_periodic_entry_t} entry, 每个周期调用一次的任务函数
+ * @param {void*} argument, 任务函数参数
+ * @param {void*} stack_pointer, 线程栈
+ * @param {unsigned int} stack_size, 线程栈大小
+ * @param {osal_thread_priority_t} priority, 线程优先级
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 线程创建失败
+ */
+osal_status_t osal_periodic_create(osal_periodic_t *task, const char *name,
+                                   uint32_t period_us, uint32_t deadline_us,
+                                   osal_periodic_entry_t entry, void *argument,
+                                   void *stack_pointer, unsigned int stack_size,
+                                   osal_thread_priority_t priority);
+
+/**
+ * @description: 启动周期任务，第一个周期从当前时刻开始
+ * @param {osal_periodic_t*} task, 周期任务句柄指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 失败
+ */
+osal_status_t osal_periodic_start(osal_periodic_t *task);
+
+/**
+ * @description: 设置截止时间错过回调，在任务线程中调用，应尽量简短
+ * @param {osal_periodic_t*} task, 周期任务句柄指针
+ * @param {osal_periodic_overrun_hook_t} hook, 回调函数，NULL为取消
+ * @return {*}
+ */
+void osal_periodic_set_overrun_hook(osal_periodic_t *task, osal_periodic_overrun_hook_t hook);
+
+/**
+ * @description: 清零统计数据
+ * @param {osal_periodic_t*} task, 周期任务句柄指针
+ * @return {*}
+ */
+void osal_periodic_reset_stats(osal_periodic_t *task);
+
+/**
+ * @description: 遍历已创建的周期任务
+ * @param {osal_periodic_t*} task, 当前任务，NULL表示从头开始
+ * @return {osal_periodic_t*} 下一个任务，没有则返回NULL
+ */
+osal_periodic_t *osal_periodic_next(osal_periodic_t *task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_PERIODIC_H__ */
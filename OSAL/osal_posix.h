@@ -0,0 +1,72 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-14 10:02:11
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-14 10:02:11
+ * @FilePath: /rm_base/OSAL/osal_posix.h
+ * @Description: OSAL POSIX后端内部使用的辅助函数，不对外提供
+ */
+#ifndef __OSAL_POSIX_H__
+#define __OSAL_POSIX_H__
+
+#include "osal_def.h"
+
+#if (OSAL_RTOS_TYPE == OSAL_POSIX)
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * @description: 初始化使用CLOCK_MONOTONIC计时的条件变量，避免系统时间调整影响超时
+ * @param {pthread_cond_t*} cond
+ * @return {int} 0 - 成功
+ */
+static inline int osal_posix_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    int ret;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    ret = pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return ret;
+}
+
+/**
+ * @description: 将相对超时(tick, 1 tick = 1 ms)转换为CLOCK_MONOTONIC绝对时间
+ * @param {osal_tick_t} timeout
+ * @param {struct timespec*} abstime
+ * @return {*}
+ */
+static inline void osal_posix_abstime(osal_tick_t timeout, struct timespec *abstime)
+{
+    clock_gettime(CLOCK_MONOTONIC, abstime);
+    abstime->tv_sec += (time_t)(timeout / 1000UL);
+    abstime->tv_nsec += (long)(timeout % 1000UL) * 1000000L;
+    if (abstime->tv_nsec >= 1000000000L) {
+        abstime->tv_sec += 1;
+        abstime->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @description: 在已持有lock的情况下等待条件变量，统一处理OSAL_NO_WAIT/OSAL_WAIT_FOREVER
+ * @param {pthread_cond_t*} cond
+ * @param {pthread_mutex_t*} lock
+ * @param {const struct timespec*} abstime, OSAL_WAIT_FOREVER时为NULL
+ * @return {int} 0 - 被唤醒, ETIMEDOUT - 超时
+ */
+static inline int osal_posix_cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock,
+                                       const struct timespec *abstime)
+{
+    if (abstime == NULL) {
+        return pthread_cond_wait(cond, lock);
+    }
+    return pthread_cond_timedwait(cond, lock, abstime);
+}
+
+#endif
+
+#endif /* __OSAL_POSIX_H__ */
@@ -7,9 +7,24 @@
  * @Description: OSAL队列管理接口实现
  */
 
+#define OSAL_INLINE_IMPL    /* 本文件提供库中的函数实体，不使用osal_inline.h的映射 */
 #include "osal_def.h"
+#include "osal_lockstat.h"
+#include "osal_waitany.h"
 #include <string.h>
 
+#if OSAL_LOCK_STATS_ENABLE
+/* 开启统计时，下面各后端实现编译为*_raw，由文件末尾的统计包装函数调用 */
+#define osal_queue_create osal_queue_create_raw
+#define osal_queue_recv osal_queue_recv_raw
+#define osal_queue_delete osal_queue_delete_raw
+#endif
+
+#if OSAL_WAIT_ANY_ENABLE
+/* 开启多对象等待时，osal_queue_send编译为*_raw，由文件末尾的包装函数在成功后通知等待者 */
+#define osal_queue_send osal_queue_send_raw
+#endif
+
 #if (OSAL_RTOS_TYPE == OSAL_THREADX)
 
 /* ThreadX下的队列实现 */
@@ -22,15 +37,17 @@ osal_status_t osal_queue_create(osal_queue_t *queue,
     UINT result;
     ULONG queue_size;
     
-    if (queue == NULL || msg_buffer == NULL || msg_size == 0 || msg_count == 0) {
+    /* ThreadX消息以ULONG为单位拷贝，msg_size(字节)必须是ULONG大小的整数倍 */
+    if (queue == NULL || msg_buffer == NULL || msg_size == 0 || msg_count == 0 ||
+        (msg_size % sizeof(ULONG)) != 0) {
         return OSAL_INVALID_PARAM;
     }
     
-    /* 计算队列总大小 */
-    queue_size = msg_size * msg_count * sizeof(ULONG);
+    /* 计算队列总大小(字节) */
+    queue_size = msg_size * msg_count;
     
-    /* ThreadX队列创建 */
-    result = tx_queue_create((TX_QUEUE*)queue, (CHAR*)name, msg_size,
+    /* ThreadX队列创建，消息大小转换为ULONG个数 */
+    result = tx_queue_create((TX_QUEUE*)queue, (CHAR*)name, msg_size / sizeof(ULONG),
                              (VOID*)msg_buffer, queue_size);
     
     if (result == TX_SUCCESS) {
@@ -103,6 +120,89 @@ osal_status_t osal_queue_delete(osal_queue_t *queue)
     }
 }
 
+unsigned int osal_queue_count(osal_queue_t *queue)
+{
+    if (queue == NULL) {
+        return 0;
+    }
+    return ((TX_QUEUE*)queue)->tx_queue_enqueued;
+}
+
+static unsigned int queue_capacity(osal_queue_t *queue)
+{
+    return ((TX_QUEUE*)queue)->tx_queue_capacity;
+}
+
+/*
+ * 批量读写直接操作TX_QUEUE的环形缓冲区，与tx_queue_send/receive的内部实现一致。
+ * 有线程挂起在队列上时(空队列上的接收者/满队列上的发送者)需要内核直接交接消息并恢复线程，改为逐条调用内核接口。
+ */
+static unsigned int queue_put_n(osal_queue_t *queue, const uint8_t *msgs, unsigned int count)
+{
+    TX_QUEUE *q = (TX_QUEUE*)queue;
+    osal_critical_state_t crit;
+    unsigned int done = 0;
+
+    while (done < count) {
+        osal_enter_critical(&crit);
+        if (q->tx_queue_suspended_count == 0) {
+            while (done < count && q->tx_queue_available_storage > 0) {
+                const ULONG *src = (const ULONG *)(msgs + done * q->tx_queue_message_size * sizeof(ULONG));
+                for (UINT i = 0; i < q->tx_queue_message_size; i++) {
+                    *q->tx_queue_write++ = *src++;
+                }
+                if (q->tx_queue_write == q->tx_queue_end) {
+                    q->tx_queue_write = q->tx_queue_start;
+                }
+                q->tx_queue_available_storage--;
+                q->tx_queue_enqueued++;
+                done++;
+            }
+            osal_exit_critical(&crit);
+            break;
+        }
+        osal_exit_critical(&crit);
+        if (tx_queue_send(q, (VOID *)(msgs + done * q->tx_queue_message_size * sizeof(ULONG)), TX_NO_WAIT) != TX_SUCCESS) {
+            break;
+        }
+        done++;
+    }
+    return done;
+}
+
+static unsigned int queue_take_n(osal_queue_t *queue, uint8_t *msgs, unsigned int count)
+{
+    TX_QUEUE *q = (TX_QUEUE*)queue;
+    osal_critical_state_t crit;
+    unsigned int done = 0;
+
+    while (done < count) {
+        osal_enter_critical(&crit);
+        if (q->tx_queue_suspended_count == 0) {
+            while (done < count && q->tx_queue_enqueued > 0) {
+                ULONG *dst = (ULONG *)(msgs + done * q->tx_queue_message_size * sizeof(ULONG));
+                for (UINT i = 0; i < q->tx_queue_message_size; i++) {
+                    *dst++ = *q->tx_queue_read++;
+                }
+                if (q->tx_queue_read == q->tx_queue_end) {
+                    q->tx_queue_read = q->tx_queue_start;
+                }
+                q->tx_queue_available_storage++;
+                q->tx_queue_enqueued--;
+                done++;
+            }
+            osal_exit_critical(&crit);
+            break;
+        }
+        osal_exit_critical(&crit);
+        if (tx_queue_receive(q, (VOID *)(msgs + done * q->tx_queue_message_size * sizeof(ULONG)), TX_NO_WAIT) != TX_SUCCESS) {
+            break;
+        }
+        done++;
+    }
+    return done;
+}
+
 #elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
 
 /* FreeRTOS下的队列实现 */
@@ -118,6 +218,7 @@ osal_status_t osal_queue_create(osal_queue_t *queue,
     
     /* 使用静态内存分配方式创建队列 */
     queue->handle = xQueueCreateStatic(msg_count, msg_size, (uint8_t*)msg_buffer, &queue->buffer);
+    queue->msg_size = msg_size;
     
     if (queue->handle != NULL) {
         return OSAL_SUCCESS;
@@ -204,4 +305,378 @@ osal_status_t osal_queue_delete(osal_queue_t *queue)
     return OSAL_SUCCESS;
 }
 
-#endif
\ No newline at end of file
+unsigned int osal_queue_count(osal_queue_t *queue)
+{
+    if (queue == NULL || queue->handle == NULL) {
+        return 0;
+    }
+    if (xPortIsInsideInterrupt()) {
+        return (unsigned int)uxQueueMessagesWaitingFromISR(queue->handle);
+    }
+    return (unsigned int)uxQueueMessagesWaiting(queue->handle);
+}
+
+static unsigned int queue_capacity(osal_queue_t *queue)
+{
+    unsigned int capacity;
+
+    taskENTER_CRITICAL();
+    capacity = (unsigned int)(uxQueueMessagesWaiting(queue->handle) + uxQueueSpacesAvailable(queue->handle));
+    taskEXIT_CRITICAL();
+    return capacity;
+}
+
+/* 中断中连续调用FromISR接口，最后统一切换；线程中挂起调度器，整批读写完成后才允许被唤醒的任务运行 */
+static unsigned int queue_put_n(osal_queue_t *queue, const uint8_t *msgs, unsigned int count)
+{
+    unsigned int msg_size = queue->msg_size;
+    unsigned int done = 0;
+
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        while (done < count &&
+               xQueueSendToBackFromISR(queue->handle, msgs + done * msg_size, &xHigherPriorityTaskWoken) == pdTRUE) {
+            done++;
+        }
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        vTaskSuspendAll();
+        while (done < count && xQueueSendToBack(queue->handle, msgs + done * msg_size, 0) == pdTRUE) {
+            done++;
+        }
+        (void)xTaskResumeAll();
+    }
+    return done;
+}
+
+static unsigned int queue_take_n(osal_queue_t *queue, uint8_t *msgs, unsigned int count)
+{
+    unsigned int msg_size = queue->msg_size;
+    unsigned int done = 0;
+
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        while (done < count &&
+               xQueueReceiveFromISR(queue->handle, msgs + done * msg_size, &xHigherPriorityTaskWoken) == pdTRUE) {
+            done++;
+        }
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        vTaskSuspendAll();
+        while (done < count && xQueueReceive(queue->handle, msgs + done * msg_size, 0) == pdTRUE) {
+            done++;
+        }
+        (void)xTaskResumeAll();
+    }
+    return done;
+}
+
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+#include "osal_posix.h"
+
+/* POSIX下的队列实现，msg_buffer按环形缓冲区使用，大小至少为msg_size * msg_count字节 */
+osal_status_t osal_queue_create(osal_queue_t *queue, 
+                                const char *name,
+                                unsigned int msg_size,
+                                unsigned int msg_count,
+                                void *msg_buffer)
+{
+    if (queue == NULL || msg_buffer == NULL || msg_size == 0 || msg_count == 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (pthread_mutex_init(&queue->lock, NULL) != 0) {
+        return OSAL_ERROR;
+    }
+    if (osal_posix_cond_init(&queue->not_empty) != 0) {
+        pthread_mutex_destroy(&queue->lock);
+        return OSAL_ERROR;
+    }
+    if (osal_posix_cond_init(&queue->not_full) != 0) {
+        pthread_cond_destroy(&queue->not_empty);
+        pthread_mutex_destroy(&queue->lock);
+        return OSAL_ERROR;
+    }
+
+    queue->buffer = (uint8_t *)msg_buffer;
+    queue->msg_size = msg_size;
+    queue->msg_count = msg_count;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->count = 0;
+    queue->name = name;
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_queue_send(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout)
+{
+    struct timespec abstime;
+    int ret = 0;
+
+    if (queue == NULL || msg_ptr == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (timeout != OSAL_WAIT_FOREVER && timeout != OSAL_NO_WAIT) {
+        osal_posix_abstime(timeout, &abstime);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->msg_count) {
+        if (timeout == OSAL_NO_WAIT || ret == ETIMEDOUT) {
+            pthread_mutex_unlock(&queue->lock);
+            return OSAL_TIMEOUT;
+        }
+        ret = osal_posix_cond_wait(&queue->not_full, &queue->lock,
+                                   (timeout == OSAL_WAIT_FOREVER) ? NULL : &abstime);
+    }
+
+    memcpy(&queue->buffer[queue->tail * queue->msg_size], msg_ptr, queue->msg_size);
+    queue->tail = (queue->tail + 1) % queue->msg_count;
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_queue_recv(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout)
+{
+    struct timespec abstime;
+    int ret = 0;
+
+    if (queue == NULL || msg_ptr == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (timeout != OSAL_WAIT_FOREVER && timeout != OSAL_NO_WAIT) {
+        osal_posix_abstime(timeout, &abstime);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0) {
+        if (timeout == OSAL_NO_WAIT || ret == ETIMEDOUT) {
+            pthread_mutex_unlock(&queue->lock);
+            return OSAL_TIMEOUT;
+        }
+        ret = osal_posix_cond_wait(&queue->not_empty, &queue->lock,
+                                   (timeout == OSAL_WAIT_FOREVER) ? NULL : &abstime);
+    }
+
+    memcpy(msg_ptr, &queue->buffer[queue->head * queue->msg_size], queue->msg_size);
+    queue->head = (queue->head + 1) % queue->msg_count;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_queue_delete(osal_queue_t *queue)
+{
+    if (queue == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+    queue->buffer = NULL;
+    return OSAL_SUCCESS;
+}
+
+
+unsigned int osal_queue_count(osal_queue_t *queue)
+{
+    unsigned int count;
+
+    if (queue == NULL || queue->buffer == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&queue->lock);
+    count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+static unsigned int queue_capacity(osal_queue_t *queue)
+{
+    return queue->msg_count;
+}
+
+static unsigned int queue_put_n(osal_queue_t *queue, const uint8_t *msgs, unsigned int count)
+{
+    unsigned int done = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    while (done < count && queue->count < queue->msg_count) {
+        memcpy(&queue->buffer[queue->tail * queue->msg_size], msgs + done * queue->msg_size, queue->msg_size);
+        queue->tail = (queue->tail + 1) % queue->msg_count;
+        queue->count++;
+        done++;
+    }
+    if (done > 0) {
+        pthread_cond_broadcast(&queue->not_empty);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return done;
+}
+
+static unsigned int queue_take_n(osal_queue_t *queue, uint8_t *msgs, unsigned int count)
+{
+    unsigned int done = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    while (done < count && queue->count > 0) {
+        memcpy(msgs + done * queue->msg_size, &queue->buffer[queue->head * queue->msg_size], queue->msg_size);
+        queue->head = (queue->head + 1) % queue->msg_count;
+        queue->count--;
+        done++;
+    }
+    if (done > 0) {
+        pthread_cond_broadcast(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return done;
+}
+
+#endif
+
+#if OSAL_LOCK_STATS_ENABLE
+#undef osal_queue_create
+#undef osal_queue_recv
+#undef osal_queue_delete
+
+osal_status_t osal_queue_create(osal_queue_t *queue, 
+                                const char *name,
+                                unsigned int msg_size,
+                                unsigned int msg_count,
+                                void *msg_buffer)
+{
+    osal_status_t status = osal_queue_create_raw(queue, name, msg_size, msg_count, msg_buffer);
+    if (status == OSAL_SUCCESS) {
+        osal_lockstat_register(queue, name, OSAL_LOCKSTAT_QUEUE);
+    }
+    return status;
+}
+
+osal_status_t osal_queue_recv(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout)
+{
+    osal_status_t status;
+
+    OSAL_LOCKSTAT_WAIT(status, queue, timeout, osal_queue_recv_raw(queue, msg_ptr, _lockstat_timeout));
+    return status;
+}
+
+osal_status_t osal_queue_delete(osal_queue_t *queue)
+{
+    osal_lockstat_unregister(queue);
+    return osal_queue_delete_raw(queue);
+}
+
+#endif /* OSAL_LOCK_STATS_ENABLE */
+
+#if OSAL_WAIT_ANY_ENABLE
+#undef osal_queue_send
+
+osal_status_t osal_queue_send(osal_queue_t *queue, void *msg_ptr, osal_tick_t timeout)
+{
+    osal_status_t status = osal_queue_send_raw(queue, msg_ptr, timeout);
+    if (status == OSAL_SUCCESS) {
+        osal_waitany_notify(queue);
+    }
+    return status;
+}
+
+#endif /* OSAL_WAIT_ANY_ENABLE */
+
+/* 消息大小(字节) */
+static unsigned int queue_msg_size(osal_queue_t *queue)
+{
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+    return ((TX_QUEUE*)queue)->tx_queue_message_size * sizeof(ULONG);
+#else
+    return queue->msg_size;
+#endif
+}
+
+unsigned int osal_queue_send_n(osal_queue_t *queue, const void *msgs, unsigned int count, osal_tick_t timeout)
+{
+    const uint8_t *src = (const uint8_t *)msgs;
+    unsigned int sent;
+
+    if (queue == NULL || msgs == NULL || count == 0) {
+        return 0;
+    }
+
+    sent = queue_put_n(queue, src, count);
+    if (sent == 0 && timeout != OSAL_NO_WAIT) {
+        /* 队列满，第一条按普通发送阻塞等待，腾出空间后剩余的再整批写入 */
+        if (osal_queue_send(queue, (void *)src, timeout) != OSAL_SUCCESS) {
+            return 0;
+        }
+        sent = 1 + queue_put_n(queue, src + queue_msg_size(queue), count - 1);
+    }
+#if OSAL_WAIT_ANY_ENABLE
+    if (sent > 0) {
+        osal_waitany_notify(queue);
+    }
+#endif
+    return sent;
+}
+
+unsigned int osal_queue_recv_n(osal_queue_t *queue, void *msgs, unsigned int max_count, unsigned int min_count,
+                               osal_tick_t timeout)
+{
+    uint8_t *dst = (uint8_t *)msgs;
+    unsigned int msg_size, capacity, got;
+    osal_tick_t start, elapsed, remaining;
+
+    if (queue == NULL || msgs == NULL || max_count == 0) {
+        return 0;
+    }
+
+    msg_size = queue_msg_size(queue);
+    capacity = queue_capacity(queue);
+    if (min_count == 0) {
+        min_count = 1;
+    }
+    if (min_count > max_count) {
+        min_count = max_count;
+    }
+    if (min_count > capacity) {
+        min_count = capacity;
+    }
+
+    got = queue_take_n(queue, dst, max_count);
+    start = osal_tick_get();
+    while (got < min_count && timeout != OSAL_NO_WAIT) {
+        remaining = OSAL_WAIT_FOREVER;
+        if (timeout != OSAL_WAIT_FOREVER) {
+            elapsed = osal_tick_get() - start;
+            if (elapsed >= timeout) {
+                break;
+            }
+            remaining = timeout - elapsed;
+        }
+#if OSAL_WAIT_ANY_ENABLE
+        /* 等到队列中凑够剩余条数才被唤醒，而不是每来一条唤醒一次；等待槽已满时退化为逐条接收 */
+        if (min_count - got > 1) {
+            osal_wait_obj_t obj = OSAL_WAIT_OBJ_QUEUE_COUNT(queue, min_count - got);
+            unsigned int index;
+            osal_status_t status = osal_wait_any(&obj, 1, remaining, &index);
+            if (status != OSAL_ERROR) {
+                got += queue_take_n(queue, dst + got * msg_size, max_count - got);
+                if (status != OSAL_SUCCESS) {
+                    break;
+                }
+                continue;
+            }
+        }
+#endif
+        if (osal_queue_recv(queue, dst + got * msg_size, remaining) != OSAL_SUCCESS) {
+            break;
+        }
+        got++;
+        got += queue_take_n(queue, dst + got * msg_size, max_count - got);
+    }
+    return got;
+}
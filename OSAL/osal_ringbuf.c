@@ -0,0 +1,192 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-14 14:20:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-14 14:20:00
+ * @FilePath: /rm_base/OSAL/osal_ringbuf.c
+ * @Description: 单生产者/单消费者无锁环形缓冲区实现
+ */
+#include "osal_ringbuf.h"
+#include <string.h>
+
+/* 生产者先写数据再以release语义发布head，消费者以acquire语义读取head后再读数据，tail同理 */
+#define RINGBUF_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RINGBUF_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+static void ringbuf_copy_in(osal_ringbuf_t *rb, uint32_t pos, const uint8_t *src, uint32_t count)
+{
+    uint32_t idx = pos & rb->mask;
+    uint32_t first = rb->elem_count - idx;
+
+    if (first > count) {
+        first = count;
+    }
+    memcpy(&rb->buffer[idx * rb->elem_size], src, first * rb->elem_size);
+    if (count > first) {
+        memcpy(rb->buffer, src + first * rb->elem_size, (count - first) * rb->elem_size);
+    }
+}
+
+static void ringbuf_copy_out(osal_ringbuf_t *rb, uint32_t pos, uint8_t *dst, uint32_t count)
+{
+    uint32_t idx = pos & rb->mask;
+    uint32_t first = rb->elem_count - idx;
+
+    if (first > count) {
+        first = count;
+    }
+    memcpy(dst, &rb->buffer[idx * rb->elem_size], first * rb->elem_size);
+    if (count > first) {
+        memcpy(dst + first * rb->elem_size, rb->buffer, (count - first) * rb->elem_size);
+    }
+}
+
+/* 生产者侧：all_or_nothing为1时空间不足整体丢弃 */
+static uint32_t ringbuf_produce(osal_ringbuf_t *rb, const void *data, uint32_t count, uint8_t all_or_nothing)
+{
+    uint32_t head = rb->head;
+    uint32_t tail = RINGBUF_LOAD_ACQUIRE(&rb->tail);
+    uint32_t space = rb->elem_count - (head - tail);
+    uint32_t n = count;
+
+    if (n > space) {
+        n = all_or_nothing ? 0 : space;
+        rb->dropped += count - n;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    ringbuf_copy_in(rb, head, (const uint8_t *)data, n);
+    RINGBUF_STORE_RELEASE(&rb->head, head + n);
+
+    if ((head + n - tail) > rb->peak) {
+        rb->peak = head + n - tail;
+    }
+
+    /*
+     * 只在空->非空时唤醒消费者，避免每帧都进入内核。
+     * 发布head后重新读取tail，与消费者等待前的屏障配对，保证不会丢失唤醒
+     */
+    if (rb->flags & OSAL_RINGBUF_FLAG_BLOCKING) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&rb->tail, __ATOMIC_RELAXED) == head) {
+            osal_sem_post(&rb->sem);
+        }
+    }
+    return n;
+}
+
+/* 消费者侧：缓冲区空且为阻塞模式时等待信号量，被唤醒后重新检查 */
+static uint32_t ringbuf_consume(osal_ringbuf_t *rb, void *data, uint32_t count, osal_tick_t timeout)
+{
+    uint32_t tail = rb->tail;
+    uint32_t head;
+    uint32_t n;
+
+    if (rb->flags & OSAL_RINGBUF_FLAG_BLOCKING) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+    head = RINGBUF_LOAD_ACQUIRE(&rb->head);
+
+    while (head == tail) {
+        if (!(rb->flags & OSAL_RINGBUF_FLAG_BLOCKING) || timeout == OSAL_NO_WAIT) {
+            return 0;
+        }
+        if (osal_sem_wait(&rb->sem, timeout) != OSAL_SUCCESS) {
+            return 0;
+        }
+        head = RINGBUF_LOAD_ACQUIRE(&rb->head);
+    }
+
+    n = head - tail;
+    if (n > count) {
+        n = count;
+    }
+    ringbuf_copy_out(rb, tail, (uint8_t *)data, n);
+    RINGBUF_STORE_RELEASE(&rb->tail, tail + n);
+    return n;
+}
+
+osal_status_t osal_ringbuf_create(osal_ringbuf_t *rb, const char *name,
+                                  unsigned int elem_size, unsigned int elem_count,
+                                  void *buffer, uint8_t flags)
+{
+    if (rb == NULL || buffer == NULL || elem_size == 0 || elem_count == 0) {
+        return OSAL_INVALID_PARAM;
+    }
+    /* 自由递增索引依赖2的幂取模 */
+    if ((elem_count & (elem_count - 1U)) != 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    rb->buffer = (uint8_t *)buffer;
+    rb->elem_size = elem_size;
+    rb->elem_count = elem_count;
+    rb->mask = elem_count - 1U;
+    rb->head = 0;
+    rb->tail = 0;
+    rb->dropped = 0;
+    rb->peak = 0;
+    rb->flags = flags;
+    rb->name = name;
+
+    if (flags & OSAL_RINGBUF_FLAG_BLOCKING) {
+        if (osal_sem_create(&rb->sem, name, 0) != OSAL_SUCCESS) {
+            return OSAL_ERROR;
+        }
+    }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_ringbuf_push(osal_ringbuf_t *rb, const void *elem)
+{
+    if (rb == NULL || elem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    return (ringbuf_produce(rb, elem, 1, 1) == 1) ? OSAL_SUCCESS : OSAL_NO_MEMORY;
+}
+
+osal_status_t osal_ringbuf_pop(osal_ringbuf_t *rb, void *elem, osal_tick_t timeout)
+{
+    if (rb == NULL || elem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    return (ringbuf_consume(rb, elem, 1, timeout) == 1) ? OSAL_SUCCESS : OSAL_TIMEOUT;
+}
+
+unsigned int osal_ringbuf_write(osal_ringbuf_t *rb, const void *data, unsigned int count)
+{
+    if (rb == NULL || data == NULL || count == 0) {
+        return 0;
+    }
+    return ringbuf_produce(rb, data, count, 0);
+}
+
+unsigned int osal_ringbuf_read(osal_ringbuf_t *rb, void *data, unsigned int count, osal_tick_t timeout)
+{
+    if (rb == NULL || data == NULL || count == 0) {
+        return 0;
+    }
+    return ringbuf_consume(rb, data, count, timeout);
+}
+
+unsigned int osal_ringbuf_count(osal_ringbuf_t *rb)
+{
+    if (rb == NULL) {
+        return 0;
+    }
+    return RINGBUF_LOAD_ACQUIRE(&rb->head) - RINGBUF_LOAD_ACQUIRE(&rb->tail);
+}
+
+osal_status_t osal_ringbuf_delete(osal_ringbuf_t *rb)
+{
+    if (rb == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    if (rb->flags & OSAL_RINGBUF_FLAG_BLOCKING) {
+        osal_sem_delete(&rb->sem);
+    }
+    rb->buffer = NULL;
+    return OSAL_SUCCESS;
+}
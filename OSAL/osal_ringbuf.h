@@ -0,0 +1,110 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-14 14:20:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-14 14:20:00
+ * @FilePath: /rm_base/OSAL/osal_ringbuf.h
+ * @Description: 单生产者/单消费者无锁环形缓冲区，用于中断到线程的数据传递
+ */
+#ifndef __OSAL_RINGBUF_H__
+#define __OSAL_RINGBUF_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 环形缓冲区创建选项 */
+#define OSAL_RINGBUF_FLAG_NONE      0x00U  /* 非阻塞，读空时立即返回 */
+#define OSAL_RINGBUF_FLAG_BLOCKING  0x01U  /* 内部创建信号量，读空时可阻塞等待 */
+
+/*
+ * 约束：只能有一个生产者(通常是中断)和一个消费者(通常是线程)。
+ * head只由生产者写，tail只由消费者写，两者均为自由递增计数，通过mask取模，
+ * 因此elem_count必须是2的幂。
+ */
+typedef struct {
+    uint8_t *buffer;            /* 数据区，大小为elem_size * elem_count字节 */
+    uint32_t elem_size;         /* 元素大小(字节)，字节流模式为1 */
+    uint32_t elem_count;        /* 元素个数，2的幂 */
+    uint32_t mask;              /* elem_count - 1 */
+    volatile uint32_t head;     /* 写位置，生产者维护 */
+    volatile uint32_t tail;     /* 读位置，消费者维护 */
+    volatile uint32_t dropped;  /* 因缓冲区满被丢弃的元素数 */
+    uint32_t peak;              /* 历史最大占用元素数 */
+    uint8_t flags;              /* OSAL_RINGBUF_FLAG_* */
+    osal_sem_t sem;             /* 阻塞读使用的信号量 */
+    const char *name;
+} osal_ringbuf_t;
+
+/**
+ * @description: 创建环形缓冲区
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @param {const char*} name, 名称
+ * @param {unsigned int} elem_size, 元素大小(字节)，字节流模式传1，定长记录模式传记录大小
+ * @param {unsigned int} elem_count, 元素个数，必须是2的幂
+ * @param {void*} buffer, 数据区，大小至少为elem_size * elem_count字节
+ * @param {uint8_t} flags, OSAL_RINGBUF_FLAG_*
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 信号量创建失败
+ */
+osal_status_t osal_ringbuf_create(osal_ringbuf_t *rb, const char *name,
+                                  unsigned int elem_size, unsigned int elem_count,
+                                  void *buffer, uint8_t flags);
+
+/**
+ * @description: 写入一条记录(全部写入或丢弃)，可在中断中调用，无等待
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @param {const void*} elem, 一个元素的数据
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_NO_MEMORY - 缓冲区满已丢弃, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_ringbuf_push(osal_ringbuf_t *rb, const void *elem);
+
+/**
+ * @description: 读出一条记录，线程中调用
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @param {void*} elem, 读出数据存放地址
+ * @param {osal_tick_t} timeout, 超时时间，非阻塞模式下忽略
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 缓冲区空, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_ringbuf_pop(osal_ringbuf_t *rb, void *elem, osal_tick_t timeout);
+
+/**
+ * @description: 写入多个元素(字节流模式)，空间不足时尽量写入，剩余部分计入dropped，可在中断中调用
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @param {const void*} data, 数据
+ * @param {unsigned int} count, 元素个数
+ * @return {unsigned int} 实际写入的元素个数
+ */
+unsigned int osal_ringbuf_write(osal_ringbuf_t *rb, const void *data, unsigned int count);
+
+/**
+ * @description: 读出多个元素(字节流模式)，阻塞模式下至少等到1个元素或超时
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @param {void*} data, 读出数据存放地址
+ * @param {unsigned int} count, 最多读取的元素个数
+ * @param {osal_tick_t} timeout, 超时时间，非阻塞模式下忽略
+ * @return {unsigned int} 实际读出的元素个数
+ */
+unsigned int osal_ringbuf_read(osal_ringbuf_t *rb, void *data, unsigned int count, osal_tick_t timeout);
+
+/**
+ * @description: 获取当前可读元素个数
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @return {unsigned int}
+ */
+unsigned int osal_ringbuf_count(osal_ringbuf_t *rb);
+
+/**
+ * @description: 删除环形缓冲区(删除阻塞模式下的信号量)
+ * @param {osal_ringbuf_t*} rb, 环形缓冲区句柄指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_ringbuf_delete(osal_ringbuf_t *rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_RINGBUF_H__ */
@@ -1,4 +1,19 @@
+#define OSAL_INLINE_IMPL    /* 本文件提供库中的函数实体，不使用osal_inline.h的映射 */
 #include "osal_def.h"
+#include "osal_lockstat.h"
+#include "osal_waitany.h"
+
+#if OSAL_LOCK_STATS_ENABLE
+/* 开启统计时，下面各后端实现编译为*_raw，由文件末尾的统计包装函数调用 */
+#define osal_sem_create osal_sem_create_raw
+#define osal_sem_wait osal_sem_wait_raw
+#define osal_sem_delete osal_sem_delete_raw
+#endif
+
+#if OSAL_WAIT_ANY_ENABLE
+/* 开启多对象等待时，osal_sem_post编译为*_raw，由文件末尾的包装函数在成功后通知等待者 */
+#define osal_sem_post osal_sem_post_raw
+#endif
 
 #if (OSAL_RTOS_TYPE == OSAL_THREADX)
 
@@ -173,4 +188,118 @@ osal_status_t osal_sem_delete(osal_sem_t *sem)
     return OSAL_SUCCESS;
 }
 
-#endif
\ No newline at end of file
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+#include "osal_posix.h"
+
+osal_status_t osal_sem_create(osal_sem_t *sem, const char *name, unsigned int initial_count)
+{
+    if (sem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    if (pthread_mutex_init(&sem->lock, NULL) != 0) {
+        return OSAL_ERROR;
+    }
+    if (osal_posix_cond_init(&sem->cond) != 0) {
+        pthread_mutex_destroy(&sem->lock);
+        return OSAL_ERROR;
+    }
+    sem->count = initial_count;
+    sem->name = name;
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_sem_wait(osal_sem_t *sem, osal_tick_t timeout)
+{
+    if (sem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    struct timespec abstime;
+    int ret = 0;
+
+    if (timeout != OSAL_WAIT_FOREVER && timeout != OSAL_NO_WAIT) {
+        osal_posix_abstime(timeout, &abstime);
+    }
+
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0 && timeout != OSAL_NO_WAIT && ret != ETIMEDOUT) {
+        ret = osal_posix_cond_wait(&sem->cond, &sem->lock,
+                                   (timeout == OSAL_WAIT_FOREVER) ? NULL : &abstime);
+    }
+    if (sem->count == 0) {
+        pthread_mutex_unlock(&sem->lock);
+        return OSAL_TIMEOUT;
+    }
+    sem->count--;
+    pthread_mutex_unlock(&sem->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_sem_post(osal_sem_t *sem)
+{
+    if (sem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&sem->lock);
+    sem->count++;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_sem_delete(osal_sem_t *sem)
+{
+    if (sem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->lock);
+    return OSAL_SUCCESS;
+}
+
+#endif
+
+#if OSAL_LOCK_STATS_ENABLE
+#undef osal_sem_create
+#undef osal_sem_wait
+#undef osal_sem_delete
+
+osal_status_t osal_sem_create(osal_sem_t *sem, const char *name, unsigned int initial_count)
+{
+    osal_status_t status = osal_sem_create_raw(sem, name, initial_count);
+    if (status == OSAL_SUCCESS) {
+        osal_lockstat_register(sem, name, OSAL_LOCKSTAT_SEM);
+    }
+    return status;
+}
+
+osal_status_t osal_sem_wait(osal_sem_t *sem, osal_tick_t timeout)
+{
+    osal_status_t status;
+
+    OSAL_LOCKSTAT_WAIT(status, sem, timeout, osal_sem_wait_raw(sem, _lockstat_timeout));
+    return status;
+}
+
+osal_status_t osal_sem_delete(osal_sem_t *sem)
+{
+    osal_lockstat_unregister(sem);
+    return osal_sem_delete_raw(sem);
+}
+
+#endif /* OSAL_LOCK_STATS_ENABLE */
+
+#if OSAL_WAIT_ANY_ENABLE
+#undef osal_sem_post
+
+osal_status_t osal_sem_post(osal_sem_t *sem)
+{
+    osal_status_t status = osal_sem_post_raw(sem);
+    if (status == OSAL_SUCCESS) {
+        osal_waitany_notify(sem);
+    }
+    return status;
+}
+
+#endif /* OSAL_WAIT_ANY_ENABLE */
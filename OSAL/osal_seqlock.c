@@ -0,0 +1,51 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-16 10:15:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-16 10:15:00
+ * @FilePath: /rm_base/OSAL/osal_seqlock.c
+ * @Description: 顺序锁(双缓冲版本快照)实现
+ */
+#include "osal_seqlock.h"
+#include <string.h>
+
+osal_status_t osal_seqlock_init(osal_seqlock_t *sl, void *buf0, void *buf1, unsigned int size)
+{
+    if (sl == NULL || buf0 == NULL || buf1 == NULL || size == 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    sl->slot[0] = buf0;
+    sl->slot[1] = buf1;
+    sl->size = size;
+    sl->retries = 0;
+    memset(buf0, 0, size);
+    memset(buf1, 0, size);
+    __atomic_store_n(&sl->seq, 0, __ATOMIC_RELEASE);
+    return OSAL_SUCCESS;
+}
+
+void osal_seqlock_write(osal_seqlock_t *sl, const void *data)
+{
+    uint32_t seq = sl->seq;
+
+    /* 写入读者当前不使用的一份，完成后以release语义发布新版本号 */
+    memcpy(sl->slot[(seq + 1U) & 1U], data, sl->size);
+    __atomic_store_n(&sl->seq, seq + 1U, __ATOMIC_RELEASE);
+}
+
+uint32_t osal_seqlock_read(osal_seqlock_t *sl, void *out)
+{
+    uint32_t seq;
+
+    for (;;) {
+        seq = __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+        memcpy(out, sl->slot[seq & 1U], sl->size);
+        /* 拷贝完成后再读版本号，期间写者发布过则这一份可能正被改写 */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&sl->seq, __ATOMIC_RELAXED) == seq) {
+            return seq;
+        }
+        sl->retries++;
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-16 10:15:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-16 10:15:00
+ * @FilePath: /rm_base/OSAL/osal_seqlock.h
+ * @Description: 顺序锁(双缓冲版本快照)，单写者发布不阻塞，多读者无锁读取一致快照
+ */
+#ifndef __OSAL_SEQLOCK_H__
+#define __OSAL_SEQLOCK_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 数据保存两份：写者总是写入读者当前不使用的那一份，写完后递增版本号切换。
+ * 读者按版本号选择一份拷贝出来，拷贝前后版本号相同则数据一致，否则重试。
+ * 写者在写入过程中被高优先级读者抢占时，读者读取的是另一份完整数据，不会一直重试。
+ * 只允许一个写者，多个写者需要自行互斥。
+ */
+typedef struct {
+    volatile uint32_t seq;      /* 版本号，每次发布加1，seq & 1为当前有效的数据份 */
+    void *slot[2];              /* 两份数据缓冲 */
+    uint32_t size;              /* 数据大小(字节) */
+    volatile uint32_t retries;  /* 读者重试次数统计 */
+} osal_seqlock_t;
+
+/**
+ * @description: 初始化顺序锁
+ * @param {osal_seqlock_t*} sl, 顺序锁指针
+ * @param {void*} buf0, 数据缓冲0
+ * @param {void*} buf1, 数据缓冲1
+ * @param {unsigned int} size, 数据大小(字节)
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_seqlock_init(osal_seqlock_t *sl, void *buf0, void *buf1, unsigned int size);
+
+/**
+ * @description: 发布一份新数据，写者不会阻塞，可在中断中调用
+ * @param {osal_seqlock_t*} sl, 顺序锁指针
+ * @param {const void*} data, 新数据，大小为初始化时的size
+ * @return {*}
+ */
+void osal_seqlock_write(osal_seqlock_t *sl, const void *data);
+
+/**
+ * @description: 读取一致的数据快照，期间有新数据发布则重试
+ * @param {osal_seqlock_t*} sl, 顺序锁指针
+ * @param {void*} out, 输出缓冲，大小为初始化时的size
+ * @return {uint32_t} 读到的数据版本号，0表示尚未发布过数据
+ */
+uint32_t osal_seqlock_read(osal_seqlock_t *sl, void *out);
+
+/**
+ * @description: 获取当前版本号，可用于判断是否有新数据
+ * @param {osal_seqlock_t*} sl, 顺序锁指针
+ * @return {uint32_t}
+ */
+static inline uint32_t osal_seqlock_version(const osal_seqlock_t *sl)
+{
+    return __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+}
+
+/* 类型化辅助宏：声明type类型的快照变量name，发布/读取时检查指针类型 */
+#define OSAL_SEQLOCK_DEFINE(type, name) \
+    static type name##_buf[2];          \
+    static osal_seqlock_t name
+
+#define OSAL_SEQLOCK_INIT(name) \
+    osal_seqlock_init(&(name), &name##_buf[0], &name##_buf[1], sizeof(name##_buf[0]))
+
+#define OSAL_SEQLOCK_PUBLISH(name, ptr) \
+    ((void)sizeof((ptr) == &name##_buf[0]), osal_seqlock_write(&(name), (ptr)))
+
+#define OSAL_SEQLOCK_SNAPSHOT(name, ptr) \
+    ((void)sizeof((ptr) == &name##_buf[0]), osal_seqlock_read(&(name), (ptr)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_SEQLOCK_H__ */
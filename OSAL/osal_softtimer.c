@@ -276,4 +276,124 @@ uint8_t osal_timer_is_active(osal_timer_t *timer)
     return (xTimerIsTimerActive(timer->handle) == pdTRUE) ? 1 : 0;
 }
 
-#endif
\ No newline at end of file
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+/* POSIX下的定时器实现，基于timer_create(SIGEV_THREAD)，回调在独立线程中执行 */
+static void osal_posix_timer_notify(union sigval sv)
+{
+    osal_timer_t *timer = (osal_timer_t *)sv.sival_ptr;
+    timer->callback(timer->argument);
+}
+
+static void osal_posix_ms_to_timespec(unsigned int ms, struct timespec *ts)
+{
+    ts->tv_sec = (time_t)(ms / 1000U);
+    ts->tv_nsec = (long)(ms % 1000U) * 1000000L;
+}
+
+osal_status_t osal_timer_create(osal_timer_t *timer, 
+                                const char *name,
+                                osal_timer_callback_t callback,
+                                void *argument,
+                                unsigned int timeout_ms,
+                                osal_timer_mode_t mode)
+{
+    struct sigevent sev;
+
+    if (timer == NULL || callback == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    timer->callback = callback;
+    timer->argument = (unsigned long)argument;
+    timer->period_ms = (timeout_ms == 0) ? 1 : timeout_ms; /* 至少1ms */
+    timer->periodic = (mode == OSAL_TIMER_MODE_PERIODIC) ? 1 : 0;
+    timer->name = name;
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = osal_posix_timer_notify;
+    sev.sigev_value.sival_ptr = timer;
+
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timer->handle) != 0) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_timer_start(osal_timer_t *timer)
+{
+    struct itimerspec its;
+
+    if (timer == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    memset(&its, 0, sizeof(its));
+    osal_posix_ms_to_timespec(timer->period_ms, &its.it_value);
+    if (timer->periodic) {
+        its.it_interval = its.it_value;
+    }
+
+    if (timer_settime(timer->handle, 0, &its, NULL) != 0) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_timer_stop(osal_timer_t *timer)
+{
+    struct itimerspec its;
+
+    if (timer == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    memset(&its, 0, sizeof(its));
+    if (timer_settime(timer->handle, 0, &its, NULL) != 0) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_timer_change_period(osal_timer_t *timer, unsigned int timeout_ms)
+{
+    if (timer == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    /* 与ThreadX实现一致，修改周期后定时器处于停止状态，需要重新启动 */
+    timer->period_ms = (timeout_ms == 0) ? 1 : timeout_ms;
+    return osal_timer_stop(timer);
+}
+
+osal_status_t osal_timer_delete(osal_timer_t *timer)
+{
+    if (timer == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (timer_delete(timer->handle) != 0) {
+        return OSAL_ERROR;
+    }
+    return OSAL_SUCCESS;
+}
+
+uint8_t osal_timer_is_active(osal_timer_t *timer)
+{
+    struct itimerspec its;
+
+    if (timer == NULL) {
+        return false;
+    }
+
+    if (timer_gettime(timer->handle, &its) != 0) {
+        return false;
+    }
+    return (its.it_value.tv_sec != 0 || its.it_value.tv_nsec != 0) ? 1 : 0;
+}
+
+#endif
@@ -6,8 +6,13 @@
  * @FilePath: /rm_base/OSAL/osal_thread.c
  * @Description: 
  */
+#define OSAL_INLINE_IMPL    /* 本文件提供库中的函数实体，不使用osal_inline.h的映射 */
 #include "osal_def.h"
 
+#if (OSAL_RTOS_TYPE != OSAL_POSIX)
+#include "stm32f4xx.h"  /* DWT->CYCCNT, SystemCoreClock */
+#endif
+
 #if (OSAL_RTOS_TYPE == OSAL_THREADX)
 
 #include "tx_api.h"
@@ -120,6 +125,132 @@ osal_status_t osal_thread_delete(osal_thread_t *thread)
     vTaskDelete((TaskHandle_t)thread);
     return OSAL_SUCCESS;
 }
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+
+#include "osal_posix.h"
+#include <string.h>
+
+/* 当前线程对应的osal线程句柄，用于osal_thread_stop挂起自身和协作式挂起 */
+static __thread osal_thread_t *osal_posix_self = NULL;
+
+/**
+ * @description: 协作式挂起点，线程被osal_thread_stop后在此等待osal_thread_start
+ * @note: pthread无法从外部挂起其他线程，因此挂起请求在目标线程下一次调用osal_delay_ms/osal_delay_us时生效
+ */
+static void osal_posix_suspend_point(void)
+{
+    osal_thread_t *self = osal_posix_self;
+    if (self == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&self->lock);
+    while (self->suspended) {
+        pthread_cond_wait(&self->cond, &self->lock);
+    }
+    pthread_mutex_unlock(&self->lock);
+}
+
+static void *osal_posix_thread_entry(void *arg)
+{
+    osal_thread_t *thread = (osal_thread_t *)arg;
+    osal_posix_self = thread;
+    thread->entry(thread->argument);
+    return NULL;
+}
+
+/* POSIX下的线程实现 */
+osal_status_t osal_thread_create(osal_thread_t *thread, 
+                                 const char *name,
+                                 osal_thread_entry_t entry,
+                                 void *argument,
+                                 void *stack_pointer,
+                                 unsigned int stack_size,
+                                 osal_thread_priority_t priority)
+{
+    if (thread == NULL || entry == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    /* 主机下线程使用pthread自行分配的栈，stack_pointer/stack_size仅用于保持接口一致 */
+    (void)stack_pointer;
+    (void)stack_size;
+
+    memset(thread, 0, sizeof(osal_thread_t));
+    if (pthread_mutex_init(&thread->lock, NULL) != 0) {
+        return OSAL_ERROR;
+    }
+    if (osal_posix_cond_init(&thread->cond) != 0) {
+        pthread_mutex_destroy(&thread->lock);
+        return OSAL_ERROR;
+    }
+    thread->name = name;
+    thread->entry = entry;
+    thread->argument = (unsigned long)argument;
+    thread->priority = priority;
+    /* 与ThreadX的TX_DONT_START一致，创建后处于挂起状态，需要osal_thread_start启动 */
+    thread->suspended = 1;
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_thread_start(osal_thread_t *thread)
+{
+    if (thread == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&thread->lock);
+    thread->suspended = 0;
+    if (!thread->started) {
+        if (pthread_create(&thread->handle, NULL, osal_posix_thread_entry, thread) != 0) {
+            thread->suspended = 1;
+            pthread_mutex_unlock(&thread->lock);
+            return OSAL_ERROR;
+        }
+        thread->started = 1;
+    }
+    pthread_cond_broadcast(&thread->cond);
+    pthread_mutex_unlock(&thread->lock);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_thread_stop(osal_thread_t *thread)
+{
+    if (thread == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&thread->lock);
+    thread->suspended = 1;
+    pthread_mutex_unlock(&thread->lock);
+
+    /* 挂起自身时立即生效 */
+    if (thread == osal_posix_self) {
+        osal_posix_suspend_point();
+    }
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_thread_delete(osal_thread_t *thread)
+{
+    if (thread == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    if (thread == osal_posix_self) {
+        /* 线程删除自身(如robot_init_entry)，分离后直接退出 */
+        pthread_detach(thread->handle);
+        osal_posix_self = NULL;
+        pthread_exit(NULL);
+    }
+
+    if (thread->started) {
+        pthread_cancel(thread->handle);
+        pthread_join(thread->handle, NULL);
+        thread->started = 0;
+    }
+    pthread_cond_destroy(&thread->cond);
+    pthread_mutex_destroy(&thread->lock);
+    return OSAL_SUCCESS;
+}
 #endif
 
 /* 通用延时函数 */
@@ -132,11 +263,87 @@ void osal_delay_ms(unsigned int ms)
     tx_thread_sleep(ms);
 #elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
     vTaskDelay(pdMS_TO_TICKS(ms));
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L };
+    osal_posix_suspend_point();
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
 #endif
 }
 
 void osal_delay_us(unsigned int us)
 {
-    // 简单的循环延时,由于rtos无法精确到微秒级别，这里与裸机模式实现相同
-    for (volatile int i = 0; i < us; i++){asm volatile("nop");}
-}
\ No newline at end of file
+#if (OSAL_RTOS_TYPE == OSAL_POSIX)
+    struct timespec ts = { .tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000L };
+    osal_posix_suspend_point();
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+#else
+    // 按DWT周期计数忙等，与主频无关；DWT尚未使能时先使能
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = us * (SystemCoreClock / 1000000U);
+    while ((DWT->CYCCNT - start) < cycles) {
+    }
+#endif
+}
+
+osal_tick_t osal_tick_get(void)
+{
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+    return tx_time_get();
+#elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+    return xPortIsInsideInterrupt() ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (osal_tick_t)((uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL);
+#endif
+}
+
+osal_status_t osal_delay_until(osal_tick_t *prev_wake, osal_tick_t increment)
+{
+    osal_tick_t target;
+    osal_tick_t now;
+
+    if (prev_wake == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    target = *prev_wake + increment;
+    *prev_wake = target;
+    now = osal_tick_get();
+    /* 按有符号差值判断，兼容tick回绕；目标时刻已过则不休眠，返回OSAL_TIMEOUT由调用者统计 */
+    if ((long)(target - now) <= 0) {
+        return OSAL_TIMEOUT;
+    }
+#if (OSAL_RTOS_TYPE == OSAL_THREADX)
+    tx_thread_sleep(target - now);
+#elif (OSAL_RTOS_TYPE == OSAL_FREERTOS)
+    vTaskDelay(target - now);
+#elif (OSAL_RTOS_TYPE == OSAL_POSIX)
+    osal_delay_ms((unsigned int)(target - now));
+#endif
+    return OSAL_SUCCESS;
+}
+
+uint32_t osal_cycle_get(void)
+{
+#if (OSAL_RTOS_TYPE == OSAL_POSIX)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+uint32_t osal_cycle_per_us(void)
+{
+#if (OSAL_RTOS_TYPE == OSAL_POSIX)
+    return 1000U;
+#else
+    return SystemCoreClock / 1000000U;
+#endif
+}
@@ -0,0 +1,429 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-21 20:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-21 20:00:00
+ * @FilePath: /rm_base/OSAL/osal_utimer.c
+ * @Description: 微秒级休眠和超时实现
+ */
+#include "osal_utimer.h"
+#include "osal_waitany.h"
+
+/*
+ * 每个等待槽有一个截止时刻和一个唤醒信号量。定时器比较寄存器总是设置为最早的截止时刻，
+ * 比较中断中释放所有到期槽的信号量，再设置下一个截止时刻。
+ * osal_sleep_us直接等待唤醒信号量；带微秒超时的信号量/事件等待用osal_wait_any同时等待目标对象和唤醒信号量，
+ * 哪个先就绪就返回，目标对象与定时器同时就绪时优先返回目标对象。
+ * 阻塞等待同时带一个比截止时刻多1个tick的超时作为兜底。
+ */
+typedef struct {
+    uint32_t deadline;          /* 截止时刻(osal_utimer_now) */
+    uint8_t armed;
+    uint8_t used;
+    uint8_t sem_created;
+    osal_sem_t wake;
+} utimer_waiter_t;
+
+static utimer_waiter_t utimer_waiters[OSAL_UTIMER_MAX_WAITERS];
+static volatile uint8_t utimer_ready = 0;
+static osal_utimer_stats_t utimer_stats;
+
+#if (OSAL_RTOS_TYPE != OSAL_POSIX)
+
+#include "stm32f4xx.h"
+
+static void utimer_hw_init(void)
+{
+    uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+    uint32_t pclk1 = SystemCoreClock >> APBPrescTable[ppre1];
+    /* APB1分频不为1时定时器时钟为PCLK1的2倍 */
+    uint32_t timclk = (APBPrescTable[ppre1] == 0U) ? pclk1 : pclk1 * 2U;
+
+    OSAL_UTIMER_CLK_ENABLE();
+    OSAL_UTIMER_TIM->CR1 = 0;
+    OSAL_UTIMER_TIM->PSC = timclk / 1000000U - 1U;
+    OSAL_UTIMER_TIM->ARR = 0xFFFFFFFFU;
+    OSAL_UTIMER_TIM->CCMR1 = 0;                 /* 通道1输出比较冻结模式，只产生比较标志 */
+    OSAL_UTIMER_TIM->DIER = 0;
+    OSAL_UTIMER_TIM->EGR = TIM_EGR_UG;          /* 立即装载预分频 */
+    OSAL_UTIMER_TIM->SR = 0;
+    OSAL_UTIMER_TIM->CR1 = TIM_CR1_CEN;
+
+    NVIC_SetPriority(OSAL_UTIMER_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), OSAL_UTIMER_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(OSAL_UTIMER_IRQn);
+}
+
+static inline uint32_t utimer_hw_now(void)
+{
+    return OSAL_UTIMER_TIM->CNT;
+}
+
+static inline void utimer_hw_program(uint32_t deadline)
+{
+    OSAL_UTIMER_TIM->CCR1 = deadline;
+    OSAL_UTIMER_TIM->SR = ~(uint32_t)TIM_SR_CC1IF;
+    OSAL_UTIMER_TIM->DIER |= TIM_DIER_CC1IE;
+}
+
+static inline void utimer_hw_stop(void)
+{
+    OSAL_UTIMER_TIM->DIER &= ~TIM_DIER_CC1IE;
+}
+
+#else /* OSAL_POSIX */
+
+/* 主机上用一个线程模拟比较中断：等待到最早的截止时刻后执行与中断相同的处理 */
+#include <pthread.h>
+#include <time.h>
+
+static pthread_t utimer_thread;
+static pthread_mutex_t utimer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t utimer_cond;
+static uint8_t utimer_hw_armed = 0;
+static uint32_t utimer_hw_deadline = 0;
+
+static void utimer_service(void);
+
+static inline uint32_t utimer_hw_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL);
+}
+
+static void *utimer_thread_entry(void *arg)
+{
+    osal_critical_state_t crit;
+    (void)arg;
+
+    pthread_mutex_lock(&utimer_lock);
+    for (;;) {
+        if (!utimer_hw_armed) {
+            pthread_cond_wait(&utimer_cond, &utimer_lock);
+            continue;
+        }
+        int32_t left = (int32_t)(utimer_hw_deadline - utimer_hw_now());
+        if (left > 0) {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            ts.tv_sec += left / 1000000;
+            ts.tv_nsec += (long)(left % 1000000) * 1000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&utimer_cond, &utimer_lock, &ts);
+            continue;
+        }
+        utimer_hw_armed = 0;
+        /* 与中断一样在临界区中处理；锁顺序为临界区->utimer_lock，这里先释放utimer_lock */
+        pthread_mutex_unlock(&utimer_lock);
+        osal_enter_critical(&crit);
+        utimer_stats.irqs++;
+        utimer_service();
+        osal_exit_critical(&crit);
+        pthread_mutex_lock(&utimer_lock);
+    }
+    return NULL;
+}
+
+static void utimer_hw_init(void)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&utimer_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_create(&utimer_thread, NULL, utimer_thread_entry, NULL);
+}
+
+static inline void utimer_hw_program(uint32_t deadline)
+{
+    pthread_mutex_lock(&utimer_lock);
+    utimer_hw_deadline = deadline;
+    utimer_hw_armed = 1;
+    pthread_cond_signal(&utimer_cond);
+    pthread_mutex_unlock(&utimer_lock);
+}
+
+static inline void utimer_hw_stop(void)
+{
+    pthread_mutex_lock(&utimer_lock);
+    utimer_hw_armed = 0;
+    pthread_mutex_unlock(&utimer_lock);
+}
+
+#endif
+
+/* 在临界区中调用：唤醒所有到期的等待槽，比较寄存器设置为最早的截止时刻 */
+static void utimer_service(void)
+{
+    for (;;) {
+        uint32_t now = utimer_hw_now();
+        uint32_t next = 0;
+        int32_t next_left = 0;
+        uint8_t pending = 0;
+
+        for (unsigned int i = 0; i < OSAL_UTIMER_MAX_WAITERS; i++) {
+            utimer_waiter_t *w = &utimer_waiters[i];
+            if (!w->armed) {
+                continue;
+            }
+            int32_t left = (int32_t)(w->deadline - now);
+            if (left <= 0) {
+                w->armed = 0;
+                osal_sem_post(&w->wake);
+            } else if (!pending || left < next_left) {
+                pending = 1;
+                next_left = left;
+                next = w->deadline;
+            }
+        }
+        if (!pending) {
+            utimer_hw_stop();
+            return;
+        }
+        utimer_hw_program(next);
+        /* 设置比较值时已经错过的截止时刻不会再产生中断，重新处理 */
+        if ((int32_t)(next - utimer_hw_now()) > 0) {
+            return;
+        }
+    }
+}
+
+#if (OSAL_RTOS_TYPE != OSAL_POSIX)
+void OSAL_UTIMER_IRQHandler(void)
+{
+    osal_critical_state_t crit;
+
+    OSAL_UTIMER_TIM->SR = ~(uint32_t)TIM_SR_CC1IF;
+    osal_enter_critical(&crit);
+    utimer_stats.irqs++;
+    utimer_service();
+    osal_exit_critical(&crit);
+}
+#endif
+
+osal_status_t osal_utimer_init(void)
+{
+    static uint8_t started = 0;
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    if (started) {
+        osal_exit_critical(&crit);
+        return OSAL_SUCCESS;
+    }
+    started = 1;
+    osal_exit_critical(&crit);
+
+    /* 硬件配置完成后才允许登记等待，之前的调用退化为tick超时 */
+    utimer_hw_init();
+    utimer_ready = 1;
+    return OSAL_SUCCESS;
+}
+
+uint32_t osal_utimer_now(void)
+{
+    return utimer_hw_now();
+}
+
+/* tick兜底超时：向上取整再加1个tick，保证不早于截止时刻 */
+static osal_tick_t utimer_us_to_ticks(uint32_t us)
+{
+    return (osal_tick_t)(((uint64_t)us * OSAL_TICK_RATE_HZ + 999999U) / 1000000U) + 1U;
+}
+
+static utimer_waiter_t *utimer_waiter_alloc(void)
+{
+    osal_critical_state_t crit;
+    utimer_waiter_t *w = NULL;
+
+    if (!utimer_ready) {
+        return NULL;
+    }
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_UTIMER_MAX_WAITERS; i++) {
+        if (!utimer_waiters[i].used) {
+            w = &utimer_waiters[i];
+            w->used = 1;
+            break;
+        }
+    }
+    osal_exit_critical(&crit);
+    if (w == NULL) {
+        return NULL;
+    }
+
+    if (!w->sem_created) {
+        if (osal_sem_create(&w->wake, "utimer", 0) != OSAL_SUCCESS) {
+            w->used = 0;
+            return NULL;
+        }
+        w->sem_created = 1;
+    }
+    /* 上一个使用者在定时器到期前返回时可能还留有唤醒计数 */
+    while (osal_sem_wait(&w->wake, OSAL_NO_WAIT) == OSAL_SUCCESS) {
+    }
+    return w;
+}
+
+static void utimer_arm(utimer_waiter_t *w, uint32_t deadline)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    w->deadline = deadline;
+    w->armed = 1;
+    utimer_service();
+    osal_exit_critical(&crit);
+}
+
+static void utimer_release(utimer_waiter_t *w)
+{
+    osal_critical_state_t crit;
+
+    /* 比较值不必重新设置，到期中断找不到该槽即可 */
+    osal_enter_critical(&crit);
+    w->armed = 0;
+    w->used = 0;
+    osal_exit_critical(&crit);
+}
+
+void osal_sleep_us(uint32_t us)
+{
+    utimer_waiter_t *w;
+    uint32_t start, deadline, late;
+
+    if (us == 0) {
+        return;
+    }
+    if (us < OSAL_UTIMER_SPIN_US) {
+        osal_delay_us(us);
+        utimer_stats.spins++;
+        return;
+    }
+
+    w = utimer_waiter_alloc();
+    if (w == NULL) {
+        osal_delay_ms((unsigned int)((us + 999U) / 1000U));
+        utimer_stats.fallbacks++;
+        return;
+    }
+
+    start = utimer_hw_now();
+    deadline = start + us;
+    utimer_arm(w, deadline);
+    while (osal_sem_wait(&w->wake, utimer_us_to_ticks(us)) != OSAL_SUCCESS) {
+        if ((int32_t)(deadline - utimer_hw_now()) <= 0) {
+            break;
+        }
+    }
+    late = utimer_hw_now() - deadline;
+    utimer_release(w);
+
+    utimer_stats.sleeps++;
+    utimer_stats.late_total += late;
+    if (late > utimer_stats.late_max) {
+        utimer_stats.late_max = late;
+    }
+}
+
+#if OSAL_WAIT_ANY_ENABLE
+/* 同时等待目标对象和定时器，index为0表示目标对象就绪 */
+static osal_status_t utimer_wait_obj(osal_wait_obj_t *target, uint32_t timeout_us)
+{
+    utimer_waiter_t *w = utimer_waiter_alloc();
+    osal_status_t status;
+    unsigned int index;
+
+    if (w == NULL) {
+        return OSAL_ERROR;
+    }
+    osal_wait_obj_t objects[2] = { *target, OSAL_WAIT_OBJ_SEM(&w->wake) };
+
+    utimer_arm(w, utimer_hw_now() + timeout_us);
+    status = osal_wait_any(objects, 2, utimer_us_to_ticks(timeout_us), &index);
+    utimer_release(w);
+    if (status == OSAL_ERROR) {
+        return OSAL_ERROR;
+    }
+
+    utimer_stats.waits++;
+    if (status == OSAL_SUCCESS && index == 0) {
+        target->actual_flags = objects[0].actual_flags;
+        return OSAL_SUCCESS;
+    }
+    utimer_stats.timeouts++;
+    return OSAL_TIMEOUT;
+}
+#endif
+
+osal_status_t osal_sem_wait_us(osal_sem_t *sem, uint32_t timeout_us)
+{
+    osal_status_t status;
+
+    if (sem == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    status = osal_sem_wait(sem, OSAL_NO_WAIT);
+    if (status == OSAL_SUCCESS || timeout_us == 0) {
+        return status;
+    }
+#if OSAL_WAIT_ANY_ENABLE
+    osal_wait_obj_t target = OSAL_WAIT_OBJ_SEM(sem);
+    status = utimer_wait_obj(&target, timeout_us);
+    if (status != OSAL_ERROR) {
+        return status;
+    }
+#endif
+    /* 定时器未初始化或等待槽不足，退化为tick超时 */
+    utimer_stats.fallbacks++;
+    return osal_sem_wait(sem, utimer_us_to_ticks(timeout_us));
+}
+
+osal_status_t osal_event_wait_us(osal_event_t *event, unsigned int requested_flags, unsigned int options,
+                                 uint32_t timeout_us, unsigned int *actual_flags)
+{
+    osal_status_t status;
+
+    if (event == NULL || actual_flags == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    status = osal_event_wait(event, requested_flags, options, OSAL_NO_WAIT, actual_flags);
+    if (status == OSAL_SUCCESS || timeout_us == 0) {
+        return status;
+    }
+#if OSAL_WAIT_ANY_ENABLE
+    osal_wait_obj_t target = OSAL_WAIT_OBJ_EVENT(event, requested_flags, options);
+    status = utimer_wait_obj(&target, timeout_us);
+    if (status != OSAL_ERROR) {
+        *actual_flags = target.actual_flags;
+        return status;
+    }
+#endif
+    utimer_stats.fallbacks++;
+    return osal_event_wait(event, requested_flags, options, utimer_us_to_ticks(timeout_us), actual_flags);
+}
+
+void osal_utimer_stats_get(osal_utimer_stats_t *stats)
+{
+    osal_critical_state_t crit;
+
+    if (stats == NULL) {
+        return;
+    }
+    osal_enter_critical(&crit);
+    *stats = utimer_stats;
+    osal_exit_critical(&crit);
+}
+
+void osal_utimer_stats_reset(void)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    utimer_stats = (osal_utimer_stats_t){0};
+    osal_exit_critical(&crit);
+}
@@ -0,0 +1,112 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-21 20:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-21 20:00:00
+ * @FilePath: /rm_base/OSAL/osal_utimer.h
+ * @Description: 微秒级休眠和超时，由硬件定时器单次比较中断唤醒等待线程，等待期间不占用CPU
+ */
+#ifndef __OSAL_UTIMER_H__
+#define __OSAL_UTIMER_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 同时进行微秒等待的线程数上限 */
+#ifndef OSAL_UTIMER_MAX_WAITERS
+#define OSAL_UTIMER_MAX_WAITERS     4
+#endif
+
+/* 短于该时长(us)时直接忙等，线程切换和中断唤醒的开销比等待本身更大 */
+#ifndef OSAL_UTIMER_SPIN_US
+#define OSAL_UTIMER_SPIN_US         20
+#endif
+
+#if (OSAL_RTOS_TYPE != OSAL_POSIX)
+/* 1MHz自由运行的32位定时器，CubeMX中未使用的TIM2，比较通道1产生唤醒中断 */
+#ifndef OSAL_UTIMER_TIM
+#define OSAL_UTIMER_TIM             TIM2
+#define OSAL_UTIMER_IRQn            TIM2_IRQn
+#define OSAL_UTIMER_IRQHandler      TIM2_IRQHandler
+#define OSAL_UTIMER_CLK_ENABLE()    (RCC->APB1ENR |= RCC_APB1ENR_TIM2EN)
+#endif
+
+/* 比较中断优先级，需在RTOS可管理的范围内(FreeRTOS下不高于configMAX_SYSCALL_INTERRUPT_PRIORITY) */
+#ifndef OSAL_UTIMER_IRQ_PRIORITY
+#define OSAL_UTIMER_IRQ_PRIORITY    5
+#endif
+#endif
+
+/* 统计，时间单位为us */
+typedef struct {
+    uint32_t sleeps;            /* 由定时器唤醒的osal_sleep_us次数 */
+    uint32_t spins;             /* 时长短于OSAL_UTIMER_SPIN_US而忙等的次数 */
+    uint32_t waits;             /* 带微秒超时的信号量/事件等待次数 */
+    uint32_t timeouts;          /* 其中超时的次数 */
+    uint32_t fallbacks;         /* 等待槽不足退化为tick超时的次数 */
+    uint32_t irqs;              /* 比较中断次数 */
+    uint32_t late_max;          /* osal_sleep_us醒来时超过截止时刻的最大时长 */
+    uint64_t late_total;        /* 平均值 = late_total / sleeps */
+} osal_utimer_stats_t;
+
+/**
+ * @description: 初始化微秒定时器，在调度器启动后、第一次使用前调用
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_ERROR - 失败
+ */
+osal_status_t osal_utimer_init(void);
+
+/**
+ * @description: 获取微秒计数，32位回绕(约71分钟)，只用于计算时间间隔
+ * @return {uint32_t}
+ */
+uint32_t osal_utimer_now(void);
+
+/**
+ * @description: 微秒休眠，时长不小于OSAL_UTIMER_SPIN_US时线程挂起，由定时器比较中断唤醒；不可在中断中调用
+ * @param {uint32_t} us, 休眠时长
+ * @return {*}
+ */
+void osal_sleep_us(uint32_t us);
+
+/**
+ * @description: 获取信号量，微秒超时；不可在中断中调用
+ * @param {osal_sem_t*} sem, 信号量
+ * @param {uint32_t} timeout_us, 超时时间(us)，0表示不等待
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 超时, 其他 - 同osal_sem_wait
+ */
+osal_status_t osal_sem_wait_us(osal_sem_t *sem, uint32_t timeout_us);
+
+/**
+ * @description: 等待事件标志，微秒超时；不可在中断中调用
+ * @param {osal_event_t*} event, 事件
+ * @param {unsigned int} requested_flags, 等待的标志
+ * @param {unsigned int} options, 同osal_event_wait
+ * @param {uint32_t} timeout_us, 超时时间(us)，0表示不等待
+ * @param {unsigned int*} actual_flags, 输出实际获取到的标志
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 超时, 其他 - 同osal_event_wait
+ */
+osal_status_t osal_event_wait_us(osal_event_t *event, unsigned int requested_flags, unsigned int options,
+                                 uint32_t timeout_us, unsigned int *actual_flags);
+
+/**
+ * @description: 获取统计
+ * @param {osal_utimer_stats_t*} stats, 输出
+ * @return {*}
+ */
+void osal_utimer_stats_get(osal_utimer_stats_t *stats);
+
+/**
+ * @description: 清零统计
+ * @return {*}
+ */
+void osal_utimer_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_UTIMER_H__ */
@@ -0,0 +1,172 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-17 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-17 14:00:00
+ * @FilePath: /rm_base/OSAL/osal_waitany.c
+ * @Description: 多对象等待实现
+ */
+#include "osal_waitany.h"
+
+#if OSAL_WAIT_ANY_ENABLE
+
+/*
+ * 等待线程先登记自己关心的对象，再以OSAL_NO_WAIT依次尝试获取；都未就绪时阻塞在自己的唤醒信号量上。
+ * osal_sem_post/osal_queue_send/osal_queue_send_n/osal_event_set成功后查找关心该对象的等待者并释放其唤醒信号量。
+ * 先登记后轮询，轮询之后才就绪的对象一定能看到登记，不会丢失唤醒。
+ */
+typedef struct {
+    osal_wait_obj_t *objects;
+    unsigned int count;
+    uint8_t used;
+    uint8_t sem_created;
+    volatile uint8_t signaled;  /* 已释放唤醒信号量，避免重复释放 */
+    osal_sem_t wake;
+} waitany_waiter_t;
+
+static waitany_waiter_t waitany_waiters[OSAL_WAIT_ANY_MAX_WAITERS];
+volatile uint32_t osal_waitany_active = 0;
+
+static osal_status_t waitany_try(osal_wait_obj_t *o)
+{
+    switch (o->type) {
+    case OSAL_WAIT_SEM:
+        return osal_sem_wait((osal_sem_t *)o->obj, OSAL_NO_WAIT);
+    case OSAL_WAIT_QUEUE:
+        return osal_queue_recv((osal_queue_t *)o->obj, o->msg, OSAL_NO_WAIT);
+    case OSAL_WAIT_EVENT:
+        return osal_event_wait((osal_event_t *)o->obj, o->flags, o->options, OSAL_NO_WAIT, &o->actual_flags);
+    case OSAL_WAIT_QUEUE_COUNT:
+        return (osal_queue_count((osal_queue_t *)o->obj) >= o->flags) ? OSAL_SUCCESS : OSAL_TIMEOUT;
+    default:
+        return OSAL_INVALID_PARAM;
+    }
+}
+
+static waitany_waiter_t *waitany_alloc(osal_wait_obj_t *objects, unsigned int count)
+{
+    osal_critical_state_t crit;
+    waitany_waiter_t *w = NULL;
+
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WAIT_ANY_MAX_WAITERS; i++) {
+        if (!waitany_waiters[i].used) {
+            w = &waitany_waiters[i];
+            w->used = 1;
+            break;
+        }
+    }
+    osal_exit_critical(&crit);
+    if (w == NULL) {
+        return NULL;
+    }
+
+    if (!w->sem_created) {
+        if (osal_sem_create(&w->wake, "waitany", 0) != OSAL_SUCCESS) {
+            w->used = 0;
+            return NULL;
+        }
+        w->sem_created = 1;
+    }
+    /* 上一个使用者成功返回后可能还留有唤醒计数 */
+    while (osal_sem_wait(&w->wake, OSAL_NO_WAIT) == OSAL_SUCCESS) {
+    }
+
+    osal_enter_critical(&crit);
+    w->objects = objects;
+    w->count = count;
+    w->signaled = 0;
+    __atomic_add_fetch(&osal_waitany_active, 1, __ATOMIC_SEQ_CST);
+    osal_exit_critical(&crit);
+    return w;
+}
+
+static void waitany_free(waitany_waiter_t *w)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    w->objects = NULL;
+    w->count = 0;
+    w->used = 0;
+    __atomic_sub_fetch(&osal_waitany_active, 1, __ATOMIC_SEQ_CST);
+    osal_exit_critical(&crit);
+}
+
+void osal_waitany_notify_slow(const void *obj)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WAIT_ANY_MAX_WAITERS; i++) {
+        waitany_waiter_t *w = &waitany_waiters[i];
+        if (w->objects == NULL || w->signaled) {
+            continue;
+        }
+        for (unsigned int j = 0; j < w->count; j++) {
+            /* 按条数等待的队列凑够条数才唤醒，批量接收者不会每来一条消息被唤醒一次 */
+            if (w->objects[j].obj == obj &&
+                (w->objects[j].type != OSAL_WAIT_QUEUE_COUNT ||
+                 osal_queue_count((osal_queue_t *)obj) >= w->objects[j].flags)) {
+                w->signaled = 1;
+                osal_sem_post(&w->wake);
+                break;
+            }
+        }
+    }
+    osal_exit_critical(&crit);
+}
+
+osal_status_t osal_wait_any(osal_wait_obj_t *objects, unsigned int count, osal_tick_t timeout, unsigned int *index)
+{
+    waitany_waiter_t *w;
+    osal_status_t status = OSAL_TIMEOUT;
+    osal_tick_t start, elapsed, remaining;
+    uint8_t last_round = 0;
+
+    if (objects == NULL || count == 0 || index == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        if (objects[i].obj == NULL || objects[i].type > OSAL_WAIT_QUEUE_COUNT) {
+            return OSAL_INVALID_PARAM;
+        }
+    }
+
+    w = waitany_alloc(objects, count);
+    if (w == NULL) {
+        return OSAL_ERROR;
+    }
+
+    start = osal_tick_get();
+    for (;;) {
+        /* 先清除标志再轮询，轮询期间就绪的对象会重新释放唤醒信号量 */
+        __atomic_store_n(&w->signaled, 0, __ATOMIC_SEQ_CST);
+        for (unsigned int i = 0; i < count; i++) {
+            if (waitany_try(&objects[i]) == OSAL_SUCCESS) {
+                *index = i;
+                status = OSAL_SUCCESS;
+                goto out;
+            }
+        }
+        if (last_round || timeout == OSAL_NO_WAIT) {
+            break;
+        }
+
+        remaining = OSAL_WAIT_FOREVER;
+        if (timeout != OSAL_WAIT_FOREVER) {
+            elapsed = osal_tick_get() - start;
+            remaining = (elapsed < timeout) ? timeout - elapsed : OSAL_NO_WAIT;
+        }
+        /* 超时后再轮询一次，避免超时与就绪同时发生时丢掉已就绪的对象 */
+        if (remaining == OSAL_NO_WAIT || osal_sem_wait(&w->wake, remaining) != OSAL_SUCCESS) {
+            last_round = 1;
+        }
+    }
+
+out:
+    waitany_free(w);
+    return status;
+}
+
+#endif /* OSAL_WAIT_ANY_ENABLE */
@@ -0,0 +1,83 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-17 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-17 14:00:00
+ * @FilePath: /rm_base/OSAL/osal_waitany.h
+ * @Description: 多对象等待，一个线程同时等待多个信号量/队列/事件中任意一个就绪
+ */
+#ifndef __OSAL_WAITANY_H__
+#define __OSAL_WAITANY_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 多对象等待开关，关闭后osal_sem_post/osal_queue_send/osal_event_set不再产生通知开销 */
+#ifndef OSAL_WAIT_ANY_ENABLE
+#define OSAL_WAIT_ANY_ENABLE        1
+#endif
+
+/* 同时处于osal_wait_any中的线程数上限 */
+#ifndef OSAL_WAIT_ANY_MAX_WAITERS
+#define OSAL_WAIT_ANY_MAX_WAITERS   4
+#endif
+
+#if OSAL_WAIT_ANY_ENABLE
+
+typedef enum {
+    OSAL_WAIT_SEM = 0,          /* 获取信号量 */
+    OSAL_WAIT_QUEUE,            /* 从队列接收一条消息 */
+    OSAL_WAIT_EVENT,            /* 等待事件标志 */
+    OSAL_WAIT_QUEUE_COUNT,      /* 等待队列中至少有flags条消息，不接收 */
+} osal_wait_type_t;
+
+/* 等待对象描述，就绪时osal_wait_any按描述完成获取/接收 */
+typedef struct {
+    osal_wait_type_t type;
+    void *obj;                  /* osal_sem_t* / osal_queue_t* / osal_event_t* */
+    void *msg;                  /* QUEUE: 接收缓冲区 */
+    unsigned int flags;         /* EVENT: 等待的标志; QUEUE_COUNT: 消息条数 */
+    unsigned int options;       /* EVENT: OSAL_EVENT_WAIT_FLAG_* */
+    unsigned int actual_flags;  /* EVENT: 实际获取到的标志(输出) */
+} osal_wait_obj_t;
+
+#define OSAL_WAIT_OBJ_SEM(sem)                    { OSAL_WAIT_SEM, (sem), NULL, 0, 0, 0 }
+#define OSAL_WAIT_OBJ_QUEUE(queue, msg)           { OSAL_WAIT_QUEUE, (queue), (msg), 0, 0, 0 }
+#define OSAL_WAIT_OBJ_EVENT(event, flags, options) { OSAL_WAIT_EVENT, (event), NULL, (flags), (options), 0 }
+#define OSAL_WAIT_OBJ_QUEUE_COUNT(queue, count)   { OSAL_WAIT_QUEUE_COUNT, (queue), NULL, (count), 0, 0 }
+
+/**
+ * @description: 等待多个对象中任意一个就绪，并完成该对象的获取(信号量减一/接收消息/获取事件标志)
+ * @note: 多个对象同时就绪时按数组顺序优先，每次只获取一个对象；不可在中断中调用
+ * @param {osal_wait_obj_t*} objects, 等待对象数组
+ * @param {unsigned int} count, 对象数量
+ * @param {osal_tick_t} timeout, 超时时间
+ * @param {unsigned int*} index, 输出就绪对象在数组中的下标
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 超时, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 等待者已满
+ */
+osal_status_t osal_wait_any(osal_wait_obj_t *objects, unsigned int count, osal_tick_t timeout, unsigned int *index);
+
+/* 内部接口：对象可能就绪时由osal_sem_post/osal_queue_send/osal_queue_send_n/osal_event_set调用 */
+extern volatile uint32_t osal_waitany_active;
+void osal_waitany_notify_slow(const void *obj);
+
+static inline void osal_waitany_notify(const void *obj)
+{
+    /* 对象就绪的写入与读取等待者计数之间需要全屏障，与osal_wait_any登记后再轮询对应；没有等待者时只有一次读开销 */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&osal_waitany_active, __ATOMIC_RELAXED) != 0) {
+        osal_waitany_notify_slow(obj);
+    }
+}
+
+#endif /* OSAL_WAIT_ANY_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_WAITANY_H__ */
@@ -0,0 +1,317 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-21 15:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-21 15:00:00
+ * @FilePath: /rm_base/OSAL/osal_wevent.c
+ * @Description: 宽事件组实现
+ */
+#include "osal_wevent.h"
+
+/*
+ * 等待者在临界区中检查条件并登记，置位在同一临界区中更新标志并检查登记的等待者，不会丢失唤醒。
+ * 被唤醒的线程重新检查条件(可能已被其他带CLEAR的等待者取走)，不满足则继续等待。
+ * 唤醒信号量在等待槽第一次使用时创建，之后复用。
+ */
+typedef struct {
+    osal_wevent_t *ev;              /* 非NULL表示正在等待该事件组 */
+    osal_wevent_mask_t mask;
+    unsigned int options;
+    uint8_t used;
+    uint8_t sem_created;
+    volatile uint8_t signaled;      /* 已释放唤醒信号量，避免重复释放 */
+    osal_sem_t wake;
+} wevent_waiter_t;
+
+static wevent_waiter_t wevent_waiters[OSAL_WEVENT_MAX_WAITERS];
+
+/* 在临界区中调用 */
+static uint8_t wevent_satisfied(const osal_wevent_t *ev, const osal_wevent_mask_t *mask, unsigned int options)
+{
+    uint8_t any = 0;
+
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        uint32_t hit = ev->flags[i] & mask->w[i];
+        if (options & OSAL_EVENT_WAIT_FLAG_AND) {
+            if (hit != mask->w[i]) {
+                return 0;
+            }
+        } else if (hit != 0) {
+            any = 1;
+        }
+    }
+    return (options & OSAL_EVENT_WAIT_FLAG_AND) ? 1 : any;
+}
+
+/* 在临界区中调用 */
+static void wevent_consume(osal_wevent_t *ev, const osal_wevent_mask_t *mask, unsigned int options,
+                           osal_wevent_mask_t *actual)
+{
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        uint32_t hit = ev->flags[i] & mask->w[i];
+        if (actual != NULL) {
+            actual->w[i] = hit;
+        }
+        if (options & OSAL_EVENT_WAIT_FLAG_CLEAR) {
+            ev->flags[i] &= ~hit;
+        }
+    }
+}
+
+/* 在临界区中调用，changed为本次新置位的标志 */
+static void wevent_wake(osal_wevent_t *ev, const osal_wevent_mask_t *changed)
+{
+    for (unsigned int i = 0; i < OSAL_WEVENT_MAX_WAITERS; i++) {
+        wevent_waiter_t *w = &wevent_waiters[i];
+        uint8_t related = 0;
+
+        if (w->ev != ev || w->signaled) {
+            continue;
+        }
+        for (unsigned int j = 0; j < OSAL_WEVENT_WORDS; j++) {
+            if (w->mask.w[j] & changed->w[j]) {
+                related = 1;
+                break;
+            }
+        }
+        if (related && wevent_satisfied(ev, &w->mask, w->options)) {
+            w->signaled = 1;
+            ev->wakeups++;
+            osal_sem_post(&w->wake);
+        }
+    }
+}
+
+osal_status_t osal_wevent_create(osal_wevent_t *ev, const char *name)
+{
+    if (ev == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        ev->flags[i] = 0;
+        ev->allocated[i] = 0;
+    }
+    ev->name = name;
+    ev->wakeups = 0;
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_wevent_delete(osal_wevent_t *ev)
+{
+    osal_critical_state_t crit;
+
+    if (ev == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WEVENT_MAX_WAITERS; i++) {
+        if (wevent_waiters[i].ev == ev) {
+            osal_exit_critical(&crit);
+            return OSAL_ERROR;
+        }
+    }
+    ev->name = NULL;
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_wevent_flag_alloc(osal_wevent_t *ev, uint16_t *index)
+{
+    osal_critical_state_t crit;
+
+    if (ev == NULL || index == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        uint32_t free_bits = ~ev->allocated[i];
+        if (free_bits != 0) {
+            unsigned int bit = (unsigned int)__builtin_ctz(free_bits);
+            ev->allocated[i] |= 1UL << bit;
+            ev->flags[i] &= ~(1UL << bit);
+            osal_exit_critical(&crit);
+            *index = (uint16_t)(i * 32U + bit);
+            return OSAL_SUCCESS;
+        }
+    }
+    osal_exit_critical(&crit);
+    *index = OSAL_WEVENT_INVALID_FLAG;
+    return OSAL_ERROR;
+}
+
+osal_status_t osal_wevent_flag_free(osal_wevent_t *ev, uint16_t index)
+{
+    osal_critical_state_t crit;
+
+    if (ev == NULL || index >= OSAL_WEVENT_MAX_FLAGS) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_enter_critical(&crit);
+    ev->allocated[index >> 5] &= ~(1UL << (index & 31U));
+    ev->flags[index >> 5] &= ~(1UL << (index & 31U));
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_wevent_set(osal_wevent_t *ev, const osal_wevent_mask_t *mask)
+{
+    osal_critical_state_t crit;
+
+    if (ev == NULL || mask == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        ev->flags[i] |= mask->w[i];
+    }
+    wevent_wake(ev, mask);
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+osal_status_t osal_wevent_set_flag(osal_wevent_t *ev, uint16_t index)
+{
+    osal_wevent_mask_t mask;
+
+    if (index >= OSAL_WEVENT_MAX_FLAGS) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_wevent_mask_zero(&mask);
+    osal_wevent_mask_add(&mask, index);
+    return osal_wevent_set(ev, &mask);
+}
+
+osal_status_t osal_wevent_clear(osal_wevent_t *ev, const osal_wevent_mask_t *mask)
+{
+    osal_critical_state_t crit;
+
+    if (ev == NULL || mask == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        ev->flags[i] &= ~mask->w[i];
+    }
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+static wevent_waiter_t *wevent_waiter_alloc(void)
+{
+    osal_critical_state_t crit;
+    wevent_waiter_t *w = NULL;
+
+    osal_enter_critical(&crit);
+    for (unsigned int i = 0; i < OSAL_WEVENT_MAX_WAITERS; i++) {
+        if (!wevent_waiters[i].used) {
+            w = &wevent_waiters[i];
+            w->used = 1;
+            break;
+        }
+    }
+    osal_exit_critical(&crit);
+    if (w == NULL) {
+        return NULL;
+    }
+
+    if (!w->sem_created) {
+        if (osal_sem_create(&w->wake, "wevent", 0) != OSAL_SUCCESS) {
+            w->used = 0;
+            return NULL;
+        }
+        w->sem_created = 1;
+    }
+    /* 上一个使用者满足条件返回时可能还留有唤醒计数 */
+    while (osal_sem_wait(&w->wake, OSAL_NO_WAIT) == OSAL_SUCCESS) {
+    }
+    return w;
+}
+
+osal_status_t osal_wevent_wait(osal_wevent_t *ev, const osal_wevent_mask_t *mask, unsigned int options,
+                               osal_tick_t timeout, osal_wevent_mask_t *actual)
+{
+    osal_critical_state_t crit;
+    wevent_waiter_t *w;
+    osal_status_t status = OSAL_TIMEOUT;
+    osal_tick_t start, elapsed, remaining;
+    uint8_t empty = 1;
+
+    if (ev == NULL || mask == NULL || !(options & (OSAL_EVENT_WAIT_FLAG_AND | OSAL_EVENT_WAIT_FLAG_OR))) {
+        return OSAL_INVALID_PARAM;
+    }
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        if (mask->w[i] != 0) {
+            empty = 0;
+        }
+    }
+    if (empty) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    /* 已满足时不占用等待槽 */
+    osal_enter_critical(&crit);
+    if (wevent_satisfied(ev, mask, options)) {
+        wevent_consume(ev, mask, options, actual);
+        osal_exit_critical(&crit);
+        return OSAL_SUCCESS;
+    }
+    osal_exit_critical(&crit);
+    if (timeout == OSAL_NO_WAIT) {
+        return OSAL_TIMEOUT;
+    }
+
+    w = wevent_waiter_alloc();
+    if (w == NULL) {
+        return OSAL_ERROR;
+    }
+    w->mask = *mask;
+    w->options = options;
+
+    start = osal_tick_get();
+    for (;;) {
+        osal_enter_critical(&crit);
+        if (wevent_satisfied(ev, mask, options)) {
+            wevent_consume(ev, mask, options, actual);
+            status = OSAL_SUCCESS;
+            osal_exit_critical(&crit);
+            break;
+        }
+        w->signaled = 0;
+        w->ev = ev;
+        osal_exit_critical(&crit);
+
+        remaining = OSAL_WAIT_FOREVER;
+        if (timeout != OSAL_WAIT_FOREVER) {
+            elapsed = osal_tick_get() - start;
+            remaining = (elapsed < timeout) ? timeout - elapsed : OSAL_NO_WAIT;
+        }
+        if (remaining == OSAL_NO_WAIT || osal_sem_wait(&w->wake, remaining) != OSAL_SUCCESS) {
+            /* 超时后再检查一次，超时与置位同时发生时不丢掉已置位的标志 */
+            osal_enter_critical(&crit);
+            if (wevent_satisfied(ev, mask, options)) {
+                wevent_consume(ev, mask, options, actual);
+                status = OSAL_SUCCESS;
+            }
+            osal_exit_critical(&crit);
+            break;
+        }
+    }
+
+    osal_enter_critical(&crit);
+    w->ev = NULL;
+    w->used = 0;
+    osal_exit_critical(&crit);
+    return status;
+}
+
+osal_status_t osal_wevent_wait_flag(osal_wevent_t *ev, uint16_t index, osal_tick_t timeout)
+{
+    osal_wevent_mask_t mask;
+
+    if (index >= OSAL_WEVENT_MAX_FLAGS) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_wevent_mask_zero(&mask);
+    osal_wevent_mask_add(&mask, index);
+    return osal_wevent_wait(ev, &mask, OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR, timeout, NULL);
+}
@@ -0,0 +1,145 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-21 15:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-21 15:00:00
+ * @FilePath: /rm_base/OSAL/osal_wevent.h
+ * @Description: 宽事件组，OSAL_WEVENT_WORDS*32个标志，带标志分配器，只唤醒等待掩码与置位标志相关的线程
+ */
+#ifndef __OSAL_WEVENT_H__
+#define __OSAL_WEVENT_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 每个事件组的标志字数，标志数为32倍 */
+#ifndef OSAL_WEVENT_WORDS
+#define OSAL_WEVENT_WORDS           4
+#endif
+
+/* 所有事件组中同时阻塞等待的线程数上限 */
+#ifndef OSAL_WEVENT_MAX_WAITERS
+#define OSAL_WEVENT_MAX_WAITERS     12
+#endif
+
+#define OSAL_WEVENT_MAX_FLAGS       (OSAL_WEVENT_WORDS * 32U)
+#define OSAL_WEVENT_INVALID_FLAG    0xFFFFU
+
+/* 标志掩码 */
+typedef struct {
+    uint32_t w[OSAL_WEVENT_WORDS];
+} osal_wevent_mask_t;
+
+/*
+ * 标志存放在事件组中，等待线程在全局等待表中登记自己的掩码，阻塞在各自的唤醒信号量上。
+ * 置位时只唤醒掩码条件被满足的等待者，其他设备的线程不会被唤醒。
+ */
+typedef struct {
+    const char *name;
+    volatile uint32_t flags[OSAL_WEVENT_WORDS];
+    uint32_t allocated[OSAL_WEVENT_WORDS];  /* 标志分配位图 */
+    uint32_t wakeups;                       /* 唤醒等待者次数 */
+} osal_wevent_t;
+
+static inline void osal_wevent_mask_zero(osal_wevent_mask_t *mask)
+{
+    for (unsigned int i = 0; i < OSAL_WEVENT_WORDS; i++) {
+        mask->w[i] = 0;
+    }
+}
+
+static inline void osal_wevent_mask_add(osal_wevent_mask_t *mask, unsigned int index)
+{
+    mask->w[index >> 5] |= 1UL << (index & 31U);
+}
+
+static inline uint8_t osal_wevent_mask_test(const osal_wevent_mask_t *mask, unsigned int index)
+{
+    return (mask->w[index >> 5] >> (index & 31U)) & 1U;
+}
+
+/**
+ * @description: 创建宽事件组
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {const char*} name, 名称
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_wevent_create(osal_wevent_t *ev, const char *name);
+
+/**
+ * @description: 删除宽事件组
+ * @param {osal_wevent_t*} ev, 事件组
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 仍有线程在等待
+ */
+osal_status_t osal_wevent_delete(osal_wevent_t *ev);
+
+/**
+ * @description: 分配一个空闲标志，标志初始为清除状态
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {uint16_t*} index, 输出标志下标
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 标志已用完
+ */
+osal_status_t osal_wevent_flag_alloc(osal_wevent_t *ev, uint16_t *index);
+
+/**
+ * @description: 释放标志
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {uint16_t} index, 标志下标
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_wevent_flag_free(osal_wevent_t *ev, uint16_t index);
+
+/**
+ * @description: 设置掩码中的标志，唤醒条件被满足的等待者；可在中断中调用
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {const osal_wevent_mask_t*} mask, 要设置的标志
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_wevent_set(osal_wevent_t *ev, const osal_wevent_mask_t *mask);
+
+/**
+ * @description: 设置单个标志，可在中断中调用
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {uint16_t} index, 标志下标
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_wevent_set_flag(osal_wevent_t *ev, uint16_t index);
+
+/**
+ * @description: 清除掩码中的标志
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {const osal_wevent_mask_t*} mask, 要清除的标志
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_wevent_clear(osal_wevent_t *ev, const osal_wevent_mask_t *mask);
+
+/**
+ * @description: 等待标志，中断中只能使用OSAL_NO_WAIT
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {const osal_wevent_mask_t*} mask, 等待的标志，不能为空
+ * @param {unsigned int} options, OSAL_EVENT_WAIT_FLAG_AND/OR，可组合OSAL_EVENT_WAIT_FLAG_CLEAR
+ * @param {osal_tick_t} timeout, 超时时间
+ * @param {osal_wevent_mask_t*} actual, 输出满足条件时掩码中已置位的标志，可为NULL
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 超时, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 等待者已满
+ */
+osal_status_t osal_wevent_wait(osal_wevent_t *ev, const osal_wevent_mask_t *mask, unsigned int options,
+                               osal_tick_t timeout, osal_wevent_mask_t *actual);
+
+/**
+ * @description: 等待单个标志并清除
+ * @param {osal_wevent_t*} ev, 事件组
+ * @param {uint16_t} index, 标志下标
+ * @param {osal_tick_t} timeout, 超时时间
+ * @return {osal_status_t} 同osal_wevent_wait
+ */
+osal_status_t osal_wevent_wait_flag(osal_wevent_t *ev, uint16_t index, osal_tick_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_WEVENT_H__ */
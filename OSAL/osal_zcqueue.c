@@ -0,0 +1,123 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-14 16:05:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-14 16:05:00
+ * @FilePath: /rm_base/OSAL/osal_zcqueue.c
+ * @Description: 零拷贝消息队列实现，基于两个只传递指针的osal_queue
+ */
+#include "osal_zcqueue.h"
+
+/* 检查指针是否是本队列块池中某个块的起始地址 */
+static uint8_t zcqueue_block_valid(osal_zcqueue_t *zq, void *block)
+{
+    uintptr_t offset;
+
+    if (block == NULL || (uint8_t *)block < zq->pool) {
+        return 0;
+    }
+    offset = (uintptr_t)((uint8_t *)block - zq->pool);
+    return (offset < (uintptr_t)zq->block_size * zq->block_count && (offset % zq->block_size) == 0) ? 1 : 0;
+}
+
+osal_status_t osal_zcqueue_create(osal_zcqueue_t *zq, const char *name,
+                                  unsigned int block_size, unsigned int block_count,
+                                  void *storage)
+{
+    uint8_t *ptr;
+    void *block;
+
+    if (zq == NULL || storage == NULL || block_size == 0 || block_count == 0 ||
+        ((uintptr_t)storage % OSAL_ZCQUEUE_ALIGN) != 0) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    zq->block_size = OSAL_ZCQUEUE_BLOCK_SIZE(block_size);
+    zq->block_count = block_count;
+    zq->pool = (uint8_t *)storage;
+    zq->in_use = 0;
+    zq->peak = 0;
+    zq->alloc_fail = 0;
+    zq->name = name;
+
+    /* 块池之后依次是消息队列和空闲队列的缓冲区，队列中只存放指针 */
+    ptr = zq->pool + zq->block_size * block_count;
+    if (osal_queue_create(&zq->msg_queue, name, sizeof(void *), block_count, ptr) != OSAL_SUCCESS) {
+        return OSAL_ERROR;
+    }
+    ptr += block_count * sizeof(void *);
+    if (osal_queue_create(&zq->free_queue, name, sizeof(void *), block_count, ptr) != OSAL_SUCCESS) {
+        osal_queue_delete(&zq->msg_queue);
+        return OSAL_ERROR;
+    }
+
+    for (uint32_t i = 0; i < block_count; i++) {
+        block = zq->pool + i * zq->block_size;
+        osal_queue_send(&zq->free_queue, &block, OSAL_NO_WAIT);
+    }
+    return OSAL_SUCCESS;
+}
+
+void *osal_zcqueue_alloc(osal_zcqueue_t *zq, osal_tick_t timeout)
+{
+    void *block = NULL;
+    uint32_t used;
+
+    if (zq == NULL) {
+        return NULL;
+    }
+
+    if (osal_queue_recv(&zq->free_queue, &block, timeout) != OSAL_SUCCESS) {
+        __atomic_fetch_add(&zq->alloc_fail, 1U, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    used = __atomic_add_fetch(&zq->in_use, 1U, __ATOMIC_RELAXED);
+    if (used > zq->peak) {
+        zq->peak = used;  /* 统计用途，并发下偶尔少记一次可以接受 */
+    }
+    return block;
+}
+
+osal_status_t osal_zcqueue_send(osal_zcqueue_t *zq, void *block)
+{
+    if (zq == NULL || !zcqueue_block_valid(zq, block)) {
+        return OSAL_INVALID_PARAM;
+    }
+    /* 消息队列深度等于块数，已分配的块一定能放入，不需要等待 */
+    return osal_queue_send(&zq->msg_queue, &block, OSAL_NO_WAIT);
+}
+
+osal_status_t osal_zcqueue_recv(osal_zcqueue_t *zq, void **block, osal_tick_t timeout)
+{
+    if (zq == NULL || block == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    return osal_queue_recv(&zq->msg_queue, block, timeout);
+}
+
+osal_status_t osal_zcqueue_release(osal_zcqueue_t *zq, void *block)
+{
+    osal_status_t status;
+
+    if (zq == NULL || !zcqueue_block_valid(zq, block)) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    status = osal_queue_send(&zq->free_queue, &block, OSAL_NO_WAIT);
+    if (status == OSAL_SUCCESS) {
+        __atomic_fetch_sub(&zq->in_use, 1U, __ATOMIC_RELAXED);
+    }
+    return status;
+}
+
+osal_status_t osal_zcqueue_delete(osal_zcqueue_t *zq)
+{
+    if (zq == NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+    osal_queue_delete(&zq->msg_queue);
+    osal_queue_delete(&zq->free_queue);
+    zq->pool = NULL;
+    return OSAL_SUCCESS;
+}
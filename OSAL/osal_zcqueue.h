@@ -0,0 +1,100 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-14 16:05:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-14 16:05:00
+ * @FilePath: /rm_base/OSAL/osal_zcqueue.h
+ * @Description: 零拷贝消息队列，队列中只传递数据块指针，数据块来自固定大小的块池
+ */
+#ifndef __OSAL_ZCQUEUE_H__
+#define __OSAL_ZCQUEUE_H__
+
+#include "osal_def.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 数据块按8字节对齐，保证块内可以直接存放double/uint64_t */
+#define OSAL_ZCQUEUE_ALIGN                     (8U)
+#define OSAL_ZCQUEUE_BLOCK_SIZE(block_size)    (((block_size) + OSAL_ZCQUEUE_ALIGN - 1U) & ~(OSAL_ZCQUEUE_ALIGN - 1U))
+/* 创建时需要的存储区大小(字节)：块池 + 消息队列 + 空闲队列 */
+#define OSAL_ZCQUEUE_STORAGE_SIZE(block_size, block_count) \
+    (OSAL_ZCQUEUE_BLOCK_SIZE(block_size) * (block_count) + 2U * (block_count) * sizeof(void *))
+
+/*
+ * 使用流程：生产者alloc获取空闲块 -> 填充数据 -> send传递指针；
+ * 消费者recv获得指针 -> 处理数据 -> release归还空闲块。
+ * 数据块的所有权随指针转移，send之后生产者不能再访问该块。
+ */
+typedef struct {
+    osal_queue_t msg_queue;         /* 已发送的数据块指针 */
+    osal_queue_t free_queue;        /* 空闲数据块指针 */
+    uint8_t *pool;                  /* 块池起始地址 */
+    uint32_t block_size;            /* 对齐后的块大小 */
+    uint32_t block_count;           /* 块数量 */
+    volatile uint32_t in_use;       /* 当前被占用(已分配未归还)的块数 */
+    volatile uint32_t peak;         /* 历史最大占用块数 */
+    volatile uint32_t alloc_fail;   /* 块池耗尽导致分配失败的次数 */
+    const char *name;
+} osal_zcqueue_t;
+
+/**
+ * @description: 创建零拷贝队列
+ * @param {osal_zcqueue_t*} zq, 队列句柄指针
+ * @param {const char*} name, 队列名称
+ * @param {unsigned int} block_size, 数据块大小(字节)
+ * @param {unsigned int} block_count, 数据块数量，同时也是队列深度
+ * @param {void*} storage, 存储区，至少OSAL_ZCQUEUE_STORAGE_SIZE(block_size, block_count)字节，8字节对齐
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误, OSAL_ERROR - 失败
+ */
+osal_status_t osal_zcqueue_create(osal_zcqueue_t *zq, const char *name,
+                                  unsigned int block_size, unsigned int block_count,
+                                  void *storage);
+
+/**
+ * @description: 从块池分配一个数据块，中断中只能使用OSAL_NO_WAIT
+ * @param {osal_zcqueue_t*} zq, 队列句柄指针
+ * @param {osal_tick_t} timeout, 块池为空时的等待时间
+ * @return {void*} 数据块指针，失败返回NULL并累加alloc_fail
+ */
+void *osal_zcqueue_alloc(osal_zcqueue_t *zq, osal_tick_t timeout);
+
+/**
+ * @description: 发送数据块，只传递指针，所有权转移给接收方
+ * @param {osal_zcqueue_t*} zq, 队列句柄指针
+ * @param {void*} block, 由osal_zcqueue_alloc获得的数据块
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 不是本队列的数据块, OSAL_ERROR - 失败
+ */
+osal_status_t osal_zcqueue_send(osal_zcqueue_t *zq, void *block);
+
+/**
+ * @description: 接收数据块，使用完毕后需要调用osal_zcqueue_release归还
+ * @param {osal_zcqueue_t*} zq, 队列句柄指针
+ * @param {void**} block, 接收到的数据块指针
+ * @param {osal_tick_t} timeout, 超时时间
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_TIMEOUT - 超时, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_zcqueue_recv(osal_zcqueue_t *zq, void **block, osal_tick_t timeout);
+
+/**
+ * @description: 归还数据块到块池，也可用于丢弃已分配但未发送的块
+ * @param {osal_zcqueue_t*} zq, 队列句柄指针
+ * @param {void*} block, 数据块指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 不是本队列的数据块, OSAL_ERROR - 失败
+ */
+osal_status_t osal_zcqueue_release(osal_zcqueue_t *zq, void *block);
+
+/**
+ * @description: 删除零拷贝队列
+ * @param {osal_zcqueue_t*} zq, 队列句柄指针
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误
+ */
+osal_status_t osal_zcqueue_delete(osal_zcqueue_t *zq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_ZCQUEUE_H__ */
@@ -36,6 +36,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "bsp_ctrltick.h"
 
 /* USER CODE END Includes */
 
@@ -208,6 +209,7 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
+  BSP_CtrlTick_PeriodElapsed(htim);
 
   /* USER CODE END Callback 1 */
 }
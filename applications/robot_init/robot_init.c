@@ -8,8 +8,13 @@
  */
 #include "robot_init.h"
 #include "bsp_dwt.h"
+#include "bsp_ctrltick.h"
+#include "osal_coro.h"
+#include "osal_defer.h"
+#include "osal_utimer.h"
 #include "log.h"
 #include "offline.h"
+#include "message_center.h"
 #include "shell.h"
 #include "rgb.h"
 
@@ -17,12 +22,17 @@
 void bsp_init()
 {
   DWT_Init(168);
+  osal_defer_init();
+  osal_utimer_init();
+  osal_coro_init();
+  BSP_CtrlTick_Init();
   shell_init();
   LOG_INIT();
   RGB_init();
 }
 
 void modules_init(){
+  message_center_init();
   offline_init();
 }
 
@@ -0,0 +1,218 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-20 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-20 14:00:00
+ * @FilePath: /rm_base/cmake/host/heap_bench.c
+ * @Description: osal_malloc(TLSF)与ThreadX字节池(首次适配)在相同分配序列下的耗时对比，输出平均与最坏单次耗时
+ */
+#include "osal_heap.h"
+#include "tx_api.h"
+#include "tx_byte_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_SLOTS         64U
+#define BENCH_CHURN_OPS     200000U
+#define BENCH_KF_ROUNDS     2000U
+#define BENCH_FRAG_ROUNDS   20000U
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*release)(void *ptr);
+} bench_heap_t;
+
+typedef struct {
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t ops;
+    uint32_t fails;
+} bench_result_t;
+
+static TX_BYTE_POOL tx_pool;
+static uint8_t tx_pool_buf[OSAL_HEAP_SIZE] __attribute__((aligned(8)));
+
+/* 固件中字节池内部关中断，主机移植层的TX_DISABLE为空，这里用与osal_malloc相同的临界区补上加锁开销 */
+static void *tx_alloc(size_t size)
+{
+    osal_critical_state_t crit;
+    void *ptr = NULL;
+    UINT result;
+
+    osal_enter_critical(&crit);
+    result = tx_byte_allocate(&tx_pool, &ptr, (ULONG)size, TX_NO_WAIT);
+    osal_exit_critical(&crit);
+    return (result == TX_SUCCESS) ? ptr : NULL;
+}
+
+static void tx_release(void *ptr)
+{
+    osal_critical_state_t crit;
+
+    osal_enter_critical(&crit);
+    tx_byte_release(ptr);
+    osal_exit_critical(&crit);
+}
+
+static const bench_heap_t bench_heaps[] = {
+    {"osal_malloc(TLSF)", osal_malloc, osal_free},
+    {"tx_byte_allocate", tx_alloc, tx_release},
+};
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void *timed_alloc(const bench_heap_t *heap, size_t size, bench_result_t *res)
+{
+    uint64_t start = bench_now_ns();
+    void *ptr = heap->alloc(size);
+    uint64_t ns = bench_now_ns() - start;
+
+    res->total_ns += ns;
+    res->ops++;
+    if (ns > res->max_ns) {
+        res->max_ns = ns;
+    }
+    if (ptr == NULL) {
+        res->fails++;
+    }
+    return ptr;
+}
+
+static void timed_free(const bench_heap_t *heap, void *ptr, bench_result_t *res)
+{
+    uint64_t start = bench_now_ns();
+    heap->release(ptr);
+    uint64_t ns = bench_now_ns() - start;
+
+    res->total_ns += ns;
+    res->ops++;
+    if (ns > res->max_ns) {
+        res->max_ns = ns;
+    }
+}
+
+static uint32_t bench_rand_state;
+static uint32_t bench_rand(void)
+{
+    bench_rand_state = bench_rand_state * 1664525U + 1013904223U;
+    return bench_rand_state >> 8;
+}
+
+/* Kalman_Filter_Init(6, 0, 3)的分配序列(QuaternionEKF)，整体分配后整体释放 */
+static const uint16_t kf_sizes[] = {
+    3, 12, 12, 24, 3, 24, 12, 24, 24, 12, 144, 144, 144, 144, 72, 72, 144, 36, 72, 144, 144, 144, 24, 24,
+};
+#define KF_COUNT (sizeof(kf_sizes) / sizeof(kf_sizes[0]))
+
+static void bench_kalman(const bench_heap_t *heap, bench_result_t *alloc_res, bench_result_t *free_res)
+{
+    void *ptr[KF_COUNT];
+
+    for (uint32_t round = 0; round < BENCH_KF_ROUNDS; round++) {
+        for (uint32_t i = 0; i < KF_COUNT; i++) {
+            ptr[i] = timed_alloc(heap, kf_sizes[i], alloc_res);
+        }
+        for (uint32_t i = 0; i < KF_COUNT; i++) {
+            if (ptr[i] != NULL) {
+                timed_free(heap, ptr[i], free_res);
+            }
+        }
+    }
+}
+
+/* 随机大小、随机顺序的分配释放，两种堆使用相同的随机序列 */
+static void bench_churn(const bench_heap_t *heap, bench_result_t *alloc_res, bench_result_t *free_res)
+{
+    void *slot[BENCH_SLOTS] = {0};
+
+    bench_rand_state = 1;
+    for (uint32_t op = 0; op < BENCH_CHURN_OPS; op++) {
+        uint32_t i = bench_rand() % BENCH_SLOTS;
+        if (slot[i] != NULL) {
+            timed_free(heap, slot[i], free_res);
+            slot[i] = NULL;
+        } else {
+            slot[i] = timed_alloc(heap, 8U + bench_rand() % 249U, alloc_res);
+        }
+    }
+    for (uint32_t i = 0; i < BENCH_SLOTS; i++) {
+        if (slot[i] != NULL) {
+            heap->release(slot[i]);
+        }
+    }
+}
+
+/* 堆被小块填满后隔一个释放一个，只在末尾留出连续空间，再反复申请大块：首次适配需要扫过全部碎片 */
+static void bench_fragmented(const bench_heap_t *heap, bench_result_t *alloc_res, bench_result_t *free_res)
+{
+    static void *small[OSAL_HEAP_SIZE / 16];
+    uint32_t count = 0;
+
+    while (count < sizeof(small) / sizeof(small[0]) && (small[count] = heap->alloc(16)) != NULL) {
+        count++;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if ((i & 1U) == 0 || i + 32U >= count) {
+            heap->release(small[i]);
+            small[i] = NULL;
+        }
+    }
+    for (uint32_t round = 0; round < BENCH_FRAG_ROUNDS; round++) {
+        void *big = timed_alloc(heap, 256, alloc_res);
+        if (big != NULL) {
+            timed_free(heap, big, free_res);
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (small[i] != NULL) {
+            heap->release(small[i]);
+        }
+    }
+}
+
+static void bench_print(const char *name, const char *op, const bench_result_t *res)
+{
+    printf("  %-18s %-6s avg %6.1f ns  max %7llu ns  ops %-8u fails %u\n", name, op,
+           res->ops ? (double)res->total_ns / res->ops : 0.0,
+           (unsigned long long)res->max_ns, res->ops, res->fails);
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        void (*run)(const bench_heap_t *heap, bench_result_t *alloc_res, bench_result_t *free_res);
+    } scenarios[] = {
+        {"kalman init (6,0,3)", bench_kalman},
+        {"random churn 8..256B", bench_churn},
+        {"256B after fragmenting", bench_fragmented},
+    };
+
+    _tx_byte_pool_initialize();
+    tx_byte_pool_create(&tx_pool, "bench", tx_pool_buf, sizeof(tx_pool_buf));
+
+    printf("heap size %u bytes\n", (unsigned int)OSAL_HEAP_SIZE);
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        printf("%s\n", scenarios[s].name);
+        for (size_t h = 0; h < sizeof(bench_heaps) / sizeof(bench_heaps[0]); h++) {
+            bench_result_t alloc_res = {0}, free_res = {0};
+            scenarios[s].run(&bench_heaps[h], &alloc_res, &free_res);
+            bench_print(bench_heaps[h].name, "alloc", &alloc_res);
+            bench_print(bench_heaps[h].name, "free", &free_res);
+        }
+    }
+
+    osal_heap_stats_t stats;
+    osal_heap_stats_get(&stats);
+    printf("TLSF: alloc max %u cycles, free max %u cycles, %u free blocks after run\n",
+           (unsigned int)stats.alloc_cycles_max, (unsigned int)stats.free_cycles_max, (unsigned int)stats.free_blocks);
+    return 0;
+}
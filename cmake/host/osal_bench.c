@@ -0,0 +1,308 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-14 10:30:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-14 10:30:00
+ * @FilePath: /rm_base/cmake/host/osal_bench.c
+ * @Description: OSAL原语在主机(POSIX后端)上的性能测试，输出每次操作的平均耗时
+ */
+#include "osal_def.h"
+#include "osal_ringbuf.h"
+#include "osal_zcqueue.h"
+#include "osal_mempool.h"
+#include "osal_seqlock.h"
+#include "osal_waitany.h"
+#include "osal_hmutex.h"
+#include "osal_defer.h"
+#include "osal_coro.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+
+#define BENCH_LOOPS        (200000U)
+#define BENCH_PINGPONG     (20000U)
+
+typedef struct {
+    const char *name;
+    unsigned int loops;
+    void (*run)(unsigned int loops);
+} bench_case_t;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ---------------- 单线程无竞争路径 ---------------- */
+static osal_sem_t bench_sem;
+static void bench_sem_post_wait(unsigned int loops)
+{
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_sem_post(&bench_sem);
+        osal_sem_wait(&bench_sem, OSAL_NO_WAIT);
+    }
+}
+
+static osal_mutex_t bench_mutex;
+static void bench_mutex_lock_unlock(unsigned int loops)
+{
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_mutex_lock(&bench_mutex, OSAL_WAIT_FOREVER);
+        osal_mutex_unlock(&bench_mutex);
+    }
+}
+
+static osal_hmutex_t bench_hmutex;
+static void bench_hmutex_lock_unlock(unsigned int loops)
+{
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_hmutex_lock(&bench_hmutex, OSAL_WAIT_FOREVER);
+        osal_hmutex_unlock(&bench_hmutex);
+    }
+}
+
+static osal_event_t bench_event;
+static void bench_event_set_wait(unsigned int loops)
+{
+    unsigned int actual;
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_event_set(&bench_event, 0x01);
+        osal_event_wait(&bench_event, 0x01, OSAL_EVENT_WAIT_FLAG_OR | OSAL_EVENT_WAIT_FLAG_CLEAR,
+                        OSAL_NO_WAIT, &actual);
+    }
+}
+
+static osal_queue_t bench_queue;
+static uint32_t bench_queue_buf[16];
+static void bench_queue_send_recv(unsigned int loops)
+{
+    uint32_t msg = 0;
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_queue_send(&bench_queue, &msg, OSAL_NO_WAIT);
+        osal_queue_recv(&bench_queue, &msg, OSAL_NO_WAIT);
+    }
+}
+
+static osal_ringbuf_t bench_ringbuf;
+static uint32_t bench_ringbuf_buf[16];
+static void bench_ringbuf_push_pop(unsigned int loops)
+{
+    uint32_t msg = 0;
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_ringbuf_push(&bench_ringbuf, &msg);
+        osal_ringbuf_pop(&bench_ringbuf, &msg, OSAL_NO_WAIT);
+    }
+}
+
+/* 256字节消息：拷贝队列 vs 零拷贝队列 */
+#define BENCH_BLOCK_SIZE   (256U)
+static osal_queue_t bench_big_queue;
+static uint32_t bench_big_queue_buf[4 * BENCH_BLOCK_SIZE / sizeof(uint32_t)];
+static void bench_queue_send_recv_256(unsigned int loops)
+{
+    static uint32_t msg[BENCH_BLOCK_SIZE / sizeof(uint32_t)];
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_queue_send(&bench_big_queue, msg, OSAL_NO_WAIT);
+        osal_queue_recv(&bench_big_queue, msg, OSAL_NO_WAIT);
+    }
+}
+
+static osal_zcqueue_t bench_zcqueue;
+static uint64_t bench_zcqueue_storage[OSAL_ZCQUEUE_STORAGE_SIZE(BENCH_BLOCK_SIZE, 4) / sizeof(uint64_t) + 1];
+static void bench_zcqueue_256(unsigned int loops)
+{
+    void *block;
+    for (unsigned int i = 0; i < loops; i++) {
+        block = osal_zcqueue_alloc(&bench_zcqueue, OSAL_NO_WAIT);
+        osal_zcqueue_send(&bench_zcqueue, block);
+        osal_zcqueue_recv(&bench_zcqueue, &block, OSAL_NO_WAIT);
+        osal_zcqueue_release(&bench_zcqueue, block);
+    }
+}
+
+static osal_mempool_t bench_mempool;
+static uint64_t bench_mempool_storage[OSAL_MEMPOOL_STORAGE_SIZE(64, 8) / sizeof(uint64_t)];
+static void bench_mempool_alloc_free(unsigned int loops)
+{
+    for (unsigned int i = 0; i < loops; i++) {
+        void *block = osal_mempool_alloc(&bench_mempool, OSAL_NO_WAIT);
+        osal_mempool_free(&bench_mempool, block);
+    }
+}
+
+typedef struct {
+    float q[4];
+    float gyro[3];
+    float accel[3];
+    uint32_t timestamp;
+} bench_ins_t;
+OSAL_SEQLOCK_DEFINE(bench_ins_t, bench_seqlock);
+static void bench_seqlock_write_read(unsigned int loops)
+{
+    bench_ins_t ins = {0};
+    for (unsigned int i = 0; i < loops; i++) {
+        ins.timestamp = i;
+        OSAL_SEQLOCK_PUBLISH(bench_seqlock, &ins);
+        OSAL_SEQLOCK_SNAPSHOT(bench_seqlock, &ins);
+    }
+}
+
+/* 第三个对象就绪，包含登记、轮询前两个对象和注销的开销 */
+static osal_sem_t bench_waitany_sem[3];
+static void bench_wait_any(unsigned int loops)
+{
+    unsigned int index;
+    osal_wait_obj_t objects[3] = {
+        OSAL_WAIT_OBJ_SEM(&bench_waitany_sem[0]),
+        OSAL_WAIT_OBJ_SEM(&bench_waitany_sem[1]),
+        OSAL_WAIT_OBJ_SEM(&bench_waitany_sem[2]),
+    };
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_sem_post(&bench_waitany_sem[2]);
+        osal_wait_any(objects, 3, OSAL_WAIT_FOREVER, &index);
+    }
+}
+
+static void bench_critical(unsigned int loops)
+{
+    osal_critical_state_t crit;
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_enter_critical(&crit);
+        osal_exit_critical(&crit);
+    }
+}
+
+/* ---------------- 双线程乒乓(包含一次上下文切换往返) ---------------- */
+static osal_thread_t pong_thread;
+static osal_sem_t ping_sem;
+static osal_sem_t pong_sem;
+static volatile unsigned int pong_loops;
+
+static void pong_entry(unsigned long arg)
+{
+    (void)arg;
+    for (unsigned int i = 0; i < pong_loops; i++) {
+        osal_sem_wait(&ping_sem, OSAL_WAIT_FOREVER);
+        osal_sem_post(&pong_sem);
+    }
+}
+
+static void bench_sem_pingpong(unsigned int loops)
+{
+    pong_loops = loops;
+    osal_thread_start(&pong_thread);
+    for (unsigned int i = 0; i < loops; i++) {
+        osal_sem_post(&ping_sem);
+        osal_sem_wait(&pong_sem, OSAL_WAIT_FOREVER);
+    }
+}
+
+/* 入队并由工作线程执行完，队列满时让出CPU等工作线程取走 */
+static volatile unsigned int defer_done;
+static void defer_count(void *arg)
+{
+    (void)arg;
+    defer_done++;
+}
+
+static void bench_defer(unsigned int loops)
+{
+    defer_done = 0;
+    for (unsigned int i = 0; i < loops; i++) {
+        while (osal_defer(defer_count, NULL) != OSAL_SUCCESS) {
+            sched_yield();
+        }
+    }
+    while (defer_done != loops) {
+        sched_yield();
+    }
+}
+
+/* 协程每轮让出一次，对比线程间ping-pong的切换开销 */
+static osal_coro_t bench_coro;
+static volatile unsigned int coro_count;
+static unsigned int coro_target;
+
+static uint8_t bench_coro_fn(osal_coro_t *co)
+{
+    OSAL_CORO_BEGIN(co);
+    while (++coro_count < coro_target) {
+        OSAL_CORO_YIELD(co);
+    }
+    OSAL_CORO_END(co);
+}
+
+static void bench_coro_yield(unsigned int loops)
+{
+    coro_count = 0;
+    coro_target = loops;
+    osal_coro_start(&bench_coro, "bench", bench_coro_fn, NULL);
+    while (coro_count < loops) {
+        sched_yield();
+    }
+}
+
+static const bench_case_t bench_cases[] = {
+    {"sem post+wait",        BENCH_LOOPS,    bench_sem_post_wait},
+    {"mutex lock+unlock",    BENCH_LOOPS,    bench_mutex_lock_unlock},
+    {"hmutex lock+unlock",   BENCH_LOOPS,    bench_hmutex_lock_unlock},
+    {"event set+wait",       BENCH_LOOPS,    bench_event_set_wait},
+    {"queue send+recv",      BENCH_LOOPS,    bench_queue_send_recv},
+    {"ringbuf push+pop",     BENCH_LOOPS,    bench_ringbuf_push_pop},
+    {"queue 256B send+recv", BENCH_LOOPS,    bench_queue_send_recv_256},
+    {"zcqueue 256B round",   BENCH_LOOPS,    bench_zcqueue_256},
+    {"mempool alloc+free",   BENCH_LOOPS,    bench_mempool_alloc_free},
+    {"seqlock publish+read", BENCH_LOOPS,    bench_seqlock_write_read},
+    {"wait_any 3 sem",       BENCH_LOOPS,    bench_wait_any},
+    {"critical enter+exit",  BENCH_LOOPS,    bench_critical},
+    {"defer enqueue+run",    BENCH_PINGPONG, bench_defer},
+    {"coro yield",           BENCH_LOOPS,    bench_coro_yield},
+    {"sem ping-pong (2 thr)", BENCH_PINGPONG, bench_sem_pingpong},
+};
+
+static void bench_init(void)
+{
+    osal_sem_create(&bench_sem, "bench_sem", 0);
+    osal_mutex_create(&bench_mutex, "bench_mutex");
+    osal_hmutex_create(&bench_hmutex, "bench_hmutex");
+    osal_event_create(&bench_event, "bench_event");
+    osal_queue_create(&bench_queue, "bench_queue", sizeof(uint32_t),
+                      sizeof(bench_queue_buf) / sizeof(uint32_t), bench_queue_buf);
+    osal_ringbuf_create(&bench_ringbuf, "bench_ringbuf", sizeof(uint32_t),
+                        sizeof(bench_ringbuf_buf) / sizeof(uint32_t), bench_ringbuf_buf,
+                        OSAL_RINGBUF_FLAG_NONE);
+    osal_queue_create(&bench_big_queue, "bench_big_queue", BENCH_BLOCK_SIZE, 4, bench_big_queue_buf);
+    osal_zcqueue_create(&bench_zcqueue, "bench_zcqueue", BENCH_BLOCK_SIZE, 4, bench_zcqueue_storage);
+    osal_mempool_create(&bench_mempool, "bench_mempool", 64, 8, bench_mempool_storage);
+    OSAL_SEQLOCK_INIT(bench_seqlock);
+    for (unsigned int i = 0; i < 3; i++) {
+        osal_sem_create(&bench_waitany_sem[i], "bench_waitany", 0);
+    }
+    osal_defer_init();
+    osal_coro_init();
+    osal_sem_create(&ping_sem, "ping", 0);
+    osal_sem_create(&pong_sem, "pong", 0);
+    osal_thread_create(&pong_thread, "pong", pong_entry, NULL, NULL, 0, 1);
+}
+
+int main(void)
+{
+    bench_init();
+
+    printf("%-24s %10s %12s\n", "case", "loops", "ns/op");
+    printf("------------------------------------------------\n");
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        const bench_case_t *c = &bench_cases[i];
+        uint64_t start = bench_now_ns();
+        c->run(c->loops);
+        uint64_t elapsed = bench_now_ns() - start;
+        printf("%-24s %10u %12.1f\n", c->name, c->loops, (double)elapsed / c->loops);
+    }
+
+    osal_thread_delete(&pong_thread);
+    return 0;
+}
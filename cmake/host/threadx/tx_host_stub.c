@@ -0,0 +1,44 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-20 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-20 14:00:00
+ * @FilePath: /rm_base/cmake/host/threadx/tx_host_stub.c
+ * @Description: 主机上编译ThreadX字节池所需的内核符号，性能测试只用TX_NO_WAIT，不会走到线程挂起
+ */
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_byte_pool.h"
+#include <stdio.h>
+
+TX_THREAD *_tx_thread_current_ptr = TX_NULL;
+volatile UINT _tx_thread_preempt_disable = 0;
+volatile ULONG _tx_thread_system_state = 0;
+
+static VOID tx_host_unsupported(const char *what)
+{
+    fprintf(stderr, "ThreadX host shim: %s is not supported\n", what);
+    abort();
+}
+
+VOID _tx_thread_system_suspend(TX_THREAD *thread_ptr)
+{
+    (void)thread_ptr;
+    tx_host_unsupported("thread suspend");
+}
+
+VOID _tx_thread_system_resume(TX_THREAD *thread_ptr)
+{
+    (void)thread_ptr;
+    tx_host_unsupported("thread resume");
+}
+
+VOID _tx_thread_system_preempt_check(VOID)
+{
+}
+
+VOID _tx_byte_pool_cleanup(TX_THREAD *thread_ptr, ULONG suspension_sequence)
+{
+    (void)thread_ptr;
+    (void)suspension_sequence;
+}
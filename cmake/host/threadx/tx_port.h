@@ -0,0 +1,86 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-20 14:00:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-20 14:00:00
+ * @FilePath: /rm_base/cmake/host/threadx/tx_port.h
+ * @Description: 主机构建用的ThreadX最小移植层，只用于把ThreadX字节池源码编译进性能测试，与内存分配器对比
+ */
+#ifndef TX_PORT_H
+#define TX_PORT_H
+
+/* 性能测试单线程调用字节池，不需要关中断和线程挂起 */
+#define TX_DISABLE_ERROR_CHECKING
+#define TX_DISABLE_NOTIFY_CALLBACKS
+
+#include <stdlib.h>
+#include <string.h>
+
+#define VOID                                    void
+typedef char                                    CHAR;
+typedef unsigned char                           UCHAR;
+typedef int                                     INT;
+typedef unsigned int                            UINT;
+typedef long                                    LONG;
+typedef unsigned long                           ULONG;
+typedef unsigned long long                      ULONG64;
+typedef short                                   SHORT;
+typedef unsigned short                          USHORT;
+#define ULONG64_DEFINED
+
+#define TX_MAX_PRIORITIES                       32
+#define TX_MINIMUM_STACK                        200
+#define TX_TIMER_THREAD_STACK_SIZE              1024
+#define TX_TIMER_THREAD_PRIORITY                0
+#define TX_INT_DISABLE                          1
+#define TX_INT_ENABLE                           0
+#define TX_TRACE_TIME_SOURCE                    0
+#define TX_TRACE_TIME_MASK                      0xFFFFFFFFUL
+#define TX_PORT_SPECIFIC_BUILD_OPTIONS          (0)
+
+#define TX_THREAD_EXTENSION_0
+#define TX_THREAD_EXTENSION_1
+#define TX_THREAD_EXTENSION_2
+#define TX_THREAD_EXTENSION_3
+#define TX_BLOCK_POOL_EXTENSION
+#define TX_BYTE_POOL_EXTENSION
+#define TX_EVENT_FLAGS_GROUP_EXTENSION
+#define TX_MUTEX_EXTENSION
+#define TX_QUEUE_EXTENSION
+#define TX_SEMAPHORE_EXTENSION
+#define TX_TIMER_EXTENSION
+#define TX_THREAD_USER_EXTENSION
+#define TX_THREAD_CREATE_EXTENSION(thread_ptr)
+#define TX_THREAD_DELETE_EXTENSION(thread_ptr)
+#define TX_THREAD_COMPLETED_EXTENSION(thread_ptr)
+#define TX_THREAD_TERMINATED_EXTENSION(thread_ptr)
+#define TX_BLOCK_POOL_CREATE_EXTENSION(pool_ptr)
+#define TX_BYTE_POOL_CREATE_EXTENSION(pool_ptr)
+#define TX_EVENT_FLAGS_GROUP_CREATE_EXTENSION(group_ptr)
+#define TX_MUTEX_CREATE_EXTENSION(mutex_ptr)
+#define TX_QUEUE_CREATE_EXTENSION(queue_ptr)
+#define TX_SEMAPHORE_CREATE_EXTENSION(semaphore_ptr)
+#define TX_TIMER_CREATE_EXTENSION(timer_ptr)
+#define TX_BLOCK_POOL_DELETE_EXTENSION(pool_ptr)
+#define TX_BYTE_POOL_DELETE_EXTENSION(pool_ptr)
+#define TX_EVENT_FLAGS_GROUP_DELETE_EXTENSION(group_ptr)
+#define TX_MUTEX_DELETE_EXTENSION(mutex_ptr)
+#define TX_QUEUE_DELETE_EXTENSION(queue_ptr)
+#define TX_SEMAPHORE_DELETE_EXTENSION(semaphore_ptr)
+#define TX_TIMER_DELETE_EXTENSION(timer_ptr)
+
+#define TX_THREAD_GET_SYSTEM_STATE()            _tx_thread_system_state
+#define TX_THREAD_SYSTEM_RETURN_CHECK(c)        (c) = ((ULONG) _tx_thread_preempt_disable);
+#define TX_LOWEST_SET_BIT_CALCULATE(m, b)       (b) = (UINT) __builtin_ctz((m));
+
+#define TX_INTERRUPT_SAVE_AREA                  UINT interrupt_save = 0;
+#define TX_DISABLE                              (void)interrupt_save;
+#define TX_RESTORE                              (void)interrupt_save;
+
+#ifdef TX_THREAD_INIT
+CHAR _tx_version_id[] = "ThreadX host shim for byte pool benchmark";
+#else
+extern CHAR _tx_version_id[];
+#endif
+
+#endif /* TX_PORT_H */
@@ -51,6 +51,11 @@ osal_status_t beep_init(uint32_t frequency, uint32_t beep_time_period, osal_time
     // 保存回调函数
     beep_callback = callback;
 
+    // 不需要定时回调时(例如由协程控制节奏)不创建定时器
+    if (beep_callback == NULL) {
+        return OSAL_SUCCESS;
+    }
+
     status = osal_timer_create(&beep_timer, "beep_timer", beep_callback, 
                                NULL, beep_time_period, OSAL_TIMER_MODE_PERIODIC);
     status = osal_timer_start(&beep_timer);
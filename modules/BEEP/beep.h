@@ -19,7 +19,7 @@
  * @description: 蜂鸣器初始化
  * @param {uint32_t} frequency,频率
  * @param {uint32_t} beep_time_period，蜂鸣器时间周期
- * @param {osal_timer_callback_t} callback，定时器回调函数
+ * @param {osal_timer_callback_t} callback，定时器回调函数，传NULL时不创建定时器
  * @return {osal_status_t},OSAL_SCUCCESS成功,其余失败
  */
 osal_status_t beep_init(uint32_t frequency, uint32_t beep_time_period, osal_timer_callback_t callback);
@@ -0,0 +1,344 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-21 09:30:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-21 09:30:00
+ * @FilePath: /rm_base/modules/MESSAGE_CENTER/message_center.c
+ * @Description: 消息中心实现
+ */
+#include "message_center.h"
+#include "osal_def.h"
+#include "shell.h"
+#include <string.h>
+
+#define log_tag  "message"
+#include "log.h"
+
+// 话题的数据槽从静态存储池中顺序分配，话题不能注销
+static uint8_t message_pool[MESSAGE_POOL_SIZE] __attribute__((aligned(8)));
+static uint32_t message_pool_used;
+static message_topic_t message_topics[MESSAGE_MAX_TOPICS];
+static uint8_t message_topic_count;
+static message_subscriber_t *message_pending;   // 话题尚未注册的订阅者
+static void shell_message_cmd(int argc, char **argv);
+
+static message_topic_t *message_topic_find(const char *name)
+{
+    for (uint8_t i = 0; i < message_topic_count; i++) {
+        if (strcmp(message_topics[i].name, name) == 0) {
+            return &message_topics[i];
+        }
+    }
+    return NULL;
+}
+
+// 在临界区中调用
+static void message_link(message_topic_t *topic, message_subscriber_t *sub)
+{
+    sub->topic = topic;
+    sub->last_seq = topic->seq;
+    sub->next = topic->subs;
+    topic->subs = sub;
+    topic->sub_count++;
+}
+
+void message_center_init(void)
+{
+    shell_register_function("msg", shell_message_cmd, "Show message center topics and subscribers");
+}
+
+message_topic_t *message_topic_register(const char *name, uint16_t size, uint8_t depth)
+{
+    osal_critical_state_t crit;
+    message_topic_t *topic;
+
+    if (depth == 0) {
+        depth = MESSAGE_DEFAULT_DEPTH;
+    }
+    if (name == NULL || size == 0 || depth < 2 || (depth & (depth - 1)) != 0) {
+        return NULL;
+    }
+
+    uint32_t stride = (size + 7U) & ~7U;
+    uint32_t need = 2U * sizeof(uint32_t) * depth + stride * depth;
+    need = (need + 7U) & ~7U;
+
+    osal_enter_critical(&crit);
+    topic = message_topic_find(name);
+    if (topic != NULL) {
+        osal_exit_critical(&crit);
+        if (topic->size != size) {
+            LOG_ERROR("topic %s size mismatch: %u != %u", name, (unsigned)size, (unsigned)topic->size);
+            return NULL;
+        }
+        return topic;
+    }
+    if (message_topic_count >= MESSAGE_MAX_TOPICS || message_pool_used + need > sizeof(message_pool)) {
+        osal_exit_critical(&crit);
+        LOG_ERROR("no room for topic %s", name);
+        return NULL;
+    }
+
+    uint8_t *mem = &message_pool[message_pool_used];
+    message_pool_used += need;
+    topic = &message_topics[message_topic_count];
+    memset(topic, 0, sizeof(*topic));
+    topic->name = name;
+    topic->size = size;
+    topic->depth = depth;
+    topic->stride = (uint16_t)stride;
+    topic->data = mem;
+    topic->stamp = (volatile uint32_t *)(mem + stride * depth);
+    topic->time = (uint32_t *)(mem + stride * depth + sizeof(uint32_t) * depth);
+    topic->stat_start = osal_tick_get();
+
+    // 把提前订阅的订阅者接到话题上
+    message_subscriber_t **link = &message_pending;
+    while (*link != NULL) {
+        message_subscriber_t *sub = *link;
+        if (strcmp(sub->topic_name, name) == 0) {
+            *link = sub->next;
+            message_link(topic, sub);
+        } else {
+            link = &sub->next;
+        }
+    }
+    message_topic_count++;
+    osal_exit_critical(&crit);
+
+    LOG_INFO("topic register: %s, %u bytes x %u", name, (unsigned)size, (unsigned)depth);
+    return topic;
+}
+
+// 下一次发布的序号，回绕时跳过0(0表示尚未发布/槽正在写入)
+static inline uint32_t message_next_seq(const message_topic_t *topic)
+{
+    uint32_t seq = topic->seq + 1U;
+    return (seq == 0) ? 1U : seq;
+}
+
+void *message_publish_begin(message_topic_t *topic)
+{
+    uint32_t slot = message_next_seq(topic) & (topic->depth - 1U);
+
+    // 先作废槽戳再写数据，正在读这个槽的订阅者校验时会发现被覆盖
+    __atomic_store_n(&topic->stamp[slot], 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return topic->data + slot * topic->stride;
+}
+
+void message_publish_commit(message_topic_t *topic)
+{
+    uint32_t now = osal_cycle_get();
+    uint32_t seq = message_next_seq(topic);
+    uint32_t slot = seq & (topic->depth - 1U);
+
+    if (topic->seq != 0) {
+        uint32_t interval = now - topic->pub_last_cycles;
+        if (interval > topic->pub_interval_max) {
+            topic->pub_interval_max = interval;
+        }
+    }
+    topic->pub_last_cycles = now;
+    topic->pub_count++;
+
+    topic->time[slot] = now;
+    __atomic_store_n(&topic->stamp[slot], seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&topic->seq, seq, __ATOMIC_RELEASE);
+}
+
+void message_publish(message_topic_t *topic, const void *data)
+{
+    memcpy(message_publish_begin(topic), data, topic->size);
+    message_publish_commit(topic);
+}
+
+osal_status_t message_subscribe(message_subscriber_t *sub, const char *name, const char *topic_name)
+{
+    osal_critical_state_t crit;
+    message_topic_t *topic;
+
+    if (sub == NULL || topic_name == NULL || sub->topic_name != NULL) {
+        return OSAL_INVALID_PARAM;
+    }
+
+    memset(sub, 0, sizeof(*sub));
+    sub->name = name;
+    sub->topic_name = topic_name;
+
+    osal_enter_critical(&crit);
+    topic = message_topic_find(topic_name);
+    if (topic != NULL) {
+        message_link(topic, sub);
+    } else {
+        sub->next = message_pending;
+        message_pending = sub;
+    }
+    osal_exit_critical(&crit);
+    return OSAL_SUCCESS;
+}
+
+// 取出序号为seq的数据，槽已被覆盖或正在写入返回0
+static uint8_t message_fetch(const message_topic_t *topic, uint32_t seq, message_sample_t *sample)
+{
+    uint32_t slot = seq & (topic->depth - 1U);
+    const volatile uint32_t *stamp = &topic->stamp[slot];
+
+    if (__atomic_load_n(stamp, __ATOMIC_ACQUIRE) != seq) {
+        return 0;
+    }
+    sample->data = topic->data + slot * topic->stride;
+    sample->seq = seq;
+    sample->timestamp = topic->time[slot];
+    sample->stamp = stamp;
+    return message_sample_valid(sample);
+}
+
+static void message_account(message_subscriber_t *sub, const message_sample_t *sample)
+{
+    uint32_t latency = osal_cycle_get() - sample->timestamp;
+
+    sub->reads++;
+    sub->latency_total += latency;
+    if (latency > sub->latency_max) {
+        sub->latency_max = latency;
+    }
+}
+
+uint8_t message_get_latest(message_subscriber_t *sub, message_sample_t *sample)
+{
+    message_topic_t *topic = sub->topic;
+
+    if (topic == NULL) {
+        return 0;
+    }
+    // 发布者在两次读取之间绕过整个缓冲时重试
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&topic->seq, __ATOMIC_ACQUIRE);
+        if (seq == sub->last_seq) {
+            return 0;
+        }
+        if (message_fetch(topic, seq, sample)) {
+            sub->last_seq = seq;
+            message_account(sub, sample);
+            return 1;
+        }
+    }
+}
+
+uint32_t message_get_history(message_subscriber_t *sub, message_sample_t *samples, uint32_t max)
+{
+    message_topic_t *topic = sub->topic;
+    uint32_t count = 0;
+
+    if (topic == NULL || max == 0) {
+        return 0;
+    }
+
+    uint32_t seq = __atomic_load_n(&topic->seq, __ATOMIC_ACQUIRE);
+    uint32_t pending = seq - sub->last_seq;
+    uint32_t capacity = topic->depth - 1U;   // 下一次发布会作废一个槽
+    uint32_t first = sub->last_seq + 1U;
+
+    if (pending == 0) {
+        return 0;
+    }
+    if (pending > capacity) {
+        sub->lost += pending - capacity;
+        first = seq - capacity + 1U;
+    }
+    for (uint32_t s = first; s != seq + 1U && count < max; s++) {
+        sub->last_seq = s;
+        if (s == 0) {
+            continue;
+        }
+        if (message_fetch(topic, s, &samples[count])) {
+            message_account(sub, &samples[count]);
+            count++;
+        } else {
+            sub->lost++;
+        }
+    }
+    return count;
+}
+
+uint8_t message_copy_latest(message_subscriber_t *sub, void *out)
+{
+    message_topic_t *topic = sub->topic;
+    message_sample_t sample;
+
+    if (topic == NULL) {
+        return 0;
+    }
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&topic->seq, __ATOMIC_ACQUIRE);
+        if (seq == sub->last_seq) {
+            return 0;
+        }
+        if (!message_fetch(topic, seq, &sample)) {
+            continue;
+        }
+        memcpy(out, sample.data, topic->size);
+        if (message_sample_valid(&sample)) {
+            sub->last_seq = seq;
+            message_account(sub, &sample);
+            return 1;
+        }
+    }
+}
+
+static void shell_message_cmd(int argc, char **argv)
+{
+    uint32_t tpus = osal_cycle_per_us();
+    osal_tick_t now = osal_tick_get();
+
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        for (uint8_t i = 0; i < message_topic_count; i++) {
+            message_topic_t *topic = &message_topics[i];
+            topic->pub_count = 0;
+            topic->pub_interval_max = 0;
+            topic->stat_start = now;
+            for (message_subscriber_t *sub = topic->subs; sub != NULL; sub = sub->next) {
+                sub->reads = 0;
+                sub->lost = 0;
+                sub->latency_max = 0;
+                sub->latency_total = 0;
+            }
+        }
+        shell_printf("Message statistics cleared.\r\n\r\n");
+        return;
+    }
+    if (argc >= 2 && strcmp(argv[1], "list") != 0) {
+        shell_printf("Usage: msg [list|reset]\r\n\r\n");
+        return;
+    }
+
+    shell_printf("Topics (%u/%u, pool %lu/%lu bytes):\r\n", (unsigned)message_topic_count, (unsigned)MESSAGE_MAX_TOPICS,
+                 (unsigned long)message_pool_used, (unsigned long)sizeof(message_pool));
+    shell_printf("%-16s %-6s %-6s %-10s %-8s %-12s %-5s\r\n", "Name", "Size", "Depth", "Pubs", "Rate(Hz)", "IntMax(us)", "Subs");
+    shell_printf("--------------------------------------------------------------------\r\n");
+    for (uint8_t i = 0; i < message_topic_count; i++) {
+        const message_topic_t *topic = &message_topics[i];
+        osal_tick_t elapsed = now - topic->stat_start;
+        shell_printf("%-16s %-6u %-6u %-10lu %-8lu %-12lu %-5u\r\n", topic->name,
+                     (unsigned)topic->size, (unsigned)topic->depth, (unsigned long)topic->pub_count,
+                     elapsed ? (unsigned long)((uint64_t)topic->pub_count * OSAL_TICK_RATE_HZ / elapsed) : 0UL,
+                     (unsigned long)(topic->pub_interval_max / tpus), (unsigned)topic->sub_count);
+    }
+
+    shell_printf("\r\nSubscribers:\r\n");
+    shell_printf("%-16s %-16s %-10s %-8s %-10s %-10s\r\n", "Name", "Topic", "Reads", "Lost", "LatAvg(us)", "LatMax(us)");
+    shell_printf("--------------------------------------------------------------------------\r\n");
+    for (uint8_t i = 0; i < message_topic_count; i++) {
+        for (const message_subscriber_t *sub = message_topics[i].subs; sub != NULL; sub = sub->next) {
+            shell_printf("%-16s %-16s %-10lu %-8lu %-10lu %-10lu\r\n", sub->name ? sub->name : "N/A", sub->topic_name,
+                         (unsigned long)sub->reads, (unsigned long)sub->lost,
+                         sub->reads ? (unsigned long)(sub->latency_total / sub->reads / tpus) : 0UL,
+                         (unsigned long)(sub->latency_max / tpus));
+        }
+    }
+    for (const message_subscriber_t *sub = message_pending; sub != NULL; sub = sub->next) {
+        shell_printf("%-16s %-16s (topic not registered)\r\n", sub->name ? sub->name : "N/A", sub->topic_name);
+    }
+    shell_printf("\r\n");
+}
@@ -0,0 +1,146 @@
+/*
+ * @Author: laladuduqq 2807523947@qq.com
+ * @Date: 2025-09-21 09:30:00
+ * @LastEditors: laladuduqq 2807523947@qq.com
+ * @LastEditTime: 2025-09-21 09:30:00
+ * @FilePath: /rm_base/modules/MESSAGE_CENTER/message_center.h
+ * @Description: 消息中心，按名称注册话题的发布/订阅，多槽缓冲，订阅者零拷贝读取最新数据或有界历史
+ */
+#ifndef _MESSAGE_CENTER_H_
+#define _MESSAGE_CENTER_H_
+
+#include "modules_config.h"
+#include "osal_def.h"
+#include <stdint.h>
+
+/*
+ * 每个话题有depth个数据槽(2的幂)，发布者按顺序轮流写入，每个槽带一个序号戳。
+ * 写入前槽戳清零，写完后槽戳和话题序号更新为新序号，因此发布不加锁、不阻塞，耗时与订阅者数量无关，可在中断中发布。
+ * 订阅者直接拿到槽内数据的指针，不拷贝；发布者再写depth-1次之后该槽才会被覆盖，
+ * 使用完指针后可用message_sample_valid确认期间没有被覆盖。每个话题只允许一个发布者。
+ */
+
+// 话题
+typedef struct message_topic {
+    const char *name;
+    uint16_t size;                      // 负载大小(字节)
+    uint8_t depth;                      // 数据槽数量，2的幂
+    uint8_t sub_count;
+    volatile uint32_t seq;              // 最新数据的序号，0表示尚未发布
+    volatile uint32_t *stamp;           // 每个槽中数据的序号，0表示正在写入
+    uint32_t *time;                     // 每个槽的发布时刻(osal_cycle_get)
+    uint8_t *data;                      // depth * size字节，每槽按8字节对齐
+    uint16_t stride;                    // 每槽占用字节数
+    // 统计，只由发布者更新
+    uint32_t pub_count;
+    uint32_t pub_last_cycles;
+    uint32_t pub_interval_max;          // 最大发布间隔(周期数)
+    osal_tick_t stat_start;             // 统计起始tick，用于计算发布频率
+    struct message_subscriber *subs;
+} message_topic_t;
+
+// 订阅者，由使用者静态分配
+typedef struct message_subscriber {
+    const char *name;
+    const char *topic_name;
+    message_topic_t *topic;             // 话题注册前订阅时为NULL，读取时再查找
+    uint32_t last_seq;                  // 已读到的最新序号
+    // 统计，只由订阅者自己更新
+    uint32_t reads;                     // 读到的新数据条数
+    uint32_t lost;                      // 历史读取中被覆盖而丢失的条数
+    uint32_t latency_max;               // 发布到读取的最大延迟(周期数)
+    uint64_t latency_total;
+    struct message_subscriber *next;
+} message_subscriber_t;
+
+// 读取到的一条数据，data指向话题的数据槽
+typedef struct {
+    const void *data;
+    uint32_t seq;
+    uint32_t timestamp;                 // 发布时刻(osal_cycle_get)
+    const volatile uint32_t *stamp;
+} message_sample_t;
+
+/**
+ * @description: 初始化消息中心，注册shell命令
+ * @return {*}
+ */
+void message_center_init(void);
+
+/**
+ * @description: 注册话题，同名话题已存在且大小一致时返回已有话题；不可在中断中调用
+ * @param {const char*} name, 话题名称，需长期有效
+ * @param {uint16_t} size, 负载大小(字节)
+ * @param {uint8_t} depth, 数据槽数量，2的幂且不小于2，传0使用MESSAGE_DEFAULT_DEPTH
+ * @return {message_topic_t*} 成功返回话题，参数错误、大小不一致或存储不足返回NULL
+ */
+message_topic_t *message_topic_register(const char *name, uint16_t size, uint8_t depth);
+
+/**
+ * @description: 开始发布，返回下一个数据槽供直接写入，写完调用message_publish_commit；可在中断中调用
+ * @param {message_topic_t*} topic, 话题
+ * @return {void*} 数据槽指针，大小为话题的size
+ */
+void *message_publish_begin(message_topic_t *topic);
+
+/**
+ * @description: 完成发布，订阅者从此可以读到本次写入的数据
+ * @param {message_topic_t*} topic, 话题
+ * @return {*}
+ */
+void message_publish_commit(message_topic_t *topic);
+
+/**
+ * @description: 拷贝data到下一个数据槽并发布
+ * @param {message_topic_t*} topic, 话题
+ * @param {const void*} data, 数据，大小为话题的size
+ * @return {*}
+ */
+void message_publish(message_topic_t *topic, const void *data);
+
+/**
+ * @description: 订阅话题，话题可以稍后注册；不可在中断中调用
+ * @param {message_subscriber_t*} sub, 订阅者，需静态分配
+ * @param {const char*} name, 订阅者名称
+ * @param {const char*} topic_name, 话题名称
+ * @return {osal_status_t} OSAL_SUCCESS - 成功, OSAL_INVALID_PARAM - 参数错误或已订阅
+ */
+osal_status_t message_subscribe(message_subscriber_t *sub, const char *name, const char *topic_name);
+
+/**
+ * @description: 零拷贝获取最新数据，中间未读的数据被跳过
+ * @param {message_subscriber_t*} sub, 订阅者
+ * @param {message_sample_t*} sample, 输出最新数据
+ * @return {uint8_t} 1 - 有上次读取之后的新数据, 0 - 没有新数据(sample不变)
+ */
+uint8_t message_get_latest(message_subscriber_t *sub, message_sample_t *sample);
+
+/**
+ * @description: 零拷贝获取上次读取之后的数据，按发布顺序输出，最多depth-1条，更早的计入lost
+ * @param {message_subscriber_t*} sub, 订阅者
+ * @param {message_sample_t*} samples, 输出数组
+ * @param {uint32_t} max, 数组长度，未取完的数据留到下次读取
+ * @return {uint32_t} 输出的条数
+ */
+uint32_t message_get_history(message_subscriber_t *sub, message_sample_t *samples, uint32_t max);
+
+/**
+ * @description: 拷贝最新数据，拷贝期间被覆盖时重新读取
+ * @param {message_subscriber_t*} sub, 订阅者
+ * @param {void*} out, 输出缓冲，大小为话题的size
+ * @return {uint8_t} 1 - 拷贝了新数据, 0 - 没有新数据
+ */
+uint8_t message_copy_latest(message_subscriber_t *sub, void *out);
+
+/**
+ * @description: 判断取到的数据是否仍未被覆盖，在使用数据指针之后调用
+ * @param {const message_sample_t*} sample, 数据
+ * @return {uint8_t} 1 - 数据完整, 0 - 期间已被发布者覆盖
+ */
+static inline uint8_t message_sample_valid(const message_sample_t *sample)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(sample->stamp, __ATOMIC_RELAXED) == sample->seq;
+}
+
+#endif // _MESSAGE_CENTER_H_
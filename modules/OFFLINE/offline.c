@@ -11,6 +11,7 @@
 #include "bsp_dwt.h"
 #include "iwdg.h"
 #include "modules_config.h"
+#include "osal_coro.h"
 #include "osal_def.h"
 #include "rgb.h"
 #include <stdint.h>
@@ -23,75 +24,106 @@
 
 // 静态变量
 static OfflineManager_t offline_manager;
-static osal_thread_t offline_thread;
+static osal_coro_t offline_scan_coro;
+static osal_coro_t offline_alarm_coro;
 static uint8_t current_beep_times;
-OFFLINE_THREAD_STACK_SECTION static uint8_t offline_thread_stack[OFFLINE_THREAD_STACK_SIZE];
-static void beep_ctrl_times(ULONG timer);
 static void shell_offline_cmd(int argc, char **argv);
 
-void offline_task(ULONG thread_input)
-{    
-    (void)(thread_input);
-    #if OFFLINE_WATCHDOG_ENABLE
-        __HAL_DBGMCU_FREEZE_IWDG();
-        MX_IWDG_Init();
-    #endif
-    for (;;)
-    {
-        static uint8_t highest_error_level = 0;
-        static uint8_t alarm_device_index = OFFLINE_INVALID_INDEX;
-        uint32_t current_time = tx_time_get();
-        
-        // 重置错误状态
-        highest_error_level = 0;
-        alarm_device_index = OFFLINE_INVALID_INDEX;
-        bool any_device_offline = false;
+// 检查一遍所有设备的离线状态，选出需要报警的设备
+static void offline_scan(void)
+{
+    static uint8_t highest_error_level = 0;
+    static uint8_t alarm_device_index = OFFLINE_INVALID_INDEX;
+    uint32_t current_time = osal_tick_get();
     
-        // 检查所有设备状态
-        for (uint8_t i = 0; i < offline_manager.device_count; i++) {
-            OfflineDevice_t* device = &offline_manager.devices[i];
+    // 重置错误状态
+    highest_error_level = 0;
+    alarm_device_index = OFFLINE_INVALID_INDEX;
+    bool any_device_offline = false;
+
+    // 检查所有设备状态
+    for (uint8_t i = 0; i < offline_manager.device_count; i++) {
+        OfflineDevice_t* device = &offline_manager.devices[i];
+        
+        if (!device->enable) {continue;}
+
+        if (current_time - device->last_time > device->timeout_ms) {
+            device->is_offline = STATE_OFFLINE;
+            any_device_offline = true;
             
-            if (!device->enable) {continue;}
-    
-            if (current_time - device->last_time > device->timeout_ms) {
-                device->is_offline = STATE_OFFLINE;
-                any_device_offline = true;
-                
-                // 更新最高优先级设备
-                if (device->level > highest_error_level) {
-                    highest_error_level = device->level;
+            // 更新最高优先级设备
+            if (device->level > highest_error_level) {
+                highest_error_level = device->level;
+                alarm_device_index = i;
+                current_beep_times = device->beep_times;
+            }
+            // 相同优先级时的处理
+            else if (device->level == highest_error_level) {
+                // 如果当前设备不需要蜂鸣（beep_times=0），保持原来的设备
+                if (device->beep_times == 0) {continue;}
+                // 如果之前选中的设备不需要蜂鸣，或者当前设备蜂鸣次数更少
+                if (current_beep_times == 0 || (device->beep_times > 0 && device->beep_times < current_beep_times)) {
                     alarm_device_index = i;
                     current_beep_times = device->beep_times;
                 }
-                // 相同优先级时的处理
-                else if (device->level == highest_error_level) {
-                    // 如果当前设备不需要蜂鸣（beep_times=0），保持原来的设备
-                    if (device->beep_times == 0) {continue;}
-                    // 如果之前选中的设备不需要蜂鸣，或者当前设备蜂鸣次数更少
-                    if (current_beep_times == 0 || (device->beep_times > 0 && device->beep_times < current_beep_times)) {
-                        alarm_device_index = i;
-                        current_beep_times = device->beep_times;
-                    }
-                }
-            } else {
-                device->is_offline = STATE_ONLINE;
             }
-        }
-    
-        // 触发报警或清除报警
-        if (alarm_device_index != OFFLINE_INVALID_INDEX && any_device_offline) {
-            // 已在上面设置了current_beep_times
         } else {
-            // 所有设备都在线，清除报警
-            current_beep_times = 0;
-            RGB_show(LED_Green);              // 表示所有设备都在线
+            device->is_offline = STATE_ONLINE;
         }
+    }
+
+    // 触发报警或清除报警
+    if (alarm_device_index != OFFLINE_INVALID_INDEX && any_device_offline) {
+        // 已在上面设置了current_beep_times
+    } else {
+        // 所有设备都在线，清除报警
+        current_beep_times = 0;
+        RGB_show(LED_Green);              // 表示所有设备都在线
+    }
+}
+
+// 离线检测协程，每OFFLINE_TASK_PERIOD_MS执行一次，释放时刻不随执行时间漂移
+static uint8_t offline_scan_task(osal_coro_t *co)
+{
+    OSAL_CORO_BEGIN(co);
+    #if OFFLINE_WATCHDOG_ENABLE
+    __HAL_DBGMCU_FREEZE_IWDG();
+    MX_IWDG_Init();
+    #endif
+    for (;;) {
+        offline_scan();
         #if OFFLINE_WATCHDOG_ENABLE
-            HAL_IWDG_Refresh(&hiwdg);
+        HAL_IWDG_Refresh(&hiwdg);
         #endif
+        OSAL_CORO_PERIOD_MS(co, OFFLINE_TASK_PERIOD_MS);
+    }
+    OSAL_CORO_END(co);
+}
+
+// 报警协程，每OFFLINE_BEEP_PERIOD内按报警设备的beep_times蜂鸣并闪红灯
+static uint8_t offline_alarm_task(osal_coro_t *co)
+{
+    static osal_tick_t period_start;
+    static uint8_t remaining_beep_cycles;
 
-        tx_thread_sleep(10);
+    OSAL_CORO_BEGIN(co);
+    for (;;) {
+        period_start = osal_tick_get();
+        for (remaining_beep_cycles = current_beep_times; remaining_beep_cycles != 0; remaining_beep_cycles--) {
+            #if OFFLINE_BEEP_ENABLE == 1
+            beep_set_tune(OFFLINE_BEEP_TUNE_VALUE, OFFLINE_BEEP_CTRL_VALUE);
+            #else
+            beep_set_tune(0, 0);
+            #endif
+            RGB_show(LED_Red);
+            OSAL_CORO_DELAY_MS(co, OFFLINE_BEEP_ON_TIME);
+            beep_set_tune(0, 0);
+            RGB_show(LED_Black);
+            OSAL_CORO_DELAY_MS(co, OFFLINE_BEEP_OFF_TIME);
+        }
+        OSAL_CORO_DELAY_UNTIL(co, period_start + OSAL_CORO_MS_TO_TICKS(OFFLINE_BEEP_PERIOD));
     }
+    OSAL_CORO_END(co);
 }
 
 
@@ -99,16 +131,15 @@ void offline_init(void)
 {
     // 初始化管理器
     memset(&offline_manager, 0, sizeof(offline_manager)); 
-    osal_status_t status = osal_thread_create(&offline_thread, "offlineTask", offline_task, 
-    0,offline_thread_stack, OFFLINE_THREAD_STACK_SIZE,OFFLINE_THREAD_PRIORITY);
+    osal_status_t status = osal_coro_start(&offline_scan_coro, "offline", offline_scan_task, NULL);
 
-    if(status != TX_SUCCESS) {
+    if(status != OSAL_SUCCESS) {
         LOG_ERROR("Failed to create offline task!");
         return;
     }
-    status = osal_thread_start(&offline_thread);
 
-    beep_init(2000, 10, beep_ctrl_times);
+    beep_init(2000, 0, NULL);
+    osal_coro_start(&offline_alarm_coro, "offline_alarm", offline_alarm_task, NULL);
     
     shell_register_function("offline", shell_offline_cmd, "Show offline device information");
 
@@ -130,7 +161,7 @@ uint8_t offline_device_register(const OfflineDeviceInit_t* init)
     device->level = init->level;
     device->beep_times = init->beep_times;
     device->is_offline = STATE_OFFLINE;
-    device->last_time = tx_time_get();
+    device->last_time = osal_tick_get();
     device->index = index;
     device->enable = init->enable;
     
@@ -144,7 +175,7 @@ uint8_t offline_device_register(const OfflineDeviceInit_t* init)
 void offline_device_update(uint8_t device_index)
 {
         if (device_index < offline_manager.device_count) {
-            offline_manager.devices[device_index].last_time = tx_time_get();
+            offline_manager.devices[device_index].last_time = osal_tick_get();
             offline_manager.devices[device_index].dt = DWT_GetDeltaT(&offline_manager.devices[device_index].dt_cnt);
         }
 }
@@ -179,42 +210,6 @@ uint8_t get_system_status(void){
     return status;
 }
 
-void beep_ctrl_times(ULONG timer)
-{
-    static uint32_t beep_period_start_time;
-    static uint32_t beep_cycle_start_time;
-    static uint8_t remaining_beep_cycles;
-
-    if (DWT_GetTimeline_ms() - beep_period_start_time > OFFLINE_BEEP_PERIOD)
-    {
-        remaining_beep_cycles = current_beep_times;
-        beep_period_start_time = DWT_GetTimeline_ms();
-        beep_cycle_start_time = DWT_GetTimeline_ms();
-    }
-    else if (remaining_beep_cycles != 0)
-    {
-        if (DWT_GetTimeline_ms() - beep_cycle_start_time < OFFLINE_BEEP_ON_TIME)
-        {
-            #if OFFLINE_BEEP_ENABLE == 1
-            beep_set_tune(OFFLINE_BEEP_TUNE_VALUE, OFFLINE_BEEP_CTRL_VALUE);
-            #else
-            beep_set_tune(0, 0);
-            #endif
-            RGB_show(LED_Red);
-        }
-        else if (DWT_GetTimeline_ms() - beep_cycle_start_time < OFFLINE_BEEP_ON_TIME + OFFLINE_BEEP_OFF_TIME)
-        {
-            beep_set_tune(0, 0);
-            RGB_show(LED_Black);
-        }
-        else
-        {
-            remaining_beep_cycles--;
-            beep_cycle_start_time = DWT_GetTimeline_ms();
-        }
-    }
-}
-
 // shell命令处理函数
 
 // 添加获取设备信息的函数，供shell命令使用
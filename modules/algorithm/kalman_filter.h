@@ -26,22 +26,10 @@
 
 #include "arm_math.h"
 #include "stdint.h"
-#include "tx_api.h"
-
-//内存分配
-extern TX_BYTE_POOL tx_app_byte_pool;
-// 内存分配函数
-void* threadx_malloc(size_t size) {
-    void *ptr = NULL;
-    if (tx_byte_allocate(&tx_app_byte_pool, &ptr, size, TX_WAIT_FOREVER) == TX_SUCCESS) {
-        tx_thread_sleep(100);
-        return ptr;
-    } else {
-        return NULL;
-    }
-}
-
-#define user_malloc threadx_malloc
+#include "osal_heap.h"
+
+// 内存分配，TLSF堆分配耗时有界，初始化阶段不再需要等待
+#define user_malloc osal_malloc
 #define mat arm_matrix_instance_f32
 #define Matrix_Init arm_mat_init_f32
 #define Matrix_Add arm_mat_add_f32
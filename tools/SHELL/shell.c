@@ -346,17 +346,17 @@ void shell_printf(const char *fmt, ...) {
     if (SHELL_RTT)
     {
         if (len > 0) {
-            tx_mutex_get(&g_shell_ctx.mutex, TX_WAIT_FOREVER);
+            osal_mutex_lock(&g_shell_ctx.mutex, OSAL_WAIT_FOREVER);
             RTT_WriteDataSkip(0, (uint8_t*)buffer, (uint16_t)len);
-            tx_mutex_put(&g_shell_ctx.mutex);
+            osal_mutex_unlock(&g_shell_ctx.mutex);
         }
     }
     else
     {
         if (len > 0 && g_shell_ctx.uart_dev) {
-            tx_mutex_get(&g_shell_ctx.mutex, TX_WAIT_FOREVER);
+            osal_mutex_lock(&g_shell_ctx.mutex, OSAL_WAIT_FOREVER);
             BSP_UART_Send(g_shell_ctx.uart_dev, (uint8_t*)buffer, (uint16_t)len);
-            tx_mutex_put(&g_shell_ctx.mutex);
+            osal_mutex_unlock(&g_shell_ctx.mutex);
         }
     }
 }
@@ -369,17 +369,17 @@ void shell_send(const uint8_t *data, uint16_t len) {
     if (SHELL_RTT)
     {
         if (len > 0) {
-            tx_mutex_get(&g_shell_ctx.mutex, TX_WAIT_FOREVER);
+            osal_mutex_lock(&g_shell_ctx.mutex, OSAL_WAIT_FOREVER);
             RTT_WriteDataSkip(0, (uint8_t*)data, (uint16_t)len);
-            tx_mutex_put(&g_shell_ctx.mutex);
+            osal_mutex_unlock(&g_shell_ctx.mutex);
         }
     }
     else
     {
         if (len > 0 && g_shell_ctx.uart_dev) {
-            tx_mutex_get(&g_shell_ctx.mutex, TX_WAIT_FOREVER);
+            osal_mutex_lock(&g_shell_ctx.mutex, OSAL_WAIT_FOREVER);
             BSP_UART_Send(g_shell_ctx.uart_dev, (uint8_t*)data, (uint16_t)len);
-            tx_mutex_put(&g_shell_ctx.mutex);
+            osal_mutex_unlock(&g_shell_ctx.mutex);
         }
     }
 }
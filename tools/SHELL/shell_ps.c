@@ -7,6 +7,13 @@
  * @Description: 
  */
 #include "shell.h"
+#include "osal_lockstat.h"
+#include "osal_periodic.h"
+#include "osal_hmutex.h"
+#include "osal_defer.h"
+#include "osal_coro.h"
+#include "osal_heap.h"
+#include "osal_utimer.h"
 
 #if OSAL_RTOS_TYPE == OSAL_THREADX
 #include "tx_block_pool.h"
@@ -23,7 +30,7 @@ void shell_ps_cmd(int argc, char **argv) {
     if (argc < 2) {
         // 显示基本帮助信息
         shell_printf("Usage: ps <object_type>\r\n");
-        shell_printf("Object types: thread, timer, mutex, sem, event, queue, bytepool, blockpool\r\n");
+        shell_printf("Object types: thread, timer, mutex, sem, event, queue, bytepool, blockpool, lock, periodic, critical, defer, coro, heap, utimer\r\n");
         shell_printf("\r\n");
         return;
     }
@@ -154,6 +161,37 @@ void shell_ps_cmd(int argc, char **argv) {
         return;
     }
     else if (strcmp(argv[1], "mutex") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "bench") == 0) {
+            // 无竞争加解锁耗时对比：内核互斥量 vs 混合互斥量，单位CPU周期
+            static osal_mutex_t bench_mutex;
+            static osal_hmutex_t bench_hmutex;
+            static uint8_t bench_created = 0;
+            const uint32_t loops = 1000;
+            uint32_t start, mutex_cycles, hmutex_cycles;
+
+            if (!bench_created) {
+                osal_mutex_create(&bench_mutex, "bench_mutex");
+                osal_hmutex_create(&bench_hmutex, "bench_hmutex");
+                bench_created = 1;
+            }
+            start = osal_cycle_get();
+            for (uint32_t i = 0; i < loops; i++) {
+                osal_mutex_lock(&bench_mutex, OSAL_WAIT_FOREVER);
+                osal_mutex_unlock(&bench_mutex);
+            }
+            mutex_cycles = osal_cycle_get() - start;
+            start = osal_cycle_get();
+            for (uint32_t i = 0; i < loops; i++) {
+                osal_hmutex_lock(&bench_hmutex, OSAL_WAIT_FOREVER);
+                osal_hmutex_unlock(&bench_hmutex);
+            }
+            hmutex_cycles = osal_cycle_get() - start;
+            shell_printf("Uncontended lock+unlock (%lu loops, cycles/op):\r\n", (unsigned long)loops);
+            shell_printf("  osal_mutex  : %lu\r\n", (unsigned long)(mutex_cycles / loops));
+            shell_printf("  osal_hmutex : %lu\r\n", (unsigned long)(hmutex_cycles / loops));
+            shell_printf("\r\n");
+            return;
+        }
         // 显示互斥量信息
         shell_printf("Mutex Information:\r\n");
         shell_printf("%-16s %-8s %-16s\r\n", "Name", "Count", "Owner");
@@ -373,9 +411,221 @@ void shell_ps_cmd(int argc, char **argv) {
         shell_printf("\r\n");
         return;
     }
+    else if (strcmp(argv[1], "lock") == 0) {
+#if OSAL_LOCK_STATS_ENABLE
+        static const char *const type_str[] = {"MUTEX", "SEM", "EVENT", "QUEUE"};
+        uint32_t tpus = osal_cycle_per_us();
+
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            osal_lockstat_reset();
+            shell_printf("Lock statistics cleared.\r\n\r\n");
+            return;
+        }
+
+        // 显示同步原语竞争统计，时间单位为us
+        shell_printf("Lock Contention Information (time in us):\r\n");
+        shell_printf("%-20s %-6s %-10s %-8s %-6s %-9s %-9s %-9s %-9s\r\n",
+                     "Name", "Type", "Acquire", "Contend", "Fail",
+                     "WaitAvg", "WaitMax", "HoldAvg", "HoldMax");
+        shell_printf("------------------------------------------------------------------------------------------\r\n");
+
+        for (unsigned int i = 0; i < OSAL_LOCKSTAT_MAX; i++) {
+            const osal_lockstat_t *st = osal_lockstat_get(i);
+            if (st == NULL) {
+                continue;
+            }
+            unsigned long wait_avg = st->contended ? (unsigned long)(st->wait_total / st->contended / tpus) : 0;
+            unsigned long hold_avg = st->acquire ? (unsigned long)(st->hold_total / st->acquire / tpus) : 0;
+            shell_printf("%-20s %-6s %-10lu %-8lu %-6lu %-9lu %-9lu %-9lu %-9lu\r\n",
+                         st->name ? st->name : "N/A",
+                         type_str[st->type],
+                         (unsigned long)st->acquire,
+                         (unsigned long)st->contended,
+                         (unsigned long)st->timeout,
+                         wait_avg,
+                         (unsigned long)(st->wait_max / tpus),
+                         st->type == OSAL_LOCKSTAT_MUTEX ? hold_avg : 0UL,
+                         st->type == OSAL_LOCKSTAT_MUTEX ? (unsigned long)(st->hold_max / tpus) : 0UL);
+        }
+        shell_printf("Use 'ps lock reset' to clear statistics.\r\n");
+#else
+        shell_printf("Lock statistics disabled, rebuild with OSAL_LOCK_STATS=ON.\r\n");
+#endif
+        shell_printf("\r\n");
+        return;
+    }
+    else if (strcmp(argv[1], "periodic") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            for (osal_periodic_t *task = osal_periodic_next(NULL); task != NULL; task = osal_periodic_next(task)) {
+                osal_periodic_reset_stats(task);
+            }
+            shell_printf("Periodic task statistics cleared.\r\n\r\n");
+            return;
+        }
+
+        // 显示周期任务统计，时间单位为us
+        shell_printf("Periodic Task Information (time in us):\r\n");
+        shell_printf("%-20s %-8s %-8s %-10s %-6s %-6s %-8s %-8s %-8s %-8s\r\n",
+                     "Name", "Period", "Deadline", "Jobs", "Miss", "Skip",
+                     "ExecMin", "ExecAvg", "ExecMax", "LateMax");
+        shell_printf("------------------------------------------------------------------------------------------------\r\n");
+
+        osal_periodic_t *task = osal_periodic_next(NULL);
+        if (task == NULL) {
+            shell_printf("No periodic tasks created.\r\n");
+        }
+        for (; task != NULL; task = osal_periodic_next(task)) {
+            unsigned long exec_avg = task->jobs ? (unsigned long)(task->exec_total_us / task->jobs) : 0;
+            shell_printf("%-20s %-8lu %-8lu %-10lu %-6lu %-6lu %-8lu %-8lu %-8lu %-8lu\r\n",
+                         task->name ? task->name : "N/A",
+                         (unsigned long)task->period_us,
+                         (unsigned long)task->deadline_us,
+                         (unsigned long)task->jobs,
+                         (unsigned long)task->deadline_miss,
+                         (unsigned long)task->skipped,
+                         task->jobs ? (unsigned long)task->exec_min_us : 0UL,
+                         exec_avg,
+                         (unsigned long)task->exec_max_us,
+                         (unsigned long)task->late_max_us);
+        }
+        shell_printf("Use 'ps periodic reset' to clear statistics.\r\n");
+        shell_printf("\r\n");
+        return;
+    }
+    else if (strcmp(argv[1], "critical") == 0) {
+#if OSAL_CRITICAL_STATS_ENABLE
+        osal_critical_stats_t stats;
+        uint32_t tpus = osal_cycle_per_us();
+
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            osal_critical_stats_reset();
+            shell_printf("Critical section statistics cleared.\r\n\r\n");
+            return;
+        }
+
+        osal_critical_stats_get(&stats);
+        shell_printf("Critical Section Information:\r\n");
+#if OSAL_CRITICAL_BASEPRI_ENABLE
+        shell_printf("Mask mode    : BASEPRI, priority >= %d masked\r\n", OSAL_CRITICAL_BASEPRI_PRIORITY);
+#else
+        shell_printf("Mask mode    : PRIMASK, all interrupts masked\r\n");
+#endif
+        shell_printf("Count        : %lu\r\n", (unsigned long)stats.count);
+        shell_printf("Masked avg   : %lu cycles\r\n",
+                     stats.count ? (unsigned long)(stats.total_cycles / stats.count) : 0UL);
+        shell_printf("Masked max   : %lu cycles (%lu us)\r\n",
+                     (unsigned long)stats.max_cycles, (unsigned long)(stats.max_cycles / tpus));
+        shell_printf("Max caller   : %p\r\n", stats.max_caller);
+        shell_printf("ISR violation: %lu\r\n", (unsigned long)stats.isr_violation);
+        shell_printf("Use 'ps critical reset' to clear statistics.\r\n");
+#else
+        shell_printf("Critical section statistics disabled, rebuild with OSAL_CRITICAL_STATS=ON.\r\n");
+#endif
+        shell_printf("\r\n");
+        return;
+    }
+    else if (strcmp(argv[1], "defer") == 0) {
+        osal_defer_stats_t stats;
+        uint32_t tpus = osal_cycle_per_us();
+
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            osal_defer_stats_reset();
+            shell_printf("Defer statistics cleared.\r\n\r\n");
+            return;
+        }
+
+        osal_defer_stats_get(&stats);
+        shell_printf("Deferred Work Information:\r\n");
+        shell_printf("Executed     : %lu\r\n", (unsigned long)stats.executed);
+        shell_printf("Dropped      : %lu\r\n", (unsigned long)stats.dropped);
+        shell_printf("Batches      : %lu (max %lu items)\r\n",
+                     (unsigned long)stats.batches, (unsigned long)stats.batch_max);
+        shell_printf("Latency avg  : %lu us\r\n",
+                     stats.executed ? (unsigned long)(stats.latency_total / stats.executed / tpus) : 0UL);
+        shell_printf("Latency max  : %lu us\r\n", (unsigned long)(stats.latency_max / tpus));
+        shell_printf("Exec max     : %lu cycles (fn %p)\r\n", (unsigned long)stats.exec_max, (void *)stats.exec_max_fn);
+        shell_printf("Use 'ps defer reset' to clear statistics.\r\n");
+        shell_printf("\r\n");
+        return;
+    }
+    else if (strcmp(argv[1], "coro") == 0) {
+        static const char *const state_str[] = {"READY", "DELAYED", "WAITING", "EXITED"};
+        uint32_t tpus = osal_cycle_per_us();
+        uint32_t count = 0;
+
+        shell_printf("Coroutine Information:\r\n");
+        shell_printf("%-20s %-8s %-10s %-10s %-10s\r\n", "Name", "State", "Runs", "RunMax(us)", "WakeTick");
+        shell_printf("------------------------------------------------------------\r\n");
+        for (osal_coro_t *co = osal_coro_next(NULL); co != NULL; co = osal_coro_next(co)) {
+            shell_printf("%-20s %-8s %-10lu %-10lu %-10lu\r\n",
+                         co->name ? co->name : "N/A",
+                         co->state <= OSAL_CORO_EXITED ? state_str[co->state] : "UNKNOWN",
+                         (unsigned long)co->runs,
+                         (unsigned long)(co->run_max / tpus),
+                         (unsigned long)co->wake_tick);
+            count++;
+        }
+        if (count == 0) {
+            shell_printf("No coroutines started.\r\n");
+        }
+        shell_printf("Total: %lu coroutines, %lu bytes each\r\n", (unsigned long)count, (unsigned long)sizeof(osal_coro_t));
+        shell_printf("\r\n");
+        return;
+    }
+    else if (strcmp(argv[1], "heap") == 0) {
+        osal_heap_stats_t stats;
+        uint32_t tpus = osal_cycle_per_us();
+        uint32_t free_bytes;
+
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            osal_heap_stats_reset();
+            shell_printf("Heap statistics cleared.\r\n\r\n");
+            return;
+        }
+
+        osal_heap_stats_get(&stats);
+        free_bytes = stats.total - stats.used;
+        shell_printf("Heap Information (TLSF):\r\n");
+        shell_printf("Total        : %lu bytes\r\n", (unsigned long)stats.total);
+        shell_printf("Used         : %lu bytes (peak %lu)\r\n", (unsigned long)stats.used, (unsigned long)stats.peak);
+        shell_printf("Free         : %lu bytes in %lu blocks, largest %lu\r\n",
+                     (unsigned long)free_bytes, (unsigned long)stats.free_blocks, (unsigned long)stats.largest_free);
+        shell_printf("Fragmentation: %lu%%\r\n",
+                     free_bytes ? (unsigned long)(100U - (uint32_t)((uint64_t)stats.largest_free * 100U / free_bytes)) : 0UL);
+        shell_printf("Alloc/Free   : %lu / %lu (failed %lu)\r\n",
+                     (unsigned long)stats.alloc_count, (unsigned long)stats.free_count, (unsigned long)stats.fail_count);
+        shell_printf("Alloc max    : %lu cycles (%lu us)\r\n",
+                     (unsigned long)stats.alloc_cycles_max, (unsigned long)(stats.alloc_cycles_max / tpus));
+        shell_printf("Free max     : %lu cycles (%lu us)\r\n",
+                     (unsigned long)stats.free_cycles_max, (unsigned long)(stats.free_cycles_max / tpus));
+        shell_printf("Use 'ps heap reset' to clear statistics.\r\n");
+        shell_printf("\r\n");
+        return;
+    }
+    else if (strcmp(argv[1], "utimer") == 0) {
+        osal_utimer_stats_t stats;
+
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            osal_utimer_stats_reset();
+            shell_printf("Microsecond timer statistics cleared.\r\n\r\n");
+            return;
+        }
+
+        osal_utimer_stats_get(&stats);
+        shell_printf("Microsecond Timer Information:\r\n");
+        shell_printf("Sleeps       : %lu (spin %lu, tick fallback %lu)\r\n",
+                     (unsigned long)stats.sleeps, (unsigned long)stats.spins, (unsigned long)stats.fallbacks);
+        shell_printf("Timed waits  : %lu (timeout %lu)\r\n", (unsigned long)stats.waits, (unsigned long)stats.timeouts);
+        shell_printf("Compare IRQs : %lu\r\n", (unsigned long)stats.irqs);
+        shell_printf("Wake late    : avg %lu us, max %lu us\r\n",
+                     stats.sleeps ? (unsigned long)(stats.late_total / stats.sleeps) : 0UL, (unsigned long)stats.late_max);
+        shell_printf("Use 'ps utimer reset' to clear statistics.\r\n");
+        shell_printf("\r\n");
+        return;
+    }
     else {
         shell_printf("Unknown object type: %s\r\n", argv[1]);
-        shell_printf("Supported types: thread, timer, mutex, sem, event, queue, bytepool, blockpool\r\n");
+        shell_printf("Supported types: thread, timer, mutex, sem, event, queue, bytepool, blockpool, lock, periodic, critical, defer, coro, heap, utimer\r\n");
         shell_printf("\r\n");
         return;
     }